@@ -0,0 +1,79 @@
+/**
+ * @file parse_benchmark.c
+ * @brief On-target benchmark of ld2450 frame parsing per derived-field mode
+ * 
+ * Drop this file into the main component of an ESP-IDF project that depends on
+ * the ld2450 driver and flash it. It parses a fixed three-target frame repeatedly
+ * with each ld2450_derived_mode_t and prints the average CPU cycles per frame.
+ * No radar or UART is required.
+ * 
+ * @author NieRVoid
+ * @date 2025-03-12
+ * @license MIT
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include "esp_cpu.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "ld2450.h"
+
+static const char *TAG = "LD2450_BENCH";
+
+#define BENCH_ITERATIONS 10000
+
+/** @brief Three valid targets: (-782, 1713), (1200, 3000), (-50, 450) mm */
+static const uint8_t s_frame[30] = {
+    0xAA, 0xFF, 0x03, 0x00,
+    0x0E, 0x03, 0xB1, 0x86, 0x10, 0x00, 0x68, 0x01,
+    0xB0, 0x84, 0xB8, 0x8B, 0x00, 0x00, 0x68, 0x01,
+    0x32, 0x00, 0xC2, 0x81, 0x05, 0x80, 0x68, 0x01,
+    0x55, 0xCC,
+};
+
+static const struct {
+    ld2450_derived_mode_t mode;
+    const char *name;
+} s_modes[] = {
+    { LD2450_DERIVED_FLOAT, "float" },
+    { LD2450_DERIVED_NONE,  "none" },
+    { LD2450_DERIVED_LAZY,  "lazy" },
+    { LD2450_DERIVED_FIXED, "fixed" },
+};
+
+void app_main(void)
+{
+    ld2450_frame_t frame;
+    volatile float sink = 0.0f;
+    
+    for (size_t m = 0; m < sizeof(s_modes) / sizeof(s_modes[0]); m++) {
+        uint32_t start = esp_cpu_get_cycle_count();
+        
+        for (int i = 0; i < BENCH_ITERATIONS; i++) {
+            ld2450_process_frame_with_mode(s_frame, sizeof(s_frame), s_modes[m].mode, &frame);
+            sink += frame.targets[0].distance;
+        }
+        
+        uint32_t cycles = esp_cpu_get_cycle_count() - start;
+        ESP_LOGI(TAG, "%-5s: %" PRIu32 " cycles/frame", s_modes[m].name, cycles / BENCH_ITERATIONS);
+        
+        // Let the idle task run between modes
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    
+    // Cost of computing on demand for all three targets, as a lazy consumer would
+    ld2450_process_frame_with_mode(s_frame, sizeof(s_frame), LD2450_DERIVED_LAZY, &frame);
+    uint32_t start = esp_cpu_get_cycle_count();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        for (int t = 0; t < 3; t++) {
+            sink += ld2450_target_get_distance(&frame.targets[t]);
+            sink += ld2450_target_get_angle(&frame.targets[t]);
+        }
+    }
+    uint32_t cycles = esp_cpu_get_cycle_count() - start;
+    ESP_LOGI(TAG, "lazy accessors (3 targets): %" PRIu32 " cycles/frame", cycles / BENCH_ITERATIONS);
+    
+    (void)sink;
+}
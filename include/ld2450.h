@@ -19,152 +19,1478 @@
 #include <stdbool.h>
 #include "esp_err.h"
 #include "driver/uart.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_event.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * @brief Opaque driver instance handle
+ *
+ * Each handle owns its UART, buffers, mutex and (optionally) processing task, so
+ * several radars can run side by side. Functions taking a handle accept NULL to
+ * address the default instance created by ld2450_init().
+ */
+typedef struct ld2450_state *ld2450_handle_t;
+
 /**
  * @brief Target tracking mode options
  */
-typedef enum {
-    LD2450_MODE_SINGLE_TARGET = 0x0001, /*!< Track a single target */
-    LD2450_MODE_MULTI_TARGET = 0x0002   /*!< Track multiple targets (default) */
-} ld2450_tracking_mode_t;
+typedef enum {
+    LD2450_MODE_SINGLE_TARGET = 0x0001, /*!< Track a single target */
+    LD2450_MODE_MULTI_TARGET = 0x0002   /*!< Track multiple targets (default) */
+} ld2450_tracking_mode_t;
+
+/**
+ * @brief Serial port baud rate options
+ */
+typedef enum {
+    LD2450_BAUD_9600   = 0x0001, /*!< 9600 baud */
+    LD2450_BAUD_19200  = 0x0002, /*!< 19200 baud */
+    LD2450_BAUD_38400  = 0x0003, /*!< 38400 baud */
+    LD2450_BAUD_57600  = 0x0004, /*!< 57600 baud */
+    LD2450_BAUD_115200 = 0x0005, /*!< 115200 baud */
+    LD2450_BAUD_230400 = 0x0006, /*!< 230400 baud */
+    LD2450_BAUD_256000 = 0x0007, /*!< 256000 baud (default) */
+    LD2450_BAUD_460800 = 0x0008  /*!< 460800 baud */
+} ld2450_baud_rate_t;
+
+/**
+ * @brief Region filtering type options
+ */
+typedef enum {
+    LD2450_FILTER_DISABLED = 0x0000,   /*!< Disable region filtering */
+    LD2450_FILTER_INCLUDE_ONLY = 0x0001, /*!< Only detect targets within specified regions */
+    LD2450_FILTER_EXCLUDE = 0x0002      /*!< Do not detect targets within specified regions */
+} ld2450_filter_type_t;
+
+/**
+ * @brief How the parser fills a target's derived distance and angle fields
+ */
+typedef enum {
+    LD2450_DERIVED_FLOAT = 0,  /*!< Compute with single-precision float math while parsing (default) */
+    LD2450_DERIVED_NONE,       /*!< Skip derived fields; distance and angle are left at zero */
+    LD2450_DERIVED_LAZY,       /*!< Skip while parsing; ld2450_target_get_distance()/_angle() compute on demand */
+    LD2450_DERIVED_FIXED,      /*!< Integer square root (error < 1 mm) and table atan2 (error < 0.01 degrees) */
+} ld2450_derived_mode_t;
+
+/**
+ * @brief Firmware version information
+ */
+typedef struct {
+    uint16_t main_version;     /*!< Main version number */
+    uint32_t sub_version;      /*!< Sub-version number */
+    char version_string[32];   /*!< Formatted version string (e.g., "V1.02.22062416") */
+} ld2450_firmware_version_t;
+
+/**
+ * @brief Region definition for filtering (rectangular area)
+ */
+typedef struct {
+    int16_t x1;   /*!< X coordinate of first corner (mm) */
+    int16_t y1;   /*!< Y coordinate of first corner (mm) */
+    int16_t x2;   /*!< X coordinate of diagonal corner (mm) */
+    int16_t y2;   /*!< Y coordinate of diagonal corner (mm) */
+} ld2450_region_t;
+
+/**
+ * @brief Target information structure
+ */
+typedef struct {
+    int16_t x;                /*!< X coordinate (mm) */
+    int16_t y;                /*!< Y coordinate (mm) */
+    int16_t speed;            /*!< Speed (cm/s) */
+    uint16_t resolution;      /*!< Distance resolution (mm) */
+    float distance;           /*!< Calculated distance (mm) */
+    float angle;              /*!< Calculated angle in degrees */
+    bool valid;               /*!< Target validity flag */
+    bool derived_valid;       /*!< distance/angle have been filled in by the parser */
+} ld2450_target_t;
+
+/**
+ * @brief Data frame structure containing target information
+ */
+typedef struct {
+    ld2450_target_t targets[3];  /*!< Data for up to 3 targets */
+    uint8_t count;               /*!< Number of valid targets (0-3) */
+    uint32_t sequence;           /*!< Per-instance frame sequence number, increments by one per delivered frame */
+    int64_t timestamp_us;        /*!< esp_timer time at which the frame header arrived on the wire (us) */
+} ld2450_frame_t;
+
+/**
+ * @brief Compact target representation (8 bytes)
+ */
+typedef struct {
+    int16_t x;                /*!< X coordinate (mm) */
+    int16_t y;                /*!< Y coordinate (mm) */
+    int16_t speed;            /*!< Speed (cm/s) */
+    uint16_t resolution;      /*!< Distance resolution (mm) */
+} ld2450_compact_target_t;
+
+/**
+ * @brief Compact frame for buffering and transmission (36 bytes vs. 80 for ld2450_frame_t)
+ * 
+ * Derived fields are dropped and validity is packed into a bitmask. The timestamp is
+ * stored as the delta to the previous frame of the same stream, so a stream of
+ * compact frames is decoded in order starting from a known base time.
+ */
+typedef struct {
+    ld2450_compact_target_t targets[3]; /*!< Target slots; slot i is valid if bit i of valid_mask is set */
+    uint32_t sequence;                  /*!< Frame sequence number */
+    uint32_t timestamp_delta_us;        /*!< Time since the previous frame of the stream (us, saturating) */
+    uint8_t valid_mask;                 /*!< Bit i set if targets[i] is valid */
+} ld2450_compact_frame_t;
+
+/**
+ * @brief Frame synchronization counters
+ */
+typedef struct {
+    uint32_t frames_ok;          /*!< Frames that passed header and footer checks */
+    uint32_t footer_errors;      /*!< Candidate frames rejected by the footer check */
+    uint32_t frames_recovered;   /*!< Valid frames found by rescanning the bytes of a rejected frame */
+    uint32_t bytes_skipped;      /*!< Bytes discarded while hunting for a frame header */
+} ld2450_sync_stats_t;
+
+/** @brief Number of power-of-two bins in each ld2450_latency_stats_t histogram */
+#define LD2450_STATS_HISTOGRAM_BINS 8
+
+/**
+ * @brief Timing distribution in microseconds
+ * 
+ * Histogram bin 0 counts samples below 128 us, bin i counts samples in
+ * [64 << i, 128 << i) and the last bin also collects everything above.
+ */
+typedef struct {
+    uint32_t samples;            /*!< Number of samples recorded */
+    uint32_t min_us;             /*!< Smallest sample */
+    uint32_t avg_us;             /*!< Mean of all samples */
+    uint32_t max_us;             /*!< Largest sample */
+    uint32_t histogram[LD2450_STATS_HISTOGRAM_BINS]; /*!< Sample counts per bin */
+} ld2450_latency_stats_t;
+
+/**
+ * @brief Driver statistics
+ */
+typedef struct {
+    ld2450_sync_stats_t sync;    /*!< Frame synchronization counters */
+    uint32_t frames_delivered;   /*!< Frames handed to the callback and frame ring */
+    uint32_t frames_suppressed;  /*!< Valid frames withheld by the delivery policy */
+    uint32_t batches_delivered;  /*!< Batches handed to the batch callback */
+    uint32_t frame_ring_overruns; /*!< Frames dropped because the frame ring was full */
+    uint32_t uart_fifo_overflows; /*!< UART hardware FIFO overflows (input flushed) */
+    uint32_t uart_buffer_full;   /*!< UART driver ring buffer full events (input flushed) */
+    uint32_t uart_queue_peak;    /*!< Highest UART event queue depth seen by the processing task */
+    uint32_t subscriber_drops;   /*!< Frames a queue subscriber missed (queue or frame pool full) */
+    uint32_t events_dropped;     /*!< Events not posted because the event loop queue was full */
+    uint32_t capture_drops;      /*!< UART chunks not captured because the capture ring was full */
+    int64_t elapsed_us;          /*!< Time covered by the counters (since creation or last reset) */
+    ld2450_latency_stats_t latency;       /*!< Frame header arrival to callback invocation */
+    ld2450_latency_stats_t callback_time; /*!< Time spent in the target and batch callbacks */
+} ld2450_stats_t;
+
+/**
+ * @brief Frame delivery policy
+ * 
+ * Evaluated by the driver before a frame is pushed to the frame ring or handed to the
+ * callback. Change filters compare against the last delivered frame; suppressed frames
+ * still consume a sequence number. A zeroed policy delivers every frame.
+ */
+typedef struct {
+    uint8_t decimation;         /*!< Consider only every Nth received frame (0 or 1 = all) */
+    uint16_t min_interval_ms;   /*!< Minimum time between delivered frames (0 = no limit) */
+    bool count_change_only;     /*!< Deliver only when the set of valid targets changes */
+    uint16_t deadband_xy_mm;    /*!< Deliver only when a target moves more than this in x or y (0 = off) */
+    uint16_t deadband_speed;    /*!< Deliver only when a target's speed changes more than this, cm/s (0 = off) */
+    uint16_t heartbeat_ms;      /*!< Deliver regardless of change filters after this long without delivery (0 = never) */
+} ld2450_delivery_policy_t;
+
+/** @brief Largest number of tracks maintained by the tracker */
+#define LD2450_TRACK_MAX 6
+
+/** @brief ld2450_track_t::slot of a track without a measurement in the current frame */
+#define LD2450_TRACK_NO_SLOT 0xFF
+
+/**
+ * @brief Target tracker configuration
+ * 
+ * Zero fields select the defaults given in brackets.
+ */
+typedef struct {
+    bool enabled;             /*!< Run the tracker on every parsed frame */
+    uint16_t gate_mm;         /*!< Largest distance between a prediction and its measurement [600] */
+    uint8_t alpha;            /*!< Alpha-beta position gain in 1/256 [128] */
+    uint8_t beta;             /*!< Alpha-beta velocity gain in 1/256 [32] */
+    uint8_t confirm_hits;     /*!< Measurements before a track is reported [2] */
+    uint8_t max_missed;       /*!< Frames a confirmed track coasts without a measurement [5] */
+} ld2450_tracker_config_t;
+
+/**
+ * @brief Tracked target with a stable identity
+ */
+typedef struct {
+    uint16_t id;              /*!< Track ID, unique over the instance's lifetime (never 0) */
+    uint8_t slot;             /*!< Target slot measured this frame, LD2450_TRACK_NO_SLOT while coasting */
+    uint8_t missed;           /*!< Consecutive frames without a measurement */
+    int16_t x;                /*!< Smoothed X coordinate (mm) */
+    int16_t y;                /*!< Smoothed Y coordinate (mm) */
+    int16_t vx;               /*!< Estimated X velocity (mm/s) */
+    int16_t vy;               /*!< Estimated Y velocity (mm/s) */
+    uint16_t hits;            /*!< Frames with a measurement (saturating) */
+    int64_t first_seen_us;    /*!< Timestamp of the frame that created the track */
+} ld2450_track_t;
+
+/**
+ * @brief Confirmed tracks after one frame
+ */
+typedef struct {
+    ld2450_track_t tracks[LD2450_TRACK_MAX]; /*!< Confirmed tracks, count entries valid */
+    uint8_t count;            /*!< Number of confirmed tracks */
+    uint32_t sequence;        /*!< Sequence number of the frame */
+    int64_t timestamp_us;     /*!< Timestamp of the frame; lifetime = timestamp_us - first_seen_us */
+} ld2450_track_set_t;
+
+/**
+ * @brief Track callback function type
+ * 
+ * Called from the processing task after the target callback for every delivered frame.
+ * 
+ * @param tracks Confirmed tracks (valid only during the call)
+ * @param user_ctx User context pointer passed during registration
+ */
+typedef void (*ld2450_track_cb_t)(const ld2450_track_set_t *tracks, void *user_ctx);
+
+/** @brief Largest number of radars merged by the fusion stage */
+#define LD2450_FUSION_MAX_RADARS 4
+
+/** @brief Largest number of targets in a fused frame */
+#define LD2450_FUSION_MAX_TARGETS (3 * LD2450_FUSION_MAX_RADARS)
+
+/**
+ * @brief Mounting pose of a radar in room coordinates
+ * 
+ * The radar's own frame has x to the side and y along its boresight. yaw_cdeg
+ * rotates that frame counter-clockwise onto the room axes, so a radar at yaw 0
+ * looks along the room's +y axis and one at 9000 along its -x axis.
+ */
+typedef struct {
+    int16_t x;                /*!< Radar position, room X (mm) */
+    int16_t y;                /*!< Radar position, room Y (mm) */
+    int16_t yaw_cdeg;         /*!< Rotation of the radar frame (0.01 degrees, counter-clockwise) */
+} ld2450_pose_t;
+
+/**
+ * @brief Fusion stage configuration
+ * 
+ * Zero fields select the defaults given in brackets.
+ */
+typedef struct {
+    uint16_t gate_mm;         /*!< Largest distance between detections of different radars merged into one target [500] */
+    uint16_t window_ms;       /*!< Frames older than this relative to the newest are not merged [150] */
+} ld2450_fusion_config_t;
+
+/**
+ * @brief Target in room coordinates
+ */
+typedef struct {
+    int16_t x;                /*!< Room X (mm), averaged over the radars that see the target */
+    int16_t y;                /*!< Room Y (mm), averaged over the radars that see the target */
+    int16_t speed;            /*!< Radial speed measured by the nearest of those radars (cm/s) */
+    uint8_t radars;           /*!< Bit i set if the radar added as fusion source i sees the target */
+} ld2450_fusion_target_t;
+
+/**
+ * @brief Targets of all fusion sources merged into room coordinates
+ */
+typedef struct {
+    ld2450_fusion_target_t targets[LD2450_FUSION_MAX_TARGETS]; /*!< Fused targets, count entries valid */
+    uint8_t count;            /*!< Number of fused targets */
+    uint8_t radars;           /*!< Bit i set if a frame of source i within the window was merged */
+    uint32_t sequence;        /*!< Fused frame sequence number */
+    int64_t timestamp_us;     /*!< Timestamp of the newest merged frame */
+} ld2450_fusion_frame_t;
+
+/**
+ * @brief Fused frame callback function type
+ * 
+ * Called from the processing task of the radar whose frame completed the fused
+ * frame, after the fusion stage has been unlocked. With sources on different
+ * processing tasks, two calls may overlap.
+ * 
+ * @param frame Fused frame (valid only during the call)
+ * @param user_ctx User context pointer passed during registration
+ */
+typedef void (*ld2450_fusion_cb_t)(const ld2450_fusion_frame_t *frame, void *user_ctx);
+
+/** @brief Number of software zones per instance */
+#define LD2450_ZONE_MAX 16
+
+/** @brief Largest number of vertices of a software zone */
+#define LD2450_ZONE_MAX_VERTICES 8
+
+/** @brief Largest absolute vertex coordinate of a software zone (mm) */
+#define LD2450_ZONE_COORD_MAX 16000
+
+/**
+ * @brief Point in the radar coordinate system
+ */
+typedef struct {
+    int16_t x;                /*!< X coordinate (mm) */
+    int16_t y;                /*!< Y coordinate (mm) */
+} ld2450_point_t;
+
+/**
+ * @brief Software zone: a simple polygon evaluated by the driver
+ */
+typedef struct {
+    uint8_t vertex_count;     /*!< Number of vertices (3 to LD2450_ZONE_MAX_VERTICES) */
+    ld2450_point_t vertices[LD2450_ZONE_MAX_VERTICES]; /*!< Vertices in order around the polygon */
+} ld2450_zone_t;
+
+/**
+ * @brief Zone enter/exit event
+ */
+typedef struct {
+    uint8_t zone;             /*!< Zone index */
+    uint8_t target;           /*!< Target slot (0-2) that entered or left */
+    bool entered;             /*!< true on enter, false on exit */
+    uint8_t occupancy;        /*!< Targets in the zone after this event */
+    uint32_t sequence;        /*!< Sequence number of the frame that raised the event */
+    int64_t timestamp_us;     /*!< Timestamp of the frame that raised the event */
+} ld2450_zone_event_t;
+
+/**
+ * @brief Zone event callback function type
+ * 
+ * Called from the processing task, once per target entering or leaving a zone.
+ * 
+ * @param event Event (valid only during the call)
+ * @param user_ctx User context pointer passed during registration
+ */
+typedef void (*ld2450_zone_cb_t)(const ld2450_zone_event_t *event, void *user_ctx);
+
+/** @brief Half-width of the occupancy heatmap grid: it spans X from -6000 to 6000 mm */
+#define LD2450_HEATMAP_HALF_WIDTH_MM 6000
+
+/** @brief Depth of the occupancy heatmap grid: it spans Y from 0 to 6000 mm */
+#define LD2450_HEATMAP_DEPTH_MM 6000
+
+/**
+ * @brief Occupancy heatmap configuration
+ */
+typedef struct {
+    bool enabled;               /*!< Accumulate target positions and zone dwell time */
+    uint16_t cell_mm;           /*!< Grid cell edge (0 = 250, at least 100) */
+} ld2450_heatmap_config_t;
+
+/**
+ * @brief Occupancy heatmap summary returned by ld2450_heatmap_snapshot()
+ * 
+ * The grid has cols x rows cells, stored row by row starting at the cell at
+ * x = -LD2450_HEATMAP_HALF_WIDTH_MM, y = 0. Each cell counts the detections that
+ * fell into it, saturating at UINT16_MAX, so a cell's dwell time is roughly its
+ * count times the frame interval.
+ */
+typedef struct {
+    uint16_t cell_mm;           /*!< Grid cell edge (mm) */
+    uint8_t cols;               /*!< Cells along X */
+    uint8_t rows;               /*!< Cells along Y */
+    uint32_t frames;            /*!< Frames accumulated */
+    uint32_t detections;        /*!< Valid targets counted into cells */
+    uint32_t outside;           /*!< Valid targets outside the +-LD2450_HEATMAP_HALF_WIDTH_MM x LD2450_HEATMAP_DEPTH_MM area */
+    uint32_t elapsed_ms;        /*!< Time covered (since creation or the last reset) */
+    uint32_t zone_occupied_ms[LD2450_ZONE_MAX]; /*!< Time with at least one target in each zone */
+    uint32_t zone_target_ms[LD2450_ZONE_MAX];   /*!< Target time per zone, each target counted separately */
+} ld2450_heatmap_info_t;
+
+/** @brief Largest batch ld2450_batch_config_t::max_frames may ask for */
+#define LD2450_BATCH_MAX_FRAMES 32
+
+/**
+ * @brief Batched frame delivery configuration
+ * 
+ * Delivered frames are copied into an array of max_frames frames and handed to
+ * the batch callback when it is full, or when its oldest frame has waited
+ * max_latency_ms, whichever comes first.
+ */
+typedef struct {
+    uint8_t max_frames;         /*!< Frames per batch (0 = batching disabled, at most LD2450_BATCH_MAX_FRAMES) */
+    uint16_t max_latency_ms;    /*!< Longest a frame waits in a partial batch (0 = 500) */
+} ld2450_batch_config_t;
+
+/** @brief Event base of the events posted by the driver */
+ESP_EVENT_DECLARE_BASE(LD2450_EVENT);
+
+/**
+ * @brief Events posted under LD2450_EVENT
+ */
+typedef enum {
+    LD2450_EVENT_FRAME,            /*!< A frame was delivered; data is ld2450_event_frame_t */
+    LD2450_EVENT_PRESENCE_CHANGED, /*!< Targets appeared or all left; data is ld2450_event_presence_t */
+    LD2450_EVENT_SYNC_LOST,        /*!< The data stream lost frame sync; data is ld2450_event_sync_lost_t */
+    LD2450_EVENT_CONFIG_DONE,      /*!< The module left configuration mode; data is ld2450_event_config_done_t */
+    LD2450_EVENT_HEALTH,           /*!< The stream watchdog changed state; data is ld2450_event_health_t */
+} ld2450_event_id_t;
+
+/**
+ * @brief Event posting configuration
+ */
+typedef struct {
+    bool enabled;               /*!< Post LD2450_EVENT events */
+    esp_event_loop_handle_t loop; /*!< Loop to post to (NULL = create a dedicated loop) */
+    uint8_t task_priority;      /*!< Priority of the dedicated loop's task (0 = 1) */
+    uint16_t task_stack_size;   /*!< Stack of the dedicated loop's task (0 = 3072 bytes) */
+    uint8_t queue_size;         /*!< Event queue length of the dedicated loop (0 = 16) */
+} ld2450_event_config_t;
+
+/**
+ * @brief Data of LD2450_EVENT_FRAME
+ * 
+ * The frame is not copied into the event: it points into a driver-owned ring of
+ * recent frames that is overwritten after LD2450_EVENT_FRAME_SLOTS newer frames.
+ * Handlers that may lag that far behind should copy what they need and then check
+ * ld2450_event_frame_valid().
+ */
+typedef struct {
+    ld2450_handle_t handle;     /*!< Instance that delivered the frame */
+    const ld2450_frame_t *frame; /*!< Delivered frame */
+    uint32_t sequence;          /*!< Sequence number of the frame */
+} ld2450_event_frame_t;
+
+/**
+ * @brief Data of LD2450_EVENT_PRESENCE_CHANGED
+ */
+typedef struct {
+    ld2450_handle_t handle;     /*!< Instance */
+    bool present;               /*!< At least one target is detected */
+    uint8_t count;              /*!< Number of valid targets */
+    uint32_t sequence;          /*!< Sequence number of the frame that changed presence */
+    int64_t timestamp_us;       /*!< Timestamp of the frame that changed presence */
+} ld2450_event_presence_t;
+
+/**
+ * @brief Cause of LD2450_EVENT_SYNC_LOST
+ */
+typedef enum {
+    LD2450_SYNC_LOST_BAD_FRAME,     /*!< A frame failed its footer check */
+    LD2450_SYNC_LOST_UART_OVERFLOW, /*!< The UART dropped input (FIFO overflow or buffer full) */
+} ld2450_sync_lost_reason_t;
+
+/**
+ * @brief Data of LD2450_EVENT_SYNC_LOST
+ * 
+ * Posted once per loss: a new loss is only reported after a valid frame was received.
+ */
+typedef struct {
+    ld2450_handle_t handle;     /*!< Instance */
+    ld2450_sync_lost_reason_t reason; /*!< Cause */
+    ld2450_sync_stats_t stats;  /*!< Synchronization counters at the time of loss */
+} ld2450_event_sync_lost_t;
+
+/**
+ * @brief Data of LD2450_EVENT_CONFIG_DONE
+ */
+typedef struct {
+    ld2450_handle_t handle;     /*!< Instance */
+    esp_err_t result;           /*!< Result of the end-configuration command */
+} ld2450_event_config_done_t;
+
+/**
+ * @brief Low-power operation
+ * 
+ * The driver holds an ESP_PM_NO_LIGHT_SLEEP lock only while frames stream and
+ * lets the chip light-sleep otherwise, waking on UART RX edges. With
+ * absent_timeout_ms set, a radar that has reported no target for that long is
+ * duty-cycled: its frames are ignored and the lock released except for a short
+ * listen window once per absent_period_ms.
+ */
+typedef struct {
+    bool enabled;               /*!< Enable presence-gated low-power operation */
+    uint16_t idle_timeout_ms;   /*!< Release the PM lock after this long without UART data (0 = 200) */
+    uint8_t wakeup_threshold;   /*!< RX edges that wake the chip from light sleep (0 = 3) */
+    uint32_t absent_timeout_ms; /*!< Start duty-cycling after this long without targets (0 = never) */
+    uint32_t absent_period_ms;  /*!< Duty cycle period, one listen window per period (0 = 1000) */
+} ld2450_power_config_t;
+
+/**
+ * @brief Low-power operating state
+ */
+typedef enum {
+    LD2450_POWER_DISABLED = 0,  /*!< Low-power operation is not enabled */
+    LD2450_POWER_STREAMING,     /*!< Frames are streaming, PM lock held */
+    LD2450_POWER_IDLE,          /*!< UART silent, PM lock released until RX activity */
+    LD2450_POWER_DUTY_SLEEP,    /*!< No targets: frames ignored, PM lock released */
+    LD2450_POWER_DUTY_LISTEN,   /*!< No targets: listening for a frame, PM lock held */
+} ld2450_power_state_t;
+
+/**
+ * @brief Energy accounting reported by ld2450_get_power_stats()
+ * 
+ * lock_released_us is the time the driver allowed light sleep, not the time the
+ * chip slept: that also depends on the other PM locks in the application, and
+ * is reported by esp_pm_dump_locks().
+ */
+typedef struct {
+    ld2450_power_state_t state; /*!< Current state */
+    uint64_t awake_us;          /*!< Time with the PM lock held */
+    uint64_t lock_released_us;  /*!< Time with the PM lock released */
+    uint64_t duty_sleep_us;     /*!< Part of lock_released_us spent duty-cycled with the radar ignored */
+    uint32_t wakeups;           /*!< Times the PM lock was taken again after a release */
+    uint32_t duty_listens;      /*!< Listen windows opened while duty-cycling */
+} ld2450_power_stats_t;
+
+/**
+ * @brief Stream health watchdog
+ * 
+ * The driver learns the radar's frame interval and treats a gap of ten intervals
+ * (at least 500 ms) as a stall. Recovery then escalates one step per timeout,
+ * each run by the processing task without blocking any caller: resynchronize the
+ * scanner, re-send end-configuration, restart the module, and probe the other
+ * baud rates. If none brings frames back, the sequence is retried every retry_ms.
+ */
+typedef struct {
+    bool enabled;               /*!< Enable the watchdog (requires auto_processing) */
+    uint32_t timeout_ms;        /*!< Gap without frames that counts as a stall, and time given to each step (0 = 10 frame intervals, at least 500) */
+    uint32_t retry_ms;          /*!< Pause before starting over once every step failed (0 = 10000) */
+    bool skip_baud_probe;       /*!< Stop escalating at the module restart */
+} ld2450_health_config_t;
+
+/**
+ * @brief Stream health state, named after the recovery step in progress
+ */
+typedef enum {
+    LD2450_HEALTH_DISABLED = 0, /*!< The watchdog is not enabled */
+    LD2450_HEALTH_OK,           /*!< Frames arrive at the expected rate */
+    LD2450_HEALTH_RESYNC,       /*!< Stalled: scanner resynchronized, waiting for a frame */
+    LD2450_HEALTH_EXIT_CONFIG,  /*!< Stalled: end-configuration sent in case the module is stuck in it */
+    LD2450_HEALTH_RESTART,      /*!< Stalled: module restarted */
+    LD2450_HEALTH_BAUD_PROBE,   /*!< Stalled: listening at the other baud rates in turn */
+    LD2450_HEALTH_FAILED,       /*!< Every step failed, waiting retry_ms before starting over */
+} ld2450_health_state_t;
+
+/**
+ * @brief Watchdog counters reported by ld2450_get_health_stats()
+ */
+typedef struct {
+    ld2450_health_state_t state; /*!< Current state */
+    ld2450_health_state_t recovered_by; /*!< Step that ended the last stall (LD2450_HEALTH_DISABLED if none yet) */
+    uint32_t stalls;            /*!< Stalls detected */
+    uint32_t recoveries;        /*!< Stalls that ended with a frame */
+    uint32_t resyncs;           /*!< Resynchronizations */
+    uint32_t exit_configs;      /*!< End-configuration commands sent */
+    uint32_t restarts;          /*!< Module restarts */
+    uint32_t baud_probes;       /*!< Baud rates listened at */
+    uint32_t frame_interval_us; /*!< Learned frame interval (0 until known) */
+    uint32_t last_downtime_ms;  /*!< Time from the last frame before the last stall to the frame that ended it */
+    uint64_t downtime_us;       /*!< Total time without frames over all stalls, including one in progress */
+} ld2450_health_stats_t;
+
+/**
+ * @brief Data of LD2450_EVENT_HEALTH
+ */
+typedef struct {
+    ld2450_handle_t handle;     /*!< Instance */
+    ld2450_health_state_t state; /*!< New state */
+    ld2450_health_state_t prev; /*!< Previous state */
+    uint32_t stalled_ms;        /*!< Time since the last frame (0 when the state is LD2450_HEALTH_OK) */
+    uint32_t baud_rate;         /*!< Host UART baud rate in the new state */
+} ld2450_event_health_t;
+
+/**
+ * @brief Events recorded in the binary trace
+ */
+typedef enum {
+    LD2450_TRACE_FRAME = 0,     /*!< Frame parsed: arg8 = target count, arg32 = sequence */
+    LD2450_TRACE_FOOTER_ERROR,  /*!< False header dropped, sync lost: arg32 = footer errors so far */
+    LD2450_TRACE_RESYNC,        /*!< First good frame after sync was lost: arg32 = sequence */
+    LD2450_TRACE_UART_OVERFLOW, /*!< Input dropped: arg8 = 0 FIFO overflow, 1 buffer full, 2 DMA chunk queue full,
+                                     3 bytes read by a command from a callback (arg32 = bytes lost) */
+    LD2450_TRACE_CMD_SENT,      /*!< Command written: arg16 = command word, arg32 = length */
+    LD2450_TRACE_CMD_DONE,      /*!< Command completed: arg16 = command word, arg32 = esp_err_t result */
+    LD2450_TRACE_CMD_TIMEOUT,   /*!< No ACK in time: arg16 = command word */
+    LD2450_TRACE_ACK_INVALID,   /*!< Malformed ACK dropped: arg16 = length */
+    LD2450_TRACE_CALLBACK,      /*!< Callback returned: arg8 = 0 target, 1 batch (arg16 = frames), arg32 = run time (us) */
+    LD2450_TRACE_HEALTH,        /*!< Watchdog state changed: arg8 = ld2450_health_state_t, arg32 = ms since the last frame */
+    LD2450_TRACE_EVENT_MAX,
+} ld2450_trace_event_t;
+
+/**
+ * @brief Binary trace record
+ */
+typedef struct {
+    uint32_t timestamp_us;      /*!< Low 32 bits of the esp_timer time of the event */
+    uint8_t event;              /*!< ld2450_trace_event_t */
+    uint8_t arg8;               /*!< Event-specific */
+    uint16_t arg16;             /*!< Event-specific */
+    uint32_t arg32;             /*!< Event-specific */
+} ld2450_trace_record_t;
+
+/**
+ * @brief Caller-provided memory for the processing task
+ * 
+ * Both members set makes the driver create its private processing task with
+ * xTaskCreateStatic(); the memory must stay valid until the instance is deleted.
+ */
+typedef struct {
+    StaticTask_t *tcb;          /*!< Task control block */
+    StackType_t *stack;         /*!< Task stack of task_stack_size bytes */
+} ld2450_task_memory_t;
+
+/**
+ * @brief Driver configuration structure
+ */
+typedef struct {
+    uart_port_t uart_port;      /*!< UART port number */
+    int uart_rx_pin;            /*!< GPIO pin for UART RX */
+    int uart_tx_pin;            /*!< GPIO pin for UART TX */
+    uint32_t uart_baud_rate;    /*!< UART baud rate */
+    bool uart_auto_baud;        /*!< Probe the module's baud rate at startup if uart_baud_rate gets no answer */
+    bool auto_processing;       /*!< Enable automatic frame processing */
+    int task_priority;          /*!< Priority for auto processing task (if enabled) */
+    bool shared_task;           /*!< Service this instance from the shared processing task instead of a private one */
+    bool task_pinned;           /*!< Pin the processing task to task_core_id (false = no affinity) */
+    uint8_t task_core_id;       /*!< Core of the processing task when task_pinned is set */
+    uint32_t task_stack_size;   /*!< Processing task stack in bytes (0 = 4096) */
+    ld2450_task_memory_t task_memory; /*!< Static memory for the private processing task (zeroed = heap) */
+    uint16_t uart_rx_buffer_size; /*!< UART driver RX ring buffer in bytes, above the hardware FIFO size (0 = 2048) */
+    uint8_t uart_event_queue_size; /*!< UART driver event queue depth (0 = 20, at most 20 with shared_task) */
+    uint8_t frame_ring_depth;   /*!< Number of parsed-frame slots for the pull API (0 = disabled) */
+    bool frame_ring_compact;    /*!< Store ld2450_compact_frame_t in the frame ring instead of ld2450_frame_t */
+    ld2450_derived_mode_t derived_mode; /*!< How distance/angle are computed while parsing */
+    uint8_t uart_rx_timeout;    /*!< UART RX timeout in symbol times before a data event is raised (0 = driver default) */
+    uint8_t uart_rx_full_threshold; /*!< UART RX FIFO full threshold in bytes (0 = driver default) */
+    bool uart_rx_dma;           /*!< Receive through UHCI/GDMA into double buffers (needs LD2450_ENABLE_UHCI and a processing task) */
+    ld2450_delivery_policy_t delivery; /*!< Initial frame delivery policy (zeroed = every frame) */
+    const char *nvs_namespace;  /*!< NVS namespace caching module identity and settings (NULL = no cache) */
+    ld2450_tracker_config_t tracker; /*!< Target tracker (zeroed = disabled) */
+    ld2450_event_config_t events; /*!< esp_event posting (zeroed = disabled) */
+    ld2450_power_config_t power; /*!< Low-power operation (zeroed = disabled) */
+    ld2450_health_config_t health; /*!< Stream health watchdog (zeroed = disabled) */
+    ld2450_heatmap_config_t heatmap; /*!< Occupancy heatmap and zone dwell time (zeroed = disabled) */
+    ld2450_batch_config_t batch; /*!< Batched frame delivery (zeroed = disabled) */
+} ld2450_config_t;
+
+/**
+ * @brief Target data callback function type
+ * 
+ * This function is called when new target data is available
+ * 
+ * @param frame Pointer to the frame containing target data
+ * @param user_ctx User context pointer passed during registration
+ */
+typedef void (*ld2450_target_cb_t)(const ld2450_frame_t *frame, void *user_ctx);
+
+/**
+ * @brief Batch callback function type
+ * 
+ * Called from the processing task with the frames delivered since the previous
+ * batch, oldest first. The array is reused for the next batch once the callback
+ * returns.
+ * 
+ * @param frames Frames of the batch
+ * @param count Number of frames (1 to max_frames)
+ * @param user_ctx User context pointer passed during registration
+ */
+typedef void (*ld2450_batch_cb_t)(const ld2450_frame_t *frames, size_t count, void *user_ctx);
+
+/**
+ * @brief Default configuration for the LD2450 driver
+ */
+#define LD2450_DEFAULT_CONFIG() { \
+    .uart_port = UART_NUM_2, \
+    .uart_rx_pin = 16, \
+    .uart_tx_pin = 17, \
+    .uart_baud_rate = 256000, \
+    .auto_processing = true, \
+    .task_priority = 5, \
+}
+
+/**
+ * @brief Initialize the LD2450 radar driver
+ * 
+ * Creates the default instance used by the handle-less API.
+ * 
+ * @param config Pointer to driver configuration structure
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_init(const ld2450_config_t *config);
+
+/**
+ * @brief Create an additional LD2450 driver instance
+ * 
+ * Instances created with `shared_task` set in their configuration are all
+ * serviced by a single processing task (created with the priority of the first
+ * such instance) instead of one task per radar.
+ * Such instances cannot be created from a callback running on that task.
+ * 
+ * @param config Pointer to driver configuration structure
+ * @param ret_handle Pointer to store the created handle
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_create(const ld2450_config_t *config, ld2450_handle_t *ret_handle);
+
+/**
+ * @brief Delete a driver instance created with ld2450_create() and release its resources
+ * 
+ * Returns once the instance's processing task has exited, so a callback still
+ * running finishes first. An instance cannot be deleted from its own callbacks,
+ * nor a `shared_task` instance from any callback running on the shared task.
+ * 
+ * @param handle Driver handle
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_STATE from a callback of the
+ *         instance or of the shared task, error code otherwise
+ */
+esp_err_t ld2450_delete(ld2450_handle_t handle);
+
+/**
+ * @brief Get the handle of the default instance created by ld2450_init()
+ * 
+ * @return ld2450_handle_t Default handle, NULL if the driver is not initialized
+ */
+ld2450_handle_t ld2450_get_default_handle(void);
+
+/**
+ * @brief Deinitialize the LD2450 radar driver and release resources
+ * 
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_deinit(void);
+
+/**
+ * @brief Register a callback function for target data
+ * 
+ * @param callback Function pointer to call when new target data is available
+ * @param user_ctx User context pointer passed to the callback function
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_register_target_callback(ld2450_target_cb_t callback, void *user_ctx);
+
+/**
+ * @brief Register a callback function for target data on a specific instance
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @see ld2450_register_target_callback
+ */
+esp_err_t ld2450_dev_register_target_callback(ld2450_handle_t handle,
+                                              ld2450_target_cb_t callback, void *user_ctx);
+
+/** @brief Number of recent frames an LD2450_EVENT_FRAME reference stays valid for */
+#define LD2450_EVENT_FRAME_SLOTS 8
+
+/**
+ * @brief Get the event loop an instance posts to
+ * 
+ * Register handlers for LD2450_EVENT on it with esp_event_handler_register_with().
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param loop Pointer to store the loop
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_STATE if events are disabled
+ */
+esp_err_t ld2450_get_event_loop(ld2450_handle_t handle, esp_event_loop_handle_t *loop);
+
+/**
+ * @brief Check that the frame of an LD2450_EVENT_FRAME has not been overwritten
+ * 
+ * @param event Event data
+ * @return true if event->frame still holds the frame the event was posted for
+ */
+bool ld2450_event_frame_valid(const ld2450_event_frame_t *event);
+
+/** @brief Largest number of frame subscribers per instance */
+#define LD2450_SUBSCRIBER_MAX 4
+
+/**
+ * @brief How frames reach a subscriber
+ */
+typedef enum {
+    LD2450_SUBSCRIBER_CALLBACK, /*!< Call a function on the processing task with each frame */
+    LD2450_SUBSCRIBER_QUEUE,    /*!< Send a `const ld2450_frame_t *` reference for each frame to a queue */
+    LD2450_SUBSCRIBER_NOTIFY,   /*!< Notify a task; it takes the latest frame with ld2450_subscriber_take() */
+} ld2450_subscriber_mode_t;
+
+/**
+ * @brief Frame subscriber
+ */
+typedef struct {
+    ld2450_subscriber_mode_t mode; /*!< Delivery mode */
+    ld2450_target_cb_t callback; /*!< Frame callback (CALLBACK mode) */
+    void *user_ctx;             /*!< User context for the callback (CALLBACK mode) */
+    QueueHandle_t queue;        /*!< Queue with items of size sizeof(const ld2450_frame_t *) (QUEUE mode) */
+    TaskHandle_t task;          /*!< Task to notify (NOTIFY mode) */
+    uint32_t notify_bits;       /*!< Notification bits set on the task for each frame (NOTIFY mode, 0 = bit 0) */
+} ld2450_subscriber_config_t;
+
+/**
+ * @brief Add a frame subscriber
+ * 
+ * Each delivered frame is copied once into a reference-counted pool slot that all
+ * QUEUE and NOTIFY subscribers share, so a slow subscriber only loses its own
+ * frames and never stalls the processing task. Frames received from a queue or
+ * ld2450_subscriber_take() must be returned with ld2450_subscriber_release().
+ * CALLBACK subscribers run inline on the processing task, after the callback set
+ * with ld2450_register_target_callback().
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param config Subscriber (copied)
+ * @param subscriber_id Pointer to store the subscriber ID
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NO_MEM if the table is full, error code otherwise
+ */
+esp_err_t ld2450_subscribe(ld2450_handle_t handle, const ld2450_subscriber_config_t *config,
+                           int *subscriber_id);
+
+/**
+ * @brief Remove a frame subscriber
+ * 
+ * Returns once the processing task no longer uses the subscriber. Frames already
+ * queued must still be released.
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param subscriber_id ID returned by ld2450_subscribe()
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_FOUND for an unknown ID
+ */
+esp_err_t ld2450_unsubscribe(ld2450_handle_t handle, int subscriber_id);
+
+/**
+ * @brief Take the latest frame of a NOTIFY subscriber
+ * 
+ * Only the most recent frame is kept per subscriber; older ones are released when
+ * a newer frame arrives.
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param subscriber_id ID returned by ld2450_subscribe()
+ * @param frame Pointer to store the frame reference
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_FOUND if no frame arrived since the last take
+ */
+esp_err_t ld2450_subscriber_take(ld2450_handle_t handle, int subscriber_id, const ld2450_frame_t **frame);
+
+/**
+ * @brief Return a frame reference received by a QUEUE or NOTIFY subscriber
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param frame Frame reference
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG if frame is not a pool slot
+ */
+esp_err_t ld2450_subscriber_release(ld2450_handle_t handle, const ld2450_frame_t *frame);
+
+/**
+ * @brief Header of one received chunk in a capture
+ * 
+ * A capture is a sequence of these headers, each followed by length raw UART
+ * bytes. ld2450_capture_read() returns it in this form, ready to be appended to a
+ * file, and ld2450_replay_start() accepts it. Fields are little-endian.
+ */
+typedef struct __attribute__((packed)) {
+    int64_t timestamp_us;       /*!< esp_timer time the chunk was taken off the UART */
+    uint16_t length;            /*!< Number of bytes that follow */
+} ld2450_capture_record_t;
+
+/**
+ * @brief Capture configuration
+ */
+typedef struct {
+    uint8_t *buffer;            /*!< Ring storage, e.g. from heap_caps_malloc(MALLOC_CAP_SPIRAM) (NULL = allocate) */
+    size_t size;                /*!< Ring size in bytes */
+} ld2450_capture_config_t;
+
+/**
+ * @brief Replay configuration
+ */
+typedef struct {
+    const uint8_t *data;        /*!< Capture to inject, as produced by ld2450_capture_read() */
+    size_t length;              /*!< Size of the capture in bytes */
+    bool max_speed;             /*!< Feed chunks as fast as possible instead of at the recorded pace */
+    bool loop;                  /*!< Start over at the end instead of stopping */
+} ld2450_replay_config_t;
+
+/**
+ * @brief Start recording raw UART bytes
+ * 
+ * The processing task reads each UART chunk straight into the ring, so capturing
+ * adds no copy to the receive path. Chunks that do not fit are dropped and counted
+ * in capture_drops. A previous capture that was not read is discarded.
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param config Ring to record into (copied)
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NO_MEM if the ring cannot be allocated,
+ *         ESP_ERR_INVALID_STATE without a processing task, error code otherwise
+ */
+esp_err_t ld2450_capture_start(ld2450_handle_t handle, const ld2450_capture_config_t *config);
+
+/**
+ * @brief Stop recording
+ * 
+ * Recorded chunks stay readable until the next ld2450_capture_start() or the
+ * instance is deleted.
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_STATE if no capture exists
+ */
+esp_err_t ld2450_capture_stop(ld2450_handle_t handle);
+
+/**
+ * @brief Move recorded chunks out of the capture ring
+ * 
+ * Copies as many whole records as fit into buffer and frees their ring space.
+ * Call it from the task that writes the capture to flash or SD.
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param buffer Destination
+ * @param size Size of buffer
+ * @param length Pointer to store the number of bytes copied (0 if nothing is pending)
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_SIZE if the next record does not fit,
+ *         ESP_ERR_INVALID_STATE if no capture exists
+ */
+esp_err_t ld2450_capture_read(ld2450_handle_t handle, uint8_t *buffer, size_t size, size_t *length);
+
+/**
+ * @brief Inject a capture into the receive pipeline
+ * 
+ * While the replay runs, the processing task parses and delivers the recorded
+ * bytes instead of the UART's, through the same path, with timestamps following
+ * the recorded timeline. UART bytes are still drained and scanned for command
+ * ACKs. The capture must stay valid until the replay ends or is stopped.
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param config Replay (copied)
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_STATE without a processing task,
+ *         error code otherwise
+ */
+esp_err_t ld2450_replay_start(ld2450_handle_t handle, const ld2450_replay_config_t *config);
+
+/**
+ * @brief Stop a replay and return to UART data
+ * 
+ * Returns once the processing task no longer reads the capture.
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_replay_stop(ld2450_handle_t handle);
+
+/**
+ * @brief Check whether a replay is running
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @return true while the processing task is feeding a capture
+ */
+bool ld2450_replay_active(ld2450_handle_t handle);
+
+/**
+ * @brief Process a radar data frame manually
+ * 
+ * This function allows processing a raw data frame without using the automatic
+ * processing feature. Useful for custom data acquisition. The frame's sequence
+ * and timestamp fields are left untouched.
+ * 
+ * @param data Raw frame data buffer
+ * @param length Length of the data buffer in bytes
+ * @param frame Pointer to frame structure to store parsed results
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_process_frame(const uint8_t *data, size_t length, ld2450_frame_t *frame);
+
+/**
+ * @brief Process a radar data frame manually with an explicit derived-field mode
+ * 
+ * @param data Raw frame data buffer
+ * @param length Length of the data buffer in bytes
+ * @param mode How distance and angle are computed
+ * @param frame Pointer to frame structure to store parsed results
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_process_frame_with_mode(const uint8_t *data, size_t length,
+                                         ld2450_derived_mode_t mode, ld2450_frame_t *frame);
+
+/**
+ * @brief Parse every data frame in a buffer
+ * 
+ * Scans a block of raw bytes, such as a UART read or a recorded capture, for
+ * data frames and parses them in one call. Bytes that do not belong to a valid
+ * frame are skipped. Scanning stops when frames is full or at a frame cut off by
+ * the end of the buffer: consumed then tells how many bytes to drop before
+ * appending more data and calling again. The frames' sequence and timestamp
+ * fields are left untouched.
+ * 
+ * @param data Raw bytes
+ * @param length Length of the data buffer in bytes
+ * @param mode How distance and angle are computed
+ * @param frames Array to store the parsed frames
+ * @param max_frames Capacity of frames
+ * @param count Pointer to store the number of frames parsed
+ * @param consumed Pointer to store the number of bytes scanned (may be NULL)
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_parse_frames(const uint8_t *data, size_t length, ld2450_derived_mode_t mode,
+                              ld2450_frame_t *frames, size_t max_frames, size_t *count, size_t *consumed);
+
+/**
+ * @brief Get a target's distance from the radar
+ * 
+ * Returns the parsed value when available and computes it from x/y otherwise
+ * (LD2450_DERIVED_LAZY / LD2450_DERIVED_NONE).
+ * 
+ * @param target Target
+ * @return float Distance in mm (0 for invalid targets)
+ */
+float ld2450_target_get_distance(const ld2450_target_t *target);
+
+/**
+ * @brief Get a target's angle, computing it on demand if the parser skipped it
+ * 
+ * @param target Target
+ * @return float Angle in degrees, -atan2(x, y) (0 for invalid targets)
+ */
+float ld2450_target_get_angle(const ld2450_target_t *target);
+
+/**
+ * @brief Feed externally sourced radar bytes into the driver
+ * 
+ * Bytes go through the same streaming scanner as UART data (arbitrary chunking is
+ * fine), and complete frames are delivered to the callback and frame ring. Use with
+ * auto_processing disabled when bytes are acquired by other means.
+ * 
+ * @param data Data buffer
+ * @param len Length of data in bytes
+ * @return esp_err_t ESP_OK if at least one frame was delivered, ESP_ERR_NOT_FINISHED if
+ *         more data is needed, error code otherwise
+ */
+esp_err_t ld2450_process_data(const uint8_t *data, size_t len);
+
+/**
+ * @brief Feed externally sourced radar bytes into a specific instance
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @see ld2450_process_data
+ */
+esp_err_t ld2450_dev_process_data(ld2450_handle_t handle, const uint8_t *data, size_t len);
+
+/**
+ * @brief Claim the oldest parsed frame from an instance's frame ring
+ * 
+ * Blocks until a frame is available or the timeout expires. The frame is parsed
+ * in place by the driver and stays valid until ld2450_frame_release() is called;
+ * only one frame may be claimed at a time. Requires `frame_ring_depth` > 0.
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param frame Pointer to store the claimed frame
+ * @param timeout_ms Maximum time to wait in milliseconds
+ * @return esp_err_t ESP_OK on success, ESP_ERR_TIMEOUT if no frame arrived, error code otherwise
+ */
+esp_err_t ld2450_frame_acquire(ld2450_handle_t handle, const ld2450_frame_t **frame,
+                               uint32_t timeout_ms);
+
+/**
+ * @brief Claim the oldest frame from a compact frame ring
+ * 
+ * Same semantics as ld2450_frame_acquire() for instances configured with
+ * `frame_ring_compact`. The first frame's timestamp delta is relative to the time
+ * returned by ld2450_get_compact_epoch(); later deltas chain from frame to frame.
+ * Release with ld2450_frame_release().
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param frame Pointer to store the claimed frame
+ * @param timeout_ms Maximum time to wait in milliseconds
+ * @return esp_err_t ESP_OK on success, ESP_ERR_TIMEOUT if no frame arrived, error code otherwise
+ */
+esp_err_t ld2450_compact_frame_acquire(ld2450_handle_t handle, const ld2450_compact_frame_t **frame,
+                                       uint32_t timeout_ms);
+
+/**
+ * @brief Get the base time of the compact frame ring's timestamp chain
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param epoch_us Pointer to store the base time (esp_timer time, us)
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_get_compact_epoch(ld2450_handle_t handle, int64_t *epoch_us);
 
 /**
- * @brief Serial port baud rate options
+ * @brief Return the frame claimed with ld2450_frame_acquire() or
+ *        ld2450_compact_frame_acquire() to the driver
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_STATE if no frame is claimed
  */
-typedef enum {
-    LD2450_BAUD_9600   = 0x0001, /*!< 9600 baud */
-    LD2450_BAUD_19200  = 0x0002, /*!< 19200 baud */
-    LD2450_BAUD_38400  = 0x0003, /*!< 38400 baud */
-    LD2450_BAUD_57600  = 0x0004, /*!< 57600 baud */
-    LD2450_BAUD_115200 = 0x0005, /*!< 115200 baud */
-    LD2450_BAUD_230400 = 0x0006, /*!< 230400 baud */
-    LD2450_BAUD_256000 = 0x0007, /*!< 256000 baud (default) */
-    LD2450_BAUD_460800 = 0x0008  /*!< 460800 baud */
-} ld2450_baud_rate_t;
+esp_err_t ld2450_frame_release(ld2450_handle_t handle);
 
 /**
- * @brief Region filtering type options
+ * @brief Convert a frame to the compact representation
+ * 
+ * @param frame Source frame
+ * @param prev_timestamp_us Timestamp of the previous frame in the stream (or the stream base time)
+ * @param compact Destination compact frame
  */
-typedef enum {
-    LD2450_FILTER_DISABLED = 0x0000,   /*!< Disable region filtering */
-    LD2450_FILTER_INCLUDE_ONLY = 0x0001, /*!< Only detect targets within specified regions */
-    LD2450_FILTER_EXCLUDE = 0x0002      /*!< Do not detect targets within specified regions */
-} ld2450_filter_type_t;
+void ld2450_frame_to_compact(const ld2450_frame_t *frame, int64_t prev_timestamp_us,
+                             ld2450_compact_frame_t *compact);
 
 /**
- * @brief Firmware version information
+ * @brief Expand a compact frame back into a full frame
+ * 
+ * @param compact Source compact frame
+ * @param prev_timestamp_us Timestamp of the previous frame in the stream (or the stream base time)
+ * @param mode How distance and angle are recomputed
+ * @param frame Destination frame
  */
-typedef struct {
-    uint16_t main_version;     /*!< Main version number */
-    uint32_t sub_version;      /*!< Sub-version number */
-    char version_string[32];   /*!< Formatted version string (e.g., "V1.02.22062416") */
-} ld2450_firmware_version_t;
+void ld2450_frame_from_compact(const ld2450_compact_frame_t *compact, int64_t prev_timestamp_us,
+                               ld2450_derived_mode_t mode, ld2450_frame_t *frame);
 
 /**
- * @brief Region definition for filtering (rectangular area)
+ * @brief Get the number of frames dropped because the frame ring was full
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param overruns Pointer to store the overrun count
+ * @return esp_err_t ESP_OK on success, error code otherwise
  */
-typedef struct {
-    int16_t x1;   /*!< X coordinate of first corner (mm) */
-    int16_t y1;   /*!< Y coordinate of first corner (mm) */
-    int16_t x2;   /*!< X coordinate of diagonal corner (mm) */
-    int16_t y2;   /*!< Y coordinate of diagonal corner (mm) */
-} ld2450_region_t;
+esp_err_t ld2450_get_frame_overruns(ld2450_handle_t handle, uint32_t *overruns);
 
 /**
- * @brief Target information structure
+ * @brief Get frame synchronization counters
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param stats Pointer to store the counters
+ * @return esp_err_t ESP_OK on success, error code otherwise
  */
-typedef struct {
-    int16_t x;                /*!< X coordinate (mm) */
-    int16_t y;                /*!< Y coordinate (mm) */
-    int16_t speed;            /*!< Speed (cm/s) */
-    uint16_t resolution;      /*!< Distance resolution (mm) */
-    float distance;           /*!< Calculated distance (mm) */
-    float angle;              /*!< Calculated angle in degrees */
-    bool valid;               /*!< Target validity flag */
-} ld2450_target_t;
+esp_err_t ld2450_get_sync_stats(ld2450_handle_t handle, ld2450_sync_stats_t *stats);
 
 /**
- * @brief Data frame structure containing target information
+ * @brief Replace an instance's frame delivery policy
+ * 
+ * Takes effect from the next frame; the next frame that passes the rate limits is
+ * delivered unconditionally and becomes the new reference for the change filters.
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param policy New policy
+ * @return esp_err_t ESP_OK on success, error code otherwise
  */
-typedef struct {
-    ld2450_target_t targets[3];  /*!< Data for up to 3 targets */
-    uint8_t count;               /*!< Number of valid targets (0-3) */
-} ld2450_frame_t;
+esp_err_t ld2450_set_delivery_policy(ld2450_handle_t handle, const ld2450_delivery_policy_t *policy);
 
 /**
- * @brief Driver configuration structure
+ * @brief Get an instance's frame delivery policy
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param policy Pointer to store the policy
+ * @return esp_err_t ESP_OK on success, error code otherwise
  */
-typedef struct {
-    uart_port_t uart_port;      /*!< UART port number */
-    int uart_rx_pin;            /*!< GPIO pin for UART RX */
-    int uart_tx_pin;            /*!< GPIO pin for UART TX */
-    uint32_t uart_baud_rate;    /*!< UART baud rate */
-    bool auto_processing;       /*!< Enable automatic frame processing */
-    int task_priority;          /*!< Priority for auto processing task (if enabled) */
-} ld2450_config_t;
+esp_err_t ld2450_get_delivery_policy(ld2450_handle_t handle, ld2450_delivery_policy_t *policy);
 
 /**
- * @brief Target data callback function type
+ * @brief Get driver statistics
  * 
- * This function is called when new target data is available
+ * Counters and timing distributions are copied under the statistics lock, so
+ * they form one consistent snapshot. The exception is frame_ring_overruns,
+ * counted by the frame ring and read after the snapshot.
  * 
- * @param frame Pointer to the frame containing target data
- * @param user_ctx User context pointer passed during registration
+ * @param handle Driver handle (NULL for the default instance)
+ * @param stats Pointer to store the statistics
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_SUPPORTED if built with LD2450_ENABLE_STATS=0
  */
-typedef void (*ld2450_target_cb_t)(const ld2450_frame_t *frame, void *user_ctx);
+esp_err_t ld2450_get_stats(ld2450_handle_t handle, ld2450_stats_t *stats);
 
 /**
- * @brief Default configuration for the LD2450 driver
+ * @brief Reset all counters reported by ld2450_get_stats()
+ * 
+ * With a processing task the reset is applied by the task, which is woken for
+ * it, so it takes effect shortly after the call returns.
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_SUPPORTED if built with LD2450_ENABLE_STATS=0
  */
-#define LD2450_DEFAULT_CONFIG() { \
-    .uart_port = UART_NUM_2, \
-    .uart_rx_pin = 16, \
-    .uart_tx_pin = 17, \
-    .uart_baud_rate = 256000, \
-    .auto_processing = true, \
-    .task_priority = 5, \
-}
+esp_err_t ld2450_reset_stats(ld2450_handle_t handle);
 
 /**
- * @brief Initialize the LD2450 radar driver
+ * @brief Get the low-power state and time-in-sleep accounting
  * 
- * @param config Pointer to driver configuration structure
+ * @param handle Driver handle (NULL for the default instance)
+ * @param stats Pointer to store the accounting
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_STATE if low-power operation is not enabled
+ */
+esp_err_t ld2450_get_power_stats(ld2450_handle_t handle, ld2450_power_stats_t *stats);
+
+/**
+ * @brief Get the stream health state and recovery counters
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param stats Pointer to store the counters
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_STATE if the watchdog is not enabled
+ */
+esp_err_t ld2450_get_health_stats(ld2450_handle_t handle, ld2450_health_stats_t *stats);
+
+/**
+ * @brief Read the binary event trace
+ * 
+ * Returns the records added since the previous call, oldest first. The trace is a
+ * ring of LD2450_TRACE_DEPTH records that the processing task overwrites when it
+ * is not read in time; the overwritten records are counted in lost. A single
+ * reader is assumed.
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param records Array to store the records
+ * @param max Capacity of records
+ * @param count Pointer to store the number of records stored
+ * @param lost Pointer to store the number of records overwritten before they were read (may be NULL)
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_SUPPORTED if built with LD2450_ENABLE_TRACE=0
+ */
+esp_err_t ld2450_trace_read(ld2450_handle_t handle, ld2450_trace_record_t *records, size_t max,
+                            size_t *count, uint32_t *lost);
+
+/**
+ * @brief Log a one-line summary of the trace events since the last summary
+ * 
+ * Meant to be called periodically from a low-priority task, in place of the
+ * per-event logging the driver no longer does on its processing task. Logs
+ * nothing if less than min_interval_ms has passed since the last summary or no
+ * event has been traced since; warnings are used if sync was lost or input dropped.
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param min_interval_ms Shortest interval between two summaries
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_SUPPORTED if built with LD2450_ENABLE_TRACE=0
+ */
+esp_err_t ld2450_trace_log(ld2450_handle_t handle, uint32_t min_interval_ms);
+
+/**
+ * @brief Define or remove a software zone
+ * 
+ * Zones are evaluated by the driver for every parsed frame, before the delivery
+ * policy, without touching the module, so they can be changed at any time. Unlike
+ * the module's region filter they do not hide targets; they report occupancy and
+ * enter/exit events. The new shape is picked up by the next frame. Coordinates are
+ * limited to +/-LD2450_ZONE_COORD_MAX.
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param index Zone index (0 to LD2450_ZONE_MAX - 1)
+ * @param zone Zone shape (NULL removes the zone)
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG for a bad index or shape,
+ *         ESP_ERR_NO_MEM if the zone table cannot be allocated
+ */
+esp_err_t ld2450_set_zone(ld2450_handle_t handle, uint8_t index, const ld2450_zone_t *zone);
+
+/**
+ * @brief Remove all software zones
+ * 
+ * @param handle Driver handle (NULL for the default instance)
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
-esp_err_t ld2450_init(const ld2450_config_t *config);
+esp_err_t ld2450_clear_zones(ld2450_handle_t handle);
 
 /**
- * @brief Deinitialize the LD2450 radar driver and release resources
+ * @brief Get the number of targets in each software zone
  * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param occupancy Array receiving the target count of each zone (0 for unused zones)
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
-esp_err_t ld2450_deinit(void);
+esp_err_t ld2450_get_zone_occupancy(ld2450_handle_t handle, uint8_t occupancy[LD2450_ZONE_MAX]);
 
 /**
- * @brief Register a callback function for target data
+ * @brief Register a callback for zone enter/exit events
  * 
- * @param callback Function pointer to call when new target data is available
+ * @param handle Driver handle (NULL for the default instance)
+ * @param callback Function to call for each event (NULL to unregister)
  * @param user_ctx User context pointer passed to the callback function
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
-esp_err_t ld2450_register_target_callback(ld2450_target_cb_t callback, void *user_ctx);
+esp_err_t ld2450_register_zone_callback(ld2450_handle_t handle, ld2450_zone_cb_t callback,
+                                        void *user_ctx);
 
 /**
- * @brief Process a radar data frame manually
+ * @brief Copy the occupancy heatmap and zone dwell times, optionally starting over
  * 
- * This function allows processing a raw data frame without using the automatic
- * processing feature. Useful for custom data acquisition.
+ * With reset set, the accumulation restarts atomically: every frame is counted
+ * in exactly one snapshot. Without it, frames parsed during the copy may be
+ * partially included.
  * 
- * @param data Raw frame data buffer
- * @param length Length of the data buffer in bytes
- * @param frame Pointer to frame structure to store parsed results
+ * @param handle Driver handle (NULL for the default instance)
+ * @param info Pointer to store the summary and dwell times
+ * @param cells Array receiving cols x rows cell counts (NULL for the summary only)
+ * @param max_cells Capacity of cells
+ * @param reset Clear the counters after copying
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_STATE if the heatmap is not enabled,
+ *         ESP_ERR_INVALID_SIZE if cells cannot hold the grid, error code otherwise
+ */
+esp_err_t ld2450_heatmap_snapshot(ld2450_handle_t handle, ld2450_heatmap_info_t *info, uint16_t *cells,
+                                  size_t max_cells, bool reset);
+
+/**
+ * @brief Replace an instance's tracker configuration
+ * 
+ * Takes effect from the next frame and drops all tracks; IDs keep counting.
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param config New configuration
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
-esp_err_t ld2450_process_frame(const uint8_t *data, size_t length, ld2450_frame_t *frame);
+esp_err_t ld2450_set_tracker_config(ld2450_handle_t handle, const ld2450_tracker_config_t *config);
+
+/**
+ * @brief Get the confirmed tracks after the most recent frame
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param tracks Pointer to store the tracks
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_STATE if the tracker is disabled
+ */
+esp_err_t ld2450_get_tracks(ld2450_handle_t handle, ld2450_track_set_t *tracks);
+
+/**
+ * @brief Register a callback for tracker output
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param callback Function to call for every delivered frame (NULL to unregister)
+ * @param user_ctx User context pointer passed to the callback function
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_register_track_callback(ld2450_handle_t handle, ld2450_track_cb_t callback,
+                                         void *user_ctx);
+
+/**
+ * @brief Register a callback for batched frame delivery
+ * 
+ * Needs config.batch.max_frames set at creation. Runs alongside the target
+ * callback: every delivered frame goes to both.
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param callback Function to call with each batch (NULL to unregister)
+ * @param user_ctx User context pointer passed to the callback function
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_STATE if batching is not enabled,
+ *         error code otherwise
+ */
+esp_err_t ld2450_register_batch_callback(ld2450_handle_t handle, ld2450_batch_cb_t callback, void *user_ctx);
+
+/**
+ * @brief Add a radar to the fusion stage, or move one already added
+ * 
+ * Each source's frames are rotated and translated into room coordinates with a
+ * fixed-point rotation precomputed here. A fused frame is produced once every
+ * source that reported within the window has sent a frame, or sooner when a
+ * source sends a second one first.
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param pose Mounting pose
+ * @param source Pointer to store the source index used in the radars bitmasks (may be NULL)
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NO_MEM if LD2450_FUSION_MAX_RADARS
+ *         radars were added already, error code otherwise
+ */
+esp_err_t ld2450_fusion_add_radar(ld2450_handle_t handle, const ld2450_pose_t *pose, uint8_t *source);
+
+/**
+ * @brief Remove a radar from the fusion stage
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_FOUND if the radar was not added
+ */
+esp_err_t ld2450_fusion_remove_radar(ld2450_handle_t handle);
+
+/**
+ * @brief Replace the fusion stage configuration
+ * 
+ * @param config New configuration
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_fusion_set_config(const ld2450_fusion_config_t *config);
+
+/**
+ * @brief Get the most recent fused frame
+ * 
+ * @param frame Pointer to store the frame
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_FOUND if no fused frame was produced yet
+ */
+esp_err_t ld2450_fusion_get_frame(ld2450_fusion_frame_t *frame);
+
+/**
+ * @brief Register a callback for fused frames
+ * 
+ * @param callback Function to call for every fused frame (NULL to unregister)
+ * @param user_ctx User context pointer passed to the callback function
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_register_fusion_callback(ld2450_fusion_cb_t callback, void *user_ctx);
+
+/** @brief Largest command value accepted by ld2450_command_submit() */
+#define LD2450_COMMAND_VALUE_MAX 26
+
+/**
+ * @brief Asynchronous command completion callback
+ * 
+ * Runs on the driver's processing task; the ACK buffer is only valid during the call.
+ * 
+ * @param handle Driver handle the command was submitted on
+ * @param command Command word
+ * @param result ESP_OK, ESP_ERR_TIMEOUT, or ESP_ERR_INVALID_RESPONSE for a rejected command
+ * @param ack Complete ACK frame (NULL on timeout)
+ * @param ack_len ACK frame length
+ * @param user_ctx User context from the command
+ */
+typedef void (*ld2450_command_cb_t)(ld2450_handle_t handle, uint16_t command, esp_err_t result,
+                                    const uint8_t *ack, size_t ack_len, void *user_ctx);
+
+/**
+ * @brief Asynchronous command request
+ */
+typedef struct {
+    uint16_t command;           /*!< Protocol command word (e.g. 0x0080 single-target mode) */
+    uint8_t value[LD2450_COMMAND_VALUE_MAX]; /*!< Command value, little-endian as on the wire */
+    uint8_t value_len;          /*!< Number of value bytes */
+    uint32_t timeout_ms;        /*!< ACK timeout (0 = driver default) */
+    ld2450_command_cb_t callback; /*!< Completion callback (optional) */
+    void *user_ctx;             /*!< User context for the callback */
+    TaskHandle_t notify_task;   /*!< Task notified with the esp_err_t result as notification value (optional) */
+} ld2450_command_t;
+
+/**
+ * @brief Queue a command for the driver's processing task and return immediately
+ * 
+ * Commands run in submission order. The driver enters configuration mode before
+ * the first queued command and leaves it once the queue drains, so a burst of
+ * commands shares one configuration-mode window. ACKs are matched by their command
+ * echo in the receive path. After a module restart (0x00A3) completion is reported
+ * once the module has had time to reboot.
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param command Command to queue (copied)
+ * @return esp_err_t ESP_OK if queued, ESP_ERR_NOT_SUPPORTED without auto-processing,
+ *         ESP_ERR_NO_MEM if the command queue is full, error code otherwise
+ */
+esp_err_t ld2450_command_submit(ld2450_handle_t handle, const ld2450_command_t *command);
+
+/**
+ * @brief Open a configuration session
+ * 
+ * Enters configuration mode once; until ld2450_config_commit(), the setters and
+ * getters run inside this session instead of entering and leaving configuration
+ * mode around every command. Target reporting is paused for the whole session.
+ * The radar applies each command as it is sent, so commit does not roll back.
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_STATE if a session is already open
+ */
+esp_err_t ld2450_config_begin(ld2450_handle_t handle);
+
+/**
+ * @brief Close a configuration session and return the radar to normal operation
+ * 
+ * Restarting the module inside a session ends the session early.
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @return esp_err_t ESP_OK if every operation in the session and the exit succeeded,
+ *         otherwise the first error encountered
+ */
+esp_err_t ld2450_config_commit(ld2450_handle_t handle);
+
+/**
+ * @brief Drop an instance's cached module identity and settings
+ * 
+ * With `nvs_namespace` configured, the driver keeps the firmware version, MAC
+ * address and last-applied settings in NVS. Getters answer from the cache and
+ * setters skip writes that match it; clear it after changing the module's
+ * configuration by other means (e.g. the Bluetooth app). The identity is queried
+ * again once the data stream is live.
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_SUPPORTED if no cache is configured
+ */
+esp_err_t ld2450_clear_cache(ld2450_handle_t handle);
 
 /**
  * @brief Set target tracking mode (single or multi-target)
@@ -174,6 +1500,14 @@ esp_err_t ld2450_process_frame(const uint8_t *data, size_t length, ld2450_frame_
  */
 esp_err_t ld2450_set_tracking_mode(ld2450_tracking_mode_t mode);
 
+/**
+ * @brief Set target tracking mode (single or multi-target) on a specific instance
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @see ld2450_set_tracking_mode
+ */
+esp_err_t ld2450_dev_set_tracking_mode(ld2450_handle_t handle, ld2450_tracking_mode_t mode);
+
 /**
  * @brief Get current target tracking mode
  * 
@@ -182,6 +1516,14 @@ esp_err_t ld2450_set_tracking_mode(ld2450_tracking_mode_t mode);
  */
 esp_err_t ld2450_get_tracking_mode(ld2450_tracking_mode_t *mode);
 
+/**
+ * @brief Get current target tracking mode on a specific instance
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @see ld2450_get_tracking_mode
+ */
+esp_err_t ld2450_dev_get_tracking_mode(ld2450_handle_t handle, ld2450_tracking_mode_t *mode);
+
 /**
  * @brief Get firmware version information
  * 
@@ -190,6 +1532,15 @@ esp_err_t ld2450_get_tracking_mode(ld2450_tracking_mode_t *mode);
  */
 esp_err_t ld2450_get_firmware_version(ld2450_firmware_version_t *version);
 
+/**
+ * @brief Get firmware version information on a specific instance
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @see ld2450_get_firmware_version
+ */
+esp_err_t ld2450_dev_get_firmware_version(ld2450_handle_t handle,
+                                          ld2450_firmware_version_t *version);
+
 /**
  * @brief Set serial port baud rate
  * 
@@ -200,6 +1551,49 @@ esp_err_t ld2450_get_firmware_version(ld2450_firmware_version_t *version);
  */
 esp_err_t ld2450_set_baud_rate(ld2450_baud_rate_t baud_rate);
 
+/**
+ * @brief Set serial port baud rate on a specific instance
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @see ld2450_set_baud_rate
+ */
+esp_err_t ld2450_dev_set_baud_rate(ld2450_handle_t handle, ld2450_baud_rate_t baud_rate);
+
+/**
+ * @brief Switch the module and the host UART to a new baud rate
+ * 
+ * Writes the rate to the module, restarts it, reconfigures the host UART and
+ * verifies the link with a firmware version query. If verification fails the
+ * host UART is returned to its previous rate.
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param baud_rate Baud rate to switch to
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_STATE inside a configuration
+ *         session, error code otherwise
+ */
+esp_err_t ld2450_switch_baud_rate(ld2450_handle_t handle, ld2450_baud_rate_t baud_rate);
+
+/**
+ * @brief Find the baud rate the module is transmitting at
+ * 
+ * Tries each ld2450_baud_rate_t on the host UART, starting with the current one,
+ * and accepts a rate once a valid data frame or command ACK is received. The host
+ * UART is left at the detected rate, or restored if none answers.
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param detected Pointer to store the detected rate (may be NULL)
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_FOUND if no rate answered, error code otherwise
+ */
+esp_err_t ld2450_detect_baud_rate(ld2450_handle_t handle, ld2450_baud_rate_t *detected);
+
+/**
+ * @brief Convert a baud rate setting to bits per second
+ * 
+ * @param baud_rate Baud rate setting
+ * @return Bits per second, 0 for an invalid setting
+ */
+uint32_t ld2450_baud_rate_to_bps(ld2450_baud_rate_t baud_rate);
+
 /**
  * @brief Restore factory default settings
  * 
@@ -209,6 +1603,14 @@ esp_err_t ld2450_set_baud_rate(ld2450_baud_rate_t baud_rate);
  */
 esp_err_t ld2450_restore_factory_settings(void);
 
+/**
+ * @brief Restore factory default settings on a specific instance
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @see ld2450_restore_factory_settings
+ */
+esp_err_t ld2450_dev_restore_factory_settings(ld2450_handle_t handle);
+
 /**
  * @brief Restart the radar module
  * 
@@ -216,6 +1618,14 @@ esp_err_t ld2450_restore_factory_settings(void);
  */
 esp_err_t ld2450_restart_module(void);
 
+/**
+ * @brief Restart the radar module on a specific instance
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @see ld2450_restart_module
+ */
+esp_err_t ld2450_dev_restart_module(ld2450_handle_t handle);
+
 /**
  * @brief Enable or disable Bluetooth functionality
  * 
@@ -226,6 +1636,14 @@ esp_err_t ld2450_restart_module(void);
  */
 esp_err_t ld2450_set_bluetooth(bool enable);
 
+/**
+ * @brief Enable or disable Bluetooth functionality on a specific instance
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @see ld2450_set_bluetooth
+ */
+esp_err_t ld2450_dev_set_bluetooth(ld2450_handle_t handle, bool enable);
+
 /**
  * @brief Get the module's MAC address
  * 
@@ -234,6 +1652,14 @@ esp_err_t ld2450_set_bluetooth(bool enable);
  */
 esp_err_t ld2450_get_mac_address(uint8_t mac[6]);
 
+/**
+ * @brief Get the module's MAC address on a specific instance
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @see ld2450_get_mac_address
+ */
+esp_err_t ld2450_dev_get_mac_address(ld2450_handle_t handle, uint8_t mac[6]);
+
 /**
  * @brief Configure region filtering
  * 
@@ -243,6 +1669,15 @@ esp_err_t ld2450_get_mac_address(uint8_t mac[6]);
  */
 esp_err_t ld2450_set_region_filter(ld2450_filter_type_t type, const ld2450_region_t regions[3]);
 
+/**
+ * @brief Configure region filtering on a specific instance
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @see ld2450_set_region_filter
+ */
+esp_err_t ld2450_dev_set_region_filter(ld2450_handle_t handle,
+                                       ld2450_filter_type_t type, const ld2450_region_t regions[3]);
+
 /**
  * @brief Query current region filtering configuration
  * 
@@ -252,6 +1687,15 @@ esp_err_t ld2450_set_region_filter(ld2450_filter_type_t type, const ld2450_regio
  */
 esp_err_t ld2450_get_region_filter(ld2450_filter_type_t *type, ld2450_region_t regions[3]);
 
+/**
+ * @brief Query current region filtering configuration on a specific instance
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @see ld2450_get_region_filter
+ */
+esp_err_t ld2450_dev_get_region_filter(ld2450_handle_t handle,
+                                       ld2450_filter_type_t *type, ld2450_region_t regions[3]);
+
 /**
  * @brief Get the last error data buffer for debugging
  * 
@@ -265,6 +1709,15 @@ esp_err_t ld2450_get_region_filter(ld2450_filter_type_t *type, ld2450_region_t r
  */
 esp_err_t ld2450_get_last_error_data(uint8_t *buffer, size_t buffer_size, size_t *length);
 
+/**
+ * @brief Get the last error data buffer for debugging on a specific instance
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @see ld2450_get_last_error_data
+ */
+esp_err_t ld2450_dev_get_last_error_data(ld2450_handle_t handle,
+                                         uint8_t *buffer, size_t buffer_size, size_t *length);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,365 @@
+/**
+ * @file ld2450.hpp
+ * @brief Header-only C++ layer over the HLK-LD2450 driver
+ * 
+ * Wraps a driver instance in a move-only RAII handle and binds callbacks at
+ * compile time: the handler is a template argument, so the driver calls a
+ * generated trampoline with the object as its context pointer. Nothing is
+ * allocated and nothing goes through a virtual call or std::function.
+ * 
+ * Derived-field computation, frame filtering and delivery mode are policy
+ * parameters. A policy that is not used compiles to nothing, so a frame reaches
+ * the handler through the same single indirect call as with the C API.
+ * 
+ * @note Needs C++17.
+ * 
+ * @author NieRVoid
+ * @date 2025-03-12
+ * @license MIT
+ */
+
+#pragma once
+
+#if __cplusplus < 201703L
+#error "ld2450.hpp needs C++17"
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include "ld2450.h"
+
+namespace ld2450 {
+
+/**
+ * @brief Derived-field policy: how the parser fills distance and angle
+ * 
+ * @tparam Mode Derived-field mode passed to the driver
+ */
+template <ld2450_derived_mode_t Mode>
+struct Derive {
+    static constexpr ld2450_derived_mode_t mode = Mode;
+};
+
+using DeriveFloat = Derive<LD2450_DERIVED_FLOAT>;
+using DeriveFixed = Derive<LD2450_DERIVED_FIXED>;
+using DeriveLazy = Derive<LD2450_DERIVED_LAZY>;
+using DeriveNone = Derive<LD2450_DERIVED_NONE>;
+
+/**
+ * @brief Filter policy passing every frame (no code is generated for it)
+ * 
+ * A filter policy is any type with a static accept(const ld2450_frame_t &)
+ * returning whether the frame reaches the handler.
+ */
+struct AcceptAll {
+    static constexpr bool accept(const ld2450_frame_t &) noexcept { return true; }
+};
+
+/**
+ * @brief Filter policy passing frames with at least one valid target
+ */
+struct NonEmpty {
+    static bool accept(const ld2450_frame_t &frame) noexcept { return frame.count > 0; }
+};
+
+/**
+ * @brief Filter policy passing frames with a valid target within a range
+ * 
+ * Compares squared coordinates, so no derived field is needed.
+ * 
+ * @tparam MaxMm Range from the radar (mm)
+ */
+template <uint32_t MaxMm>
+struct WithinRange {
+    static_assert(MaxMm <= UINT16_MAX, "Range out of range");
+    
+    static bool accept(const ld2450_frame_t &frame) noexcept
+    {
+        for (const ld2450_target_t &target : frame.targets) {
+            int32_t x = target.x;
+            int32_t y = target.y;
+            if (target.valid && (uint32_t)(x * x) + (uint32_t)(y * y) <= MaxMm * MaxMm) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+/**
+ * @brief Delivery policy calling the handler for every delivered frame
+ * 
+ * Handlers take (const ld2450_frame_t &frame).
+ */
+struct PerFrame {
+    static constexpr uint8_t max_frames = 0;
+    static constexpr uint16_t max_latency_ms = 0;
+};
+
+/**
+ * @brief Delivery policy calling the handler with batches of frames
+ * 
+ * Sets config.batch at creation; handlers take (const ld2450_frame_t *frames, size_t count).
+ * 
+ * @tparam Frames Frames per batch
+ * @tparam LatencyMs Longest a frame waits in a partial batch (0 = driver default)
+ */
+template <uint8_t Frames, uint16_t LatencyMs = 0>
+struct Batched {
+    static_assert(Frames > 0 && Frames <= LD2450_BATCH_MAX_FRAMES, "Batch size out of range");
+    static constexpr uint8_t max_frames = Frames;
+    static constexpr uint16_t max_latency_ms = LatencyMs;
+};
+
+/**
+ * @brief Stateless frame parser with compile-time derived-field and filter policies
+ * 
+ * @tparam DerivePolicy Derive<> policy
+ * @tparam Filter Filter policy
+ */
+template <typename DerivePolicy = DeriveFloat, typename Filter = AcceptAll>
+struct Parser {
+    /**
+     * @brief Parse one data frame
+     * 
+     * @param data Raw frame data buffer
+     * @param length Length of the data buffer in bytes
+     * @param frame Frame to fill
+     * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_FOUND if the filter rejected the frame,
+     *         error code otherwise
+     */
+    static esp_err_t parse(const uint8_t *data, size_t length, ld2450_frame_t &frame) noexcept
+    {
+        esp_err_t ret = ld2450_process_frame_with_mode(data, length, DerivePolicy::mode, &frame);
+        if constexpr (!std::is_same_v<Filter, AcceptAll>) {
+            if (ret == ESP_OK && !Filter::accept(frame)) {
+                return ESP_ERR_NOT_FOUND;
+            }
+        }
+        return ret;
+    }
+    
+    /**
+     * @brief Parse every data frame in a buffer, keeping the ones the filter accepts
+     * 
+     * @param data Raw bytes
+     * @param length Length of the data buffer in bytes
+     * @param frames Array to store the frames
+     * @param max_frames Capacity of frames
+     * @param count Set to the number of frames kept
+     * @param consumed Set to the number of bytes scanned
+     * @return esp_err_t ESP_OK on success, error code otherwise
+     * @see ld2450_parse_frames
+     */
+    static esp_err_t parse_all(const uint8_t *data, size_t length, ld2450_frame_t *frames, size_t max_frames,
+                               size_t &count, size_t &consumed) noexcept
+    {
+        esp_err_t ret = ld2450_parse_frames(data, length, DerivePolicy::mode, frames, max_frames, &count,
+                                            &consumed);
+        if constexpr (!std::is_same_v<Filter, AcceptAll>) {
+            size_t kept = 0;
+            for (size_t i = 0; ret == ESP_OK && i < count; i++) {
+                if (Filter::accept(frames[i])) {
+                    frames[kept++] = frames[i];
+                }
+            }
+            count = ret == ESP_OK ? kept : count;
+        }
+        return ret;
+    }
+};
+
+/**
+ * @brief Driver instance owning its handle
+ * 
+ * Move-only; the destructor deletes the instance. Moving a Radar does not affect
+ * registered callbacks, whose context is the handler object, not the Radar.
+ * Everything not wrapped here is reached with get() and the C API.
+ * 
+ * @tparam DerivePolicy Derive<> policy, applied to config.derived_mode at creation
+ * @tparam Filter Filter policy, applied before the handler is called
+ * @tparam Delivery PerFrame or Batched<>
+ */
+template <typename DerivePolicy = DeriveFloat, typename Filter = AcceptAll, typename Delivery = PerFrame>
+class Radar {
+public:
+    using parser = Parser<DerivePolicy, Filter>;
+    
+    static constexpr bool batched = Delivery::max_frames > 0;
+    
+    static_assert(!batched || std::is_same_v<Filter, AcceptAll>,
+                  "Batched delivery hands the driver's array through unfiltered; filter in the handler");
+    
+    Radar() noexcept = default;
+    
+    /**
+     * @brief Take ownership of an existing instance
+     * 
+     * @param handle Handle returned by ld2450_create()
+     */
+    explicit Radar(ld2450_handle_t handle) noexcept : handle_(handle) {}
+    
+    ~Radar() { reset(); }
+    
+    Radar(const Radar &) = delete;
+    Radar &operator=(const Radar &) = delete;
+    
+    Radar(Radar &&other) noexcept : handle_(other.release()) {}
+    
+    Radar &operator=(Radar &&other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            handle_ = other.release();
+        }
+        return *this;
+    }
+    
+    /**
+     * @brief Create a driver instance with the policies applied to its configuration
+     * 
+     * @param config Driver configuration; derived_mode and batch are overridden
+     * @param radar Set to the new instance on success
+     * @return esp_err_t ESP_OK on success, error code otherwise
+     */
+    static esp_err_t create(ld2450_config_t config, Radar &radar) noexcept
+    {
+        ld2450_handle_t handle = nullptr;
+        
+        config.derived_mode = DerivePolicy::mode;
+        config.batch.max_frames = Delivery::max_frames;
+        config.batch.max_latency_ms = Delivery::max_latency_ms;
+        
+        esp_err_t ret = ld2450_create(&config, &handle);
+        if (ret == ESP_OK) {
+            radar = Radar(handle);
+        }
+        return ret;
+    }
+    
+    /** @brief Driver handle, for the C API (nullptr if empty) */
+    ld2450_handle_t get() const noexcept { return handle_; }
+    
+    explicit operator bool() const noexcept { return handle_ != nullptr; }
+    
+    /**
+     * @brief Give up ownership without deleting the instance
+     * 
+     * @return ld2450_handle_t The handle, now owned by the caller
+     */
+    ld2450_handle_t release() noexcept
+    {
+        ld2450_handle_t handle = handle_;
+        handle_ = nullptr;
+        return handle;
+    }
+    
+    /**
+     * @brief Delete the instance, if any
+     */
+    void reset() noexcept
+    {
+        if (handle_) {
+            ld2450_delete(handle_);
+            handle_ = nullptr;
+        }
+    }
+    
+    /**
+     * @brief Bind a handler on an object
+     * 
+     * Handler is a member function pointer, or a free function taking the object
+     * first. It runs on the processing task; the object must outlive the binding.
+     * 
+     * @tparam Handler Handler, called as std::invoke(Handler, object, ...)
+     * @param object Object passed to the handler
+     * @return esp_err_t ESP_OK on success, error code otherwise
+     */
+    template <auto Handler, typename T>
+    esp_err_t on_frame(T &object) noexcept
+    {
+        if constexpr (batched) {
+            return bind(&batch_trampoline<Handler, T>, &object);
+        } else {
+            return bind(&frame_trampoline<Handler, T>, &object);
+        }
+    }
+    
+    /**
+     * @brief Bind a free function as the handler
+     * 
+     * @tparam Handler Function taking the frame, or the frames and their count
+     * @return esp_err_t ESP_OK on success, error code otherwise
+     */
+    template <auto Handler>
+    esp_err_t on_frame() noexcept
+    {
+        if constexpr (batched) {
+            return bind(&batch_trampoline<Handler, void>, nullptr);
+        } else {
+            return bind(&frame_trampoline<Handler, void>, nullptr);
+        }
+    }
+    
+    /**
+     * @brief Unbind the handler
+     * 
+     * @return esp_err_t ESP_OK on success, error code otherwise
+     */
+    esp_err_t clear() noexcept
+    {
+        if constexpr (batched) {
+            return bind(static_cast<ld2450_batch_cb_t>(nullptr), nullptr);
+        } else {
+            return bind(static_cast<ld2450_target_cb_t>(nullptr), nullptr);
+        }
+    }
+
+private:
+    template <typename Callback>
+    esp_err_t bind(Callback callback, void *user_ctx) noexcept
+    {
+        // An empty Radar must not address the default instance
+        if (!handle_) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        if constexpr (batched) {
+            return ld2450_register_batch_callback(handle_, callback, user_ctx);
+        } else {
+            return ld2450_dev_register_target_callback(handle_, callback, user_ctx);
+        }
+    }
+    
+    template <auto Handler, typename T>
+    static void frame_trampoline(const ld2450_frame_t *frame, void *user_ctx)
+    {
+        if constexpr (!std::is_same_v<Filter, AcceptAll>) {
+            if (!Filter::accept(*frame)) {
+                return;
+            }
+        }
+        if constexpr (std::is_void_v<T>) {
+            (void)user_ctx;
+            std::invoke(Handler, *frame);
+        } else {
+            std::invoke(Handler, *static_cast<T *>(user_ctx), *frame);
+        }
+    }
+    
+    template <auto Handler, typename T>
+    static void batch_trampoline(const ld2450_frame_t *frames, size_t count, void *user_ctx)
+    {
+        if constexpr (std::is_void_v<T>) {
+            (void)user_ctx;
+            std::invoke(Handler, frames, count);
+        } else {
+            std::invoke(Handler, *static_cast<T *>(user_ctx), frames, count);
+        }
+    }
+    
+    ld2450_handle_t handle_ = nullptr;
+};
+
+} // namespace ld2450
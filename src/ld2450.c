@@ -10,9 +10,12 @@
  * @license MIT
  */
 
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <inttypes.h>
 #include "driver/gpio.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/semphr.h"
@@ -23,41 +26,536 @@
 
 static const char *TAG = LD2450_LOG_TAG;
 
-// Global driver instance (singleton)
-static ld2450_state_t s_ld2450_state = {0};
+// Default driver instance used by the handle-less API
+static ld2450_state_t *s_default_instance = NULL;
+
+/**
+ * @brief Shared processing task servicing several instances from one stack
+ */
+static struct {
+    /** @brief Shared task handle (NULL when not running) */
+    TaskHandle_t task_handle;
+    /** @brief Queue set over the UART event queues of all member instances */
+    QueueSetHandle_t queue_set;
+    /** @brief Control queue used to wake the task for membership changes */
+    QueueHandle_t ctrl_queue;
+    /** @brief Protects the member table, the queue set and task_handle */
+    SemaphoreHandle_t lock;
+    /** @brief Serializes attach and detach, so no instance joins while the task is exiting */
+    SemaphoreHandle_t membership;
+    /** @brief Given by the task as it exits */
+    SemaphoreHandle_t exited;
+    /** @brief Instances serviced by the shared task */
+    ld2450_state_t *members[LD2450_MAX_INSTANCES];
+    /** @brief Number of member instances */
+    size_t count;
+    /** @brief Read buffer shared by all members (only the shared task touches it) */
+    uint8_t rx_buffer[LD2450_UART_RX_BUF_SIZE];
+} s_shared = {0};
 
 /**
  * @brief Get driver instance
  * 
- * @return Pointer to driver state structure
+ * @return Pointer to the default driver state structure (NULL if not initialized)
  */
 ld2450_state_t *ld2450_get_instance(void)
 {
-    return &s_ld2450_state;
+    return s_default_instance;
 }
 
 /**
- * @brief Initialize the LD2450 radar driver
+ * @brief Resolve a public handle to a driver instance
+ * 
+ * @param handle Driver handle, or NULL for the default instance
+ * @return Pointer to driver state structure, NULL if not available
+ */
+ld2450_state_t *ld2450_resolve_handle(ld2450_handle_t handle)
+{
+    return handle ? handle : s_default_instance;
+}
+
+/**
+ * @brief Create a module-wide mutex on first use, once even under concurrent callers
+ * 
+ * Racing callers may each create a mutex; only the first one published is kept.
+ * 
+ * @param slot Where the mutex is published
+ * @return SemaphoreHandle_t The mutex, NULL if it could not be created
+ */
+SemaphoreHandle_t ld2450_mutex_once(SemaphoreHandle_t *slot)
+{
+    static portMUX_TYPE publish_lock = portMUX_INITIALIZER_UNLOCKED;
+    SemaphoreHandle_t mutex;
+    
+    portENTER_CRITICAL(&publish_lock);
+    mutex = *slot;
+    portEXIT_CRITICAL(&publish_lock);
+    if (mutex) {
+        return mutex;
+    }
+    
+    SemaphoreHandle_t created = xSemaphoreCreateMutex();
+    if (!created) {
+        return NULL;
+    }
+    
+    portENTER_CRITICAL(&publish_lock);
+    if (!*slot) {
+        *slot = created;
+        created = NULL;
+    }
+    mutex = *slot;
+    portEXIT_CRITICAL(&publish_lock);
+    
+    if (created) {
+        vSemaphoreDelete(created);
+    }
+    return mutex;
+}
+
+/**
+ * @brief Get the handle of the instance created by ld2450_init()
+ * 
+ * @return ld2450_handle_t Default handle, NULL if ld2450_init() has not been called
+ */
+ld2450_handle_t ld2450_get_default_handle(void)
+{
+    return s_default_instance;
+}
+
+/**
+ * @brief Service a single UART event for an instance
+ * 
+ * @param instance Driver instance
+ * @param event UART event received from the instance's event queue
+ * @param buffer Scratch read buffer (LD2450_UART_RX_BUF_SIZE bytes)
+ */
+static void ld2450_service_uart_event(ld2450_state_t *instance, const uart_event_t *event,
+                                      uint8_t *buffer)
+{
+    // The UHCI backend's chunks are already in memory
+    if (event->type == LD2450_UART_EVENT_DMA) {
+        ld2450_uhci_service(instance, false);
+        return;
+    }
+    
+    switch (event->type) {
+        case UART_DATA:
+        {
+#if LD2450_ENABLE_STATS
+            // Depth including the event just taken off the queue
+            uint32_t depth = uxQueueMessagesWaiting(instance->uart_queue) + 1;
+            portENTER_CRITICAL(&instance->stats_lock);
+            if (depth > instance->stats.uart_queue_peak) {
+                instance->stats.uart_queue_peak = depth;
+            }
+            portEXIT_CRITICAL(&instance->stats_lock);
+#endif
+            // Stamp the chunk as soon as the event is dequeued; the parser back-dates
+            // each header from here using its byte position and the wire time per byte
+            instance->chunk_timestamp_us = esp_timer_get_time();
+            
+            // While capturing, read straight into the capture ring and parse from there
+            size_t want = MIN(event->size, LD2450_UART_RX_BUF_SIZE);
+            uint8_t *capture = NULL;
+            if (instance->capture && !instance->replay_running) {
+                atomic_store(&instance->capture_busy, true);
+                capture = ld2450_capture_reserve(instance, want);
+                if (!capture) {
+                    atomic_store(&instance->capture_busy, false);
+                }
+            }
+            
+            // Read data from UART
+            int len = uart_read_bytes(instance->uart_port, capture ? capture : buffer, want,
+                                      pdMS_TO_TICKS(10));
+            
+            if (capture) {
+                ld2450_capture_commit(instance, instance->chunk_timestamp_us, len > 0 ? (size_t)len : 0);
+                atomic_store(&instance->capture_busy, false);
+            }
+            
+            if (len > 0) {
+                // Process the received data using optimized handler
+                ld2450_uart_event_handler(instance, capture ? capture : buffer, len);
+            }
+            break;
+        }
+        case UART_FIFO_OVF:
+            LD2450_STATS_INC(instance, uart_fifo_overflows);
+            LD2450_TRACE(instance, LD2450_TRACE_UART_OVERFLOW, 0, 0, 0);
+            uart_flush_input(instance->uart_port);
+            xQueueReset(instance->uart_queue);
+            if (instance->event_loop) {
+                ld2450_event_sync_lost(instance, LD2450_SYNC_LOST_UART_OVERFLOW);
+            }
+            break;
+        case UART_BUFFER_FULL:
+            LD2450_STATS_INC(instance, uart_buffer_full);
+            LD2450_TRACE(instance, LD2450_TRACE_UART_OVERFLOW, 1, 0, 0);
+            uart_flush_input(instance->uart_port);
+            xQueueReset(instance->uart_queue);
+            if (instance->event_loop) {
+                ld2450_event_sync_lost(instance, LD2450_SYNC_LOST_UART_OVERFLOW);
+            }
+            break;
+        case UART_BREAK:
+        case UART_FRAME_ERR:
+        case UART_PARITY_ERR:
+        case UART_DATA_BREAK:
+        case UART_PATTERN_DET:
+            // Log and ignore these events
+            ESP_LOGD(TAG, "UART event: %d", event->type);
+            break;
+        default:
+            // Includes LD2450_UART_EVENT_WAKE: loop around and re-check state
+            ESP_LOGV(TAG, "Unhandled UART event: %d", event->type);
+            break;
+    }
+}
+
+/**
+ * @brief Create a processing task with the placement and stack of a configuration
+ * 
+ * @param body Task body
+ * @param name Task name
+ * @param arg Task argument
+ * @param priority Task priority
+ * @param config Driver configuration
+ * @param memory Caller-provided task memory (NULL to allocate from the heap)
+ * @param handle Pointer to store the task handle
+ */
+static void ld2450_task_create(TaskFunction_t body, const char *name, void *arg, int priority,
+                               const ld2450_config_t *config, const ld2450_task_memory_t *memory,
+                               TaskHandle_t *handle)
+{
+    uint32_t stack_size = config->task_stack_size ? config->task_stack_size : LD2450_TASK_STACK_SIZE;
+    BaseType_t core = config->task_pinned ? (BaseType_t)config->task_core_id : tskNO_AFFINITY;
+    
+    if (memory && memory->tcb && memory->stack) {
+        *handle = xTaskCreateStaticPinnedToCore(body, name, stack_size, arg, priority,
+                                                memory->stack, memory->tcb, core);
+    } else {
+        xTaskCreatePinnedToCore(body, name, stack_size, arg, priority, handle, core);
+    }
+}
+
+/**
+ * @brief Delete the shared task's queue set and control queue
+ * 
+ * Called with s_shared.lock held once no member queue is left in the set.
+ */
+static void ld2450_shared_teardown(void)
+{
+    if (s_shared.ctrl_queue) {
+        // A queue must be empty to leave its set
+        xQueueReset(s_shared.ctrl_queue);
+        xQueueRemoveFromSet(s_shared.ctrl_queue, s_shared.queue_set);
+        vQueueDelete(s_shared.ctrl_queue);
+        s_shared.ctrl_queue = NULL;
+    }
+    if (s_shared.queue_set) {
+        vQueueDelete(s_shared.queue_set);
+        s_shared.queue_set = NULL;
+    }
+}
+
+/**
+ * @brief Shared processing task body
+ * 
+ * Waits on a queue set covering every member's UART event queue, so a single
+ * task (and a single stack) drains all radars that opted into shared servicing.
+ * Member callbacks run with s_shared.lock held, so they must not create or
+ * delete shared-task instances; ld2450_create() and ld2450_delete() refuse to.
+ * 
+ * @param arg Task argument (not used)
+ */
+static void ld2450_shared_task(void *arg)
+{
+    (void)arg;
+    
+    ESP_LOGI(TAG, "LD2450 shared processing task started");
+    
+    while (true) {
+        // Sleep until an event arrives or the earliest member command deadline
+        TickType_t wait = portMAX_DELAY;
+        xSemaphoreTake(s_shared.lock, portMAX_DELAY);
+        for (size_t i = 0; i < s_shared.count; i++) {
+            wait = MIN(wait, ld2450_command_wait_ticks(s_shared.members[i]));
+            wait = MIN(wait, ld2450_replay_wait_ticks(s_shared.members[i]));
+            wait = MIN(wait, ld2450_power_wait_ticks(s_shared.members[i]));
+            wait = MIN(wait, ld2450_health_wait_ticks(s_shared.members[i]));
+            wait = MIN(wait, ld2450_batch_wait_ticks(s_shared.members[i]));
+        }
+        xSemaphoreGive(s_shared.lock);
+        
+        QueueSetMemberHandle_t member = xQueueSelectFromSet(s_shared.queue_set, wait);
+        
+        if (member == s_shared.ctrl_queue) {
+            uint8_t dummy;
+            xQueueReceive(s_shared.ctrl_queue, &dummy, 0);
+        }
+        
+        xSemaphoreTake(s_shared.lock, portMAX_DELAY);
+        
+        if (s_shared.count == 0) {
+            // Under the lock: no attach may see a task handle whose set is going away
+            ld2450_shared_teardown();
+            s_shared.task_handle = NULL;
+            xSemaphoreGive(s_shared.lock);
+            break;
+        }
+        
+        for (size_t i = 0; i < s_shared.count; i++) {
+            ld2450_state_t *instance = s_shared.members[i];
+            
+            if (member == instance->uart_queue) {
+                uart_event_t event;
+                if (xQueueReceive(instance->uart_queue, &event, 0) == pdTRUE) {
+                    ld2450_service_uart_event(instance, &event, s_shared.rx_buffer);
+                }
+            }
+            
+            ld2450_replay_poll(instance);
+            ld2450_command_poll(instance);
+            ld2450_power_poll(instance);
+            ld2450_health_poll(instance);
+            ld2450_batch_poll(instance);
+            ld2450_stats_poll(instance);
+        }
+        
+        xSemaphoreGive(s_shared.lock);
+    }
+    
+    ESP_LOGI(TAG, "LD2450 shared processing task stopped");
+    xSemaphoreGive(s_shared.exited);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Check whether the caller is the shared processing task
+ * 
+ * @return true when called from a member's callback
+ */
+static bool ld2450_in_shared_task(void)
+{
+    TaskHandle_t task = s_shared.task_handle;
+    
+    return task && xTaskGetCurrentTaskHandle() == task;
+}
+
+/**
+ * @brief Join the shared task's queue set and member table, starting the task if needed
+ * 
+ * Called with both s_shared mutexes held.
+ */
+static esp_err_t ld2450_shared_join(ld2450_state_t *instance, const ld2450_config_t *config)
+{
+    if (s_shared.count >= LD2450_MAX_INSTANCES) {
+        return ESP_ERR_NO_MEM;
+    }
+    
+    if (!s_shared.task_handle) {
+        s_shared.queue_set = xQueueCreateSet(LD2450_MAX_INSTANCES * LD2450_UART_EVENT_QUEUE_SIZE + 1);
+        s_shared.ctrl_queue = xQueueCreate(1, sizeof(uint8_t));
+        if (!s_shared.queue_set || !s_shared.ctrl_queue ||
+            xQueueAddToSet(s_shared.ctrl_queue, s_shared.queue_set) != pdPASS) {
+            ESP_LOGE(TAG, "Failed to create shared task queue set");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    
+    // A member queue must be empty when it joins the set
+    xQueueReset(instance->uart_queue);
+    if (xQueueAddToSet(instance->uart_queue, s_shared.queue_set) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to add UART%d to shared task", (int)instance->uart_port);
+        return ESP_FAIL;
+    }
+    
+    s_shared.members[s_shared.count++] = instance;
+    
+    if (!s_shared.task_handle) {
+        ld2450_task_create(ld2450_shared_task, "ld2450_shared", NULL, config->task_priority,
+                           config, NULL, &s_shared.task_handle);
+        if (!s_shared.task_handle) {
+            ESP_LOGE(TAG, "Failed to create shared processing task");
+            s_shared.count--;
+            xQueueRemoveFromSet(instance->uart_queue, s_shared.queue_set);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    
+    return ESP_OK;
+}
+
+/**
+ * @brief Add an instance to the shared processing task, starting it if needed
+ * 
+ * The shared task may outlive the instance that started it, so it always
+ * allocates its memory from the heap.
+ * 
+ * @param instance Driver instance
+ * @param config Configuration whose task priority, placement and stack are used
+ *               if the shared task has to be created
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_STATE from a shared-task
+ *         callback, error code otherwise
+ */
+static esp_err_t ld2450_shared_attach(ld2450_state_t *instance, const ld2450_config_t *config)
+{
+    if (ld2450_in_shared_task()) {
+        ESP_LOGE(TAG, "Shared-task instances cannot be created from a shared-task callback");
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    if (!ld2450_mutex_once(&s_shared.membership)) {
+        return ESP_ERR_NO_MEM;
+    }
+    
+    xSemaphoreTake(s_shared.membership, portMAX_DELAY);
+    
+    // Created under the membership mutex, so only once
+    if (!s_shared.lock) {
+        s_shared.lock = xSemaphoreCreateMutex();
+    }
+    if (!s_shared.exited) {
+        s_shared.exited = xSemaphoreCreateBinary();
+    }
+    if (!s_shared.lock || !s_shared.exited) {
+        xSemaphoreGive(s_shared.membership);
+        return ESP_ERR_NO_MEM;
+    }
+    
+    xSemaphoreTake(s_shared.lock, portMAX_DELAY);
+    esp_err_t ret = ld2450_shared_join(instance, config);
+    // A set without a task to drain it is not kept around
+    if (!s_shared.task_handle) {
+        ld2450_shared_teardown();
+    }
+    xSemaphoreGive(s_shared.lock);
+    
+    xSemaphoreGive(s_shared.membership);
+    return ret;
+}
+
+/**
+ * @brief Remove an instance from the shared processing task
+ * 
+ * When the last member leaves, returns once the shared task has exited.
+ * 
+ * @param instance Driver instance
+ */
+static void ld2450_shared_detach(ld2450_state_t *instance)
+{
+    if (!s_shared.membership) {
+        return;
+    }
+    
+    xSemaphoreTake(s_shared.membership, portMAX_DELAY);
+    xSemaphoreTake(s_shared.lock, portMAX_DELAY);
+    
+    bool member = false;
+    for (size_t i = 0; i < s_shared.count; i++) {
+        if (s_shared.members[i] == instance) {
+            s_shared.members[i] = s_shared.members[--s_shared.count];
+            member = true;
+            break;
+        }
+    }
+    
+    // Stale set entries for this queue are ignored by the task once it is no longer a member
+    if (member) {
+        xQueueReset(instance->uart_queue);
+        xQueueRemoveFromSet(instance->uart_queue, s_shared.queue_set);
+    }
+    
+    bool last_member = member && s_shared.count == 0;
+    uint8_t wake = 0;
+    if (last_member) {
+        xQueueSend(s_shared.ctrl_queue, &wake, 0);
+    }
+    
+    xSemaphoreGive(s_shared.lock);
+    
+    // Holding the membership mutex keeps attach from reviving the exiting task
+    if (last_member) {
+        xSemaphoreTake(s_shared.exited, portMAX_DELAY);
+    }
+    
+    xSemaphoreGive(s_shared.membership);
+}
+
+/**
+ * @brief Release the resources owned by a (possibly partially created) instance
+ * 
+ * @param instance Driver instance
+ * @param uart_installed Whether the UART driver has been installed
+ */
+static void ld2450_free_instance(ld2450_state_t *instance, bool uart_installed)
+{
+    ld2450_uhci_deinit(instance);
+    ld2450_power_deinit(instance);
+    ld2450_health_deinit(instance);
+    ld2450_heatmap_deinit(instance);
+    ld2450_batch_deinit(instance);
+    if (instance->fusion_source) {
+        ld2450_fusion_remove_radar(instance);
+    }
+    if (uart_installed) {
+        uart_driver_delete(instance->uart_port);
+    }
+    ld2450_ring_deinit(instance);
+    ld2450_command_deinit(instance);
+    free(instance->zones);
+    ld2450_subscriber_deinit(instance);
+    ld2450_event_deinit(instance);
+    ld2450_capture_deinit(instance);
+    if (instance->mutex) {
+        vSemaphoreDelete(instance->mutex);
+    }
+    free(instance);
+}
+
+/**
+ * @brief Create an LD2450 driver instance
  * 
  * @param config Pointer to driver configuration structure
+ * @param ret_handle Pointer to store the created handle
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
-esp_err_t ld2450_init(const ld2450_config_t *config)
+esp_err_t ld2450_create(const ld2450_config_t *config, ld2450_handle_t *ret_handle)
 {
-    ld2450_state_t *instance = ld2450_get_instance();
     esp_err_t ret = ESP_OK;
     
-    if (!config) {
+    if (!config || !ret_handle) {
         return ESP_ERR_INVALID_ARG;
     }
     
-    if (instance->initialized) {
-        ESP_LOGW(TAG, "LD2450 driver already initialized");
-        return ESP_ERR_INVALID_STATE;
+    if (config->task_pinned && config->task_core_id >= portNUM_PROCESSORS) {
+        ESP_LOGE(TAG, "Invalid task core %u", config->task_core_id);
+        return ESP_ERR_INVALID_ARG;
     }
     
-    // Zero out the state structure
-    memset(instance, 0, sizeof(ld2450_state_t));
+    // The DMA backend, low-power timers, stream watchdog and batch deadline are run by the processing task only
+    if ((config->uart_rx_dma || config->power.enabled || config->health.enabled || config->batch.max_frames) &&
+        !config->auto_processing) {
+        ESP_LOGE(TAG, "uart_rx_dma, power, health and batch need auto_processing");
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    // Every member of the shared task's queue set must fit in the set
+    uint8_t event_queue_size = config->uart_event_queue_size ? config->uart_event_queue_size :
+                               LD2450_UART_EVENT_QUEUE_SIZE;
+    if (config->auto_processing && config->shared_task && event_queue_size > LD2450_UART_EVENT_QUEUE_SIZE) {
+        ESP_LOGW(TAG, "UART event queue limited to %d with the shared task", LD2450_UART_EVENT_QUEUE_SIZE);
+        event_queue_size = LD2450_UART_EVENT_QUEUE_SIZE;
+    }
+    
+    // Allocate zeroed state; each instance owns its own buffers
+    ld2450_state_t *instance = calloc(1, sizeof(ld2450_state_t));
+    if (!instance) {
+        ESP_LOGE(TAG, "Failed to allocate driver instance");
+        return ESP_ERR_NO_MEM;
+    }
     
     // Store configuration
     instance->uart_port = config->uart_port;
@@ -65,13 +563,51 @@ esp_err_t ld2450_init(const ld2450_config_t *config)
     instance->tx_pin = config->uart_tx_pin;
     instance->baud_rate = config->uart_baud_rate;
     instance->auto_processing = config->auto_processing;
+    instance->shared_task = config->auto_processing && config->shared_task;
+    instance->derived_mode = config->derived_mode;
+    instance->delivery = config->delivery;
+    portMUX_INITIALIZE(&instance->delivery_lock);
+    portMUX_INITIALIZE(&instance->replay_lock);
+    portMUX_INITIALIZE(&instance->stats_lock);
+    ld2450_cache_init(instance, config->nvs_namespace);
+    ld2450_tracker_init(instance, &config->tracker);
+    instance->byte_time_ns = config->uart_baud_rate ? 10000000000ULL / config->uart_baud_rate : 0;
+#if LD2450_ENABLE_STATS
+    instance->stats.since_us = esp_timer_get_time();
+#endif
+#if LD2450_ENABLE_TRACE
+    instance->trace_logged_us = esp_timer_get_time();
+#endif
     
     // Create mutex for thread safety
-    instance->mutex = xSemaphoreCreateMutex();
+    instance->mutex = xSemaphoreCreateMutexStatic(&instance->mutex_buffer);
     if (!instance->mutex) {
         ESP_LOGE(TAG, "Failed to create mutex");
+        ld2450_free_instance(instance, false);
         return ESP_ERR_NO_MEM;
     }
+    instance->task_exited = xSemaphoreCreateBinaryStatic(&instance->task_exited_buffer);
+    
+    // Create the queue through which the processing task runs configuration commands
+    ret = ld2450_command_init(instance);
+    if (ret != ESP_OK) {
+        ld2450_free_instance(instance, false);
+        return ret;
+    }
+    
+    // Allocate the parsed-frame ring for the pull API
+    ret = ld2450_ring_init(instance, config->frame_ring_depth, config->frame_ring_compact);
+    if (ret != ESP_OK) {
+        ld2450_free_instance(instance, false);
+        return ret;
+    }
+    
+    // Create or attach the event loop before any frame can arrive
+    ret = ld2450_event_init(instance, &config->events);
+    if (ret != ESP_OK) {
+        ld2450_free_instance(instance, false);
+        return ret;
+    }
     
     // Configure UART
     uart_config_t uart_config = {
@@ -84,11 +620,12 @@ esp_err_t ld2450_init(const ld2450_config_t *config)
     };
     
     // Install UART driver
-    ret = uart_driver_install(config->uart_port, LD2450_UART_RX_BUF_SIZE * 2, 
-                              0, 20, &instance->uart_queue, 0);
+    ret = uart_driver_install(config->uart_port,
+                              config->uart_rx_buffer_size ? config->uart_rx_buffer_size : LD2450_UART_RX_RING_SIZE,
+                              0, event_queue_size, &instance->uart_queue, 0);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to install UART driver: %s", esp_err_to_name(ret));
-        vSemaphoreDelete(instance->mutex);
+        ld2450_free_instance(instance, false);
         return ret;
     }
     
@@ -96,8 +633,7 @@ esp_err_t ld2450_init(const ld2450_config_t *config)
     ret = uart_param_config(config->uart_port, &uart_config);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to configure UART parameters: %s", esp_err_to_name(ret));
-        uart_driver_delete(config->uart_port);
-        vSemaphoreDelete(instance->mutex);
+        ld2450_free_instance(instance, true);
         return ret;
     }
     
@@ -106,8 +642,61 @@ esp_err_t ld2450_init(const ld2450_config_t *config)
                        UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to set UART pins: %s", esp_err_to_name(ret));
-        uart_driver_delete(config->uart_port);
-        vSemaphoreDelete(instance->mutex);
+        ld2450_free_instance(instance, true);
+        return ret;
+    }
+    
+    // Optional RX event tuning: a short timeout raises UART_DATA soon after a frame ends
+    if (config->uart_rx_timeout > 0) {
+        ret = uart_set_rx_timeout(config->uart_port, config->uart_rx_timeout);
+        if (ret != ESP_OK) {
+            ESP_LOGW(TAG, "Failed to set UART RX timeout: %s", esp_err_to_name(ret));
+        }
+    }
+    if (config->uart_rx_full_threshold > 0) {
+        ret = uart_set_rx_full_threshold(config->uart_port, config->uart_rx_full_threshold);
+        if (ret != ESP_OK) {
+            ESP_LOGW(TAG, "Failed to set UART RX full threshold: %s", esp_err_to_name(ret));
+        }
+    }
+    
+    // Hand RX over to UHCI/GDMA before any data can reach the UART driver's buffer
+    if (config->uart_rx_dma) {
+        ret = ld2450_uhci_init(instance);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to start DMA reception: %s", esp_err_to_name(ret));
+            ld2450_free_instance(instance, true);
+            return ret;
+        }
+    }
+    
+    // Hold the PM lock only while frames stream, waking on UART activity
+    ret = ld2450_power_init(instance, &config->power);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set up low-power operation: %s", esp_err_to_name(ret));
+        ld2450_free_instance(instance, true);
+        return ret;
+    }
+    
+    ret = ld2450_heatmap_init(instance, &config->heatmap);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set up the heatmap: %s", esp_err_to_name(ret));
+        ld2450_free_instance(instance, true);
+        return ret;
+    }
+    
+    ret = ld2450_batch_init(instance, &config->batch);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set up batched delivery: %s", esp_err_to_name(ret));
+        ld2450_free_instance(instance, true);
+        return ret;
+    }
+    
+    // Recover a stalled stream without blocking callers
+    ret = ld2450_health_init(instance, &config->health);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set up the stream watchdog: %s", esp_err_to_name(ret));
+        ld2450_free_instance(instance, true);
         return ret;
     }
     
@@ -120,75 +709,108 @@ esp_err_t ld2450_init(const ld2450_config_t *config)
     instance->frame_synced = false;
     instance->in_config_mode = false;
     
-    // Initialize header pattern for fast detection
-    static frame_header_t header_pattern;
-    memcpy(header_pattern.bytes, LD2450_DATA_FRAME_HEADER, 4);
-    
     // Set initialized flag
     instance->initialized = true;
     
     ESP_LOGI(TAG, "LD2450 driver initialized on UART%" PRIu32 " (RX: GPIO%" PRIu32 ", TX: GPIO%" PRIu32 ", baud: %" PRIu32 ")",  
         (uint32_t)instance->uart_port, (uint32_t)instance->rx_pin, (uint32_t)instance->tx_pin, instance->baud_rate);
     
-    // Start processing task if auto-processing is enabled
-    if (config->auto_processing) {
-        xTaskCreate(ld2450_processing_task, "ld2450_task", LD2450_TASK_STACK_SIZE,
-                    NULL, config->task_priority, &instance->task_handle);
-                    
+    // Start processing if auto-processing is enabled
+    if (instance->shared_task) {
+        ret = ld2450_shared_attach(instance, config);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to attach to shared processing task");
+            instance->initialized = false;
+            ld2450_free_instance(instance, true);
+            return ret;
+        }
+        
+        ESP_LOGI(TAG, "Auto-processing enabled on shared task");
+    } else if (config->auto_processing) {
+        char task_name[16];
+        snprintf(task_name, sizeof(task_name), "ld2450_%d", (int)config->uart_port);
+        
+        ld2450_task_create(ld2450_processing_task, task_name, instance, config->task_priority,
+                           config, &config->task_memory, &instance->task_handle);
+        
         if (!instance->task_handle) {
             ESP_LOGE(TAG, "Failed to create processing task");
-            ld2450_deinit();
+            instance->initialized = false;
+            ld2450_free_instance(instance, true);
             return ESP_ERR_NO_MEM;
         }
         
         ESP_LOGI(TAG, "Auto-processing enabled with task priority %d", config->task_priority);
     }
     
+    // Find the module if it is not at the configured rate; not fatal if it is absent
+    if (config->uart_auto_baud) {
+        ret = ld2450_detect_baud_rate(instance, NULL);
+        if (ret != ESP_OK) {
+            ESP_LOGW(TAG, "Baud rate detection failed (%s), staying at %" PRIu32 " baud",
+                     esp_err_to_name(ret), instance->baud_rate);
+        }
+    }
+    
+    *ret_handle = instance;
     return ESP_OK;
 }
 
 /**
- * @brief Deinitialize the LD2450 radar driver and release resources
+ * @brief Delete an LD2450 driver instance and release its resources
  * 
+ * @param handle Driver handle
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
-esp_err_t ld2450_deinit(void)
+esp_err_t ld2450_delete(ld2450_handle_t handle)
 {
-    ld2450_state_t *instance = ld2450_get_instance();
+    ld2450_state_t *instance = handle;
     
-    if (!instance->initialized) {
+    if (!instance || !instance->initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    // The shared task would wait for itself to let go of its member table
+    if (instance->shared_task && ld2450_in_shared_task()) {
+        ESP_LOGE(TAG, "Shared-task instances cannot be deleted from a shared-task callback");
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    // The processing task would wait for itself to exit
+    if (!instance->shared_task && instance->task_handle &&
+        xTaskGetCurrentTaskHandle() == instance->task_handle) {
+        ESP_LOGE(TAG, "An instance cannot be deleted from its own callback");
         return ESP_ERR_INVALID_STATE;
     }
     
     // Make sure we exit configuration mode if active
     if (instance->in_config_mode) {
-        ld2450_exit_config_mode();
+        ld2450_exit_config_mode(instance);
     }
     
-    // Delete task if it was created
-    if (instance->task_handle) {
+    if (instance->shared_task) {
+        ld2450_shared_detach(instance);
+        instance->initialized = false;
+    } else if (instance->task_handle) {
+        // Delete task if it was created
         instance->initialized = false;  // Signal task to exit
-        vTaskDelay(pdMS_TO_TICKS(100)); // Give task time to exit
         
-        // If task still running, delete it
-        if (eTaskGetState(instance->task_handle) != eDeleted) {
-            vTaskDelete(instance->task_handle);
-        }
+        // Wake the task wherever it is blocked so it can observe the flag
+        uart_event_t wake = { .type = LD2450_UART_EVENT_WAKE };
+        xQueueSendToFront(instance->uart_queue, &wake, 0);
         
+        // Never kill it: it may be in a callback, holding locks other instances share
+        xSemaphoreTake(instance->task_exited, portMAX_DELAY);
         instance->task_handle = NULL;
     }
     
-    // Delete UART driver
-    uart_driver_delete(instance->uart_port);
+    instance->initialized = false;
     
-    // Delete mutex
-    if (instance->mutex) {
-        vSemaphoreDelete(instance->mutex);
-        instance->mutex = NULL;
+    if (instance == s_default_instance) {
+        s_default_instance = NULL;
     }
     
-    // Reset state
-    memset(instance, 0, sizeof(ld2450_state_t));
+    ld2450_free_instance(instance, true);
     
     ESP_LOGI(TAG, "LD2450 driver deinitialized");
     
@@ -196,17 +818,55 @@ esp_err_t ld2450_deinit(void)
 }
 
 /**
- * @brief Register a callback function for target data
+ * @brief Initialize the LD2450 radar driver
+ * 
+ * Creates the default instance used by the handle-less API.
+ * 
+ * @param config Pointer to driver configuration structure
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_init(const ld2450_config_t *config)
+{
+    if (!config) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    if (s_default_instance) {
+        ESP_LOGW(TAG, "LD2450 driver already initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    return ld2450_create(config, &s_default_instance);
+}
+
+/**
+ * @brief Deinitialize the LD2450 radar driver and release resources
+ * 
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_deinit(void)
+{
+    if (!s_default_instance) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    return ld2450_delete(s_default_instance);
+}
+
+/**
+ * @brief Register a callback function for target data on an instance
  * 
+ * @param handle Driver handle (NULL for the default instance)
  * @param callback Function pointer to call when new target data is available
  * @param user_ctx User context pointer passed to the callback function
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
-esp_err_t ld2450_register_target_callback(ld2450_target_cb_t callback, void *user_ctx)
+esp_err_t ld2450_dev_register_target_callback(ld2450_handle_t handle, ld2450_target_cb_t callback,
+                                              void *user_ctx)
 {
-    ld2450_state_t *instance = ld2450_get_instance();
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
     
-    if (!instance->initialized) {
+    if (!instance || !instance->initialized) {
         return ESP_ERR_INVALID_STATE;
     }
     
@@ -222,6 +882,18 @@ esp_err_t ld2450_register_target_callback(ld2450_target_cb_t callback, void *use
     return ESP_FAIL;
 }
 
+/**
+ * @brief Register a callback function for target data
+ * 
+ * @param callback Function pointer to call when new target data is available
+ * @param user_ctx User context pointer passed to the callback function
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_register_target_callback(ld2450_target_cb_t callback, void *user_ctx)
+{
+    return ld2450_dev_register_target_callback(NULL, callback, user_ctx);
+}
+
 /**
  * @brief Process a radar data frame manually
  * 
@@ -231,6 +903,21 @@ esp_err_t ld2450_register_target_callback(ld2450_target_cb_t callback, void *use
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
 esp_err_t ld2450_process_frame(const uint8_t *data, size_t length, ld2450_frame_t *frame)
+{
+    return ld2450_process_frame_with_mode(data, length, LD2450_DERIVED_FLOAT, frame);
+}
+
+/**
+ * @brief Process a radar data frame manually with an explicit derived-field mode
+ * 
+ * @param data Raw frame data buffer
+ * @param length Length of the data buffer in bytes
+ * @param mode How distance and angle are computed
+ * @param frame Pointer to frame structure to store parsed results
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_process_frame_with_mode(const uint8_t *data, size_t length,
+                                         ld2450_derived_mode_t mode, ld2450_frame_t *frame)
 {
     if (!data || !frame) {
         return ESP_ERR_INVALID_ARG;
@@ -241,104 +928,129 @@ esp_err_t ld2450_process_frame(const uint8_t *data, size_t length, ld2450_frame_
         return ESP_ERR_INVALID_SIZE;
     }
     
-    return ld2450_parse_frame(data, length, frame);
+    return ld2450_parse_frame(data, length, mode, frame);
+}
+
+/**
+ * @brief Parse every data frame in a buffer
+ * 
+ * @param data Raw bytes, possibly with noise and ACK frames between data frames
+ * @param length Length of the data buffer in bytes
+ * @param mode How distance and angle are computed
+ * @param frames Array to store the parsed frames
+ * @param max_frames Capacity of frames
+ * @param count Pointer to store the number of frames parsed
+ * @param consumed Pointer to store the number of bytes scanned (may be NULL)
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_parse_frames(const uint8_t *data, size_t length, ld2450_derived_mode_t mode,
+                              ld2450_frame_t *frames, size_t max_frames, size_t *count, size_t *consumed)
+{
+    size_t pos = 0;
+    size_t n = 0;
+    
+    if (!data || !frames || !count) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    while (n < max_frames && length - pos >= LD2450_DATA_FRAME_SIZE) {
+        // Only the first header byte is searched for; parse_frame checks the rest and the footer
+        const uint8_t *start = memchr(data + pos, LD2450_DATA_FRAME_HEADER[0],
+                                      length - LD2450_DATA_FRAME_SIZE + 1 - pos);
+        if (!start) {
+            pos = length - LD2450_DATA_FRAME_SIZE + 1;
+            break;
+        }
+        pos = (size_t)(start - data);
+        
+        if (ld2450_parse_frame(data + pos, LD2450_DATA_FRAME_SIZE, mode, &frames[n]) == ESP_OK) {
+            n++;
+            pos += LD2450_DATA_FRAME_SIZE;
+        } else {
+            pos++;
+        }
+    }
+    
+    // Leave a frame cut off at the end of the buffer for the next call
+    if (n < max_frames) {
+        while (pos < length &&
+               memcmp(data + pos, LD2450_DATA_FRAME_HEADER, MIN(length - pos, sizeof(LD2450_DATA_FRAME_HEADER))) != 0) {
+            pos++;
+        }
+    }
+    
+    *count = n;
+    if (consumed) {
+        *consumed = pos;
+    }
+    
+    return ESP_OK;
+}
+
+/**
+ * @brief Check whether commands for an instance go through its processing task
+ * 
+ * @param instance Driver instance
+ * @return true if commands must be queued to the processing task
+ */
+bool ld2450_command_via_task(const ld2450_state_t *instance)
+{
+    TaskHandle_t rx_task = instance->shared_task ? s_shared.task_handle : instance->task_handle;
+    
+    return rx_task && xTaskGetCurrentTaskHandle() != rx_task;
 }
 
 /**
  * @brief Processing task for radar data
  * 
- * This task continuously processes UART events to handle incoming radar data.
+ * This task blocks on the UART event queue and processes data as soon as the
+ * UART driver reports it, so frame latency is bounded by the UART RX timeout
+ * rather than by a polling interval. It also runs the command engine, waking
+ * early when a queued command's ACK deadline expires, feeds a running replay
+ * when its next chunk is due and runs the low-power and stream watchdog timers.
+ * With nothing of the kind pending it does not wake up at all.
  * 
- * @param arg Task argument (not used)
+ * @param arg Driver instance serviced by this task
  */
 void ld2450_processing_task(void *arg)
 {
-    ld2450_state_t *instance = ld2450_get_instance();
+    ld2450_state_t *instance = (ld2450_state_t *)arg;
     
     if (!instance || !instance->initialized) {
         vTaskDelete(NULL);
         return;
     }
     
-    ESP_LOGI(TAG, "LD2450 processing task started");
-    
-    // Initialize for adaptive delay
-    instance->idle_count = 0;
-    static uint8_t data_buffer[LD2450_UART_RX_BUF_SIZE];
+    ESP_LOGI(TAG, "LD2450 processing task started on UART%d", (int)instance->uart_port);
     
     while (instance->initialized) {
-        bool processed_data = false;
-        
-        // Skip processing if in configuration mode
-        if (instance->in_config_mode) {
-            // Give longer delay while in config mode to not interfere with config commands
-            vTaskDelay(pdMS_TO_TICKS(100));
-            continue;
-        }
-        
-        // Process UART events
+        // Block until the UART driver has something for us or a command times out
         uart_event_t event;
-        if (xQueueReceive(instance->uart_queue, &event, 0)) {
-            switch (event.type) {
-                case UART_DATA:
-                {
-                    // Read data from UART
-                    int len = uart_read_bytes(instance->uart_port, data_buffer, 
-                                             MIN(event.size, LD2450_UART_RX_BUF_SIZE),
-                                             pdMS_TO_TICKS(10));
-                    
-                    if (len > 0) {
-                        // Process the received data using optimized handler
-                        ld2450_uart_event_handler(data_buffer, len);
-                        processed_data = true;
-                    }
-                    break;
-                }
-                case UART_FIFO_OVF:
-                    ESP_LOGW(TAG, "UART FIFO overflow detected");
-                    uart_flush_input(instance->uart_port);
-                    xQueueReset(instance->uart_queue);
-                    break;
-                case UART_BUFFER_FULL:
-                    ESP_LOGW(TAG, "UART buffer full");
-                    uart_flush_input(instance->uart_port);
-                    xQueueReset(instance->uart_queue);
-                    break;
-                case UART_BREAK:
-                case UART_FRAME_ERR:
-                case UART_PARITY_ERR:
-                case UART_DATA_BREAK:
-                case UART_PATTERN_DET:
-                    // Log and ignore these events
-                    ESP_LOGD(TAG, "UART event: %d", event.type);
-                    break;
-                default:
-                    ESP_LOGD(TAG, "Unhandled UART event: %d", event.type);
-                    break;
-            }
+        TickType_t wait = MIN(ld2450_command_wait_ticks(instance), ld2450_replay_wait_ticks(instance));
+        wait = MIN(wait, ld2450_power_wait_ticks(instance));
+        wait = MIN(wait, ld2450_health_wait_ticks(instance));
+        wait = MIN(wait, ld2450_batch_wait_ticks(instance));
+        if (xQueueReceive(instance->uart_queue, &event, wait) == pdTRUE) {
+            ld2450_service_uart_event(instance, &event, instance->rx_buffer);
         }
         
-        // Adaptive delay based on activity
-        if (processed_data) {
-            instance->idle_count = 0;
-            // Yield immediately to process more data
-            taskYIELD();
-        } else {
-            instance->idle_count++;
-            // Adaptive delay based on activity (max 50ms)
-            uint32_t delay_ms = MIN(instance->idle_count, 10) * 5;
-            vTaskDelay(pdMS_TO_TICKS(delay_ms));
-        }
+        ld2450_replay_poll(instance);
+        ld2450_command_poll(instance);
+        ld2450_power_poll(instance);
+        ld2450_health_poll(instance);
+        ld2450_batch_poll(instance);
+        ld2450_stats_poll(instance);
     }
     
     ESP_LOGI(TAG, "LD2450 processing task stopped");
+    xSemaphoreGive(instance->task_exited);
     vTaskDelete(NULL);
 }
 
 /* 
  * The following functions are implemented in ld2450_config.c and are already declared
  * in ld2450.h. We don't need to re-implement them here, as they are accessible through
- * the public API header.
+ * the public API header. Each has an ld2450_dev_ counterpart taking a handle.
  * 
  * - ld2450_set_tracking_mode
  * - ld2450_get_tracking_mode
@@ -0,0 +1,224 @@
+/**
+ * @file ld2450_batch.c
+ * @brief Batched frame delivery
+ * 
+ * At 10 frames per second each delivered frame wakes whatever the target
+ * callback hands it to. With batching, the processing task copies delivered
+ * frames into a per-instance array and calls the batch callback once it holds
+ * max_frames of them, or once the oldest has waited max_latency_ms, so the
+ * consumer is woken once per batch instead of once per frame.
+ * 
+ * @author NieRVoid
+ * @date 2025-03-12
+ * @license MIT
+ */
+
+#include <stdlib.h>
+#include "ld2450.h"
+#include "ld2450_private.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+
+static const char *TAG = LD2450_LOG_TAG;
+
+/**
+ * @brief Batch state of an instance
+ */
+struct ld2450_batch {
+    uint8_t max_frames;
+    int64_t max_latency_us;
+    /** @brief Frames waiting for delivery */
+    uint8_t count;
+    /** @brief Time the first frame of the batch was added */
+    int64_t first_us;
+    ld2450_batch_cb_t callback;
+    void *user_ctx;
+    /** @brief Guards callback and user_ctx against ld2450_register_batch_callback() */
+    portMUX_TYPE lock;
+    ld2450_frame_t frames[];
+};
+
+/**
+ * @brief Allocate the batch buffer
+ * 
+ * @param instance Driver instance
+ * @param config Batch configuration
+ * @return esp_err_t ESP_OK on success (or if not enabled), error code otherwise
+ */
+esp_err_t ld2450_batch_init(ld2450_state_t *instance, const ld2450_batch_config_t *config)
+{
+    if (!config->max_frames) {
+        return ESP_OK;
+    }
+    
+    if (config->max_frames > LD2450_BATCH_MAX_FRAMES) {
+        ESP_LOGE(TAG, "Batch of %u frames exceeds %d", config->max_frames, LD2450_BATCH_MAX_FRAMES);
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    ld2450_batch_t *batch = calloc(1, sizeof(ld2450_batch_t) + config->max_frames * sizeof(ld2450_frame_t));
+    if (!batch) {
+        return ESP_ERR_NO_MEM;
+    }
+    
+    batch->max_frames = config->max_frames;
+    batch->max_latency_us = (int64_t)(config->max_latency_ms ? config->max_latency_ms :
+                                      LD2450_BATCH_LATENCY_MS) * 1000;
+    portMUX_INITIALIZE(&batch->lock);
+    instance->batch = batch;
+    
+    ESP_LOGI(TAG, "UART%d batching up to %u frames or %u ms", (int)instance->uart_port, batch->max_frames,
+             (unsigned)(batch->max_latency_us / 1000));
+    return ESP_OK;
+}
+
+/**
+ * @brief Release the batch buffer, discarding frames not delivered yet
+ * 
+ * @param instance Driver instance
+ */
+void ld2450_batch_deinit(ld2450_state_t *instance)
+{
+    ld2450_batch_t *batch = instance->batch;
+    
+    if (!batch) {
+        return;
+    }
+    
+    instance->batch = NULL;
+    free(batch);
+}
+
+/**
+ * @brief Hand the frames batched so far to the batch callback
+ */
+static void batch_flush(ld2450_state_t *instance, ld2450_batch_t *batch)
+{
+    portENTER_CRITICAL(&batch->lock);
+    ld2450_batch_cb_t callback = batch->callback;
+    void *user_ctx = batch->user_ctx;
+    portEXIT_CRITICAL(&batch->lock);
+    
+    size_t count = batch->count;
+    batch->count = 0;
+    
+    // Unregistered since the frames were added: nobody wants them
+    if (!callback) {
+        return;
+    }
+    
+#if LD2450_ENABLE_STATS || LD2450_ENABLE_TRACE
+    int64_t start_us = esp_timer_get_time();
+#endif
+    callback(batch->frames, count, user_ctx);
+#if LD2450_ENABLE_STATS || LD2450_ENABLE_TRACE
+    int64_t callback_us = esp_timer_get_time() - start_us;
+    LD2450_TRACE(instance, LD2450_TRACE_CALLBACK, 1, (uint16_t)count, (uint32_t)MIN(callback_us, UINT32_MAX));
+#endif
+#if LD2450_ENABLE_STATS
+    portENTER_CRITICAL(&instance->stats_lock);
+    instance->stats.batches_delivered++;
+    ld2450_stats_sample(&instance->stats.callback_time, callback_us);
+    portEXIT_CRITICAL(&instance->stats_lock);
+#else
+    (void)instance;
+#endif
+}
+
+/**
+ * @brief Add a delivered frame to the batch, delivering the batch once full
+ * 
+ * @param instance Driver instance
+ * @param frame Frame that passed the delivery policy
+ */
+void ld2450_batch_frame(ld2450_state_t *instance, const ld2450_frame_t *frame)
+{
+    ld2450_batch_t *batch = instance->batch;
+    
+    if (!batch->callback) {
+        return;
+    }
+    
+    if (batch->count == 0) {
+        batch->first_us = esp_timer_get_time();
+    }
+    batch->frames[batch->count++] = *frame;
+    
+    if (batch->count >= batch->max_frames) {
+        batch_flush(instance, batch);
+    }
+}
+
+/**
+ * @brief Deliver a partial batch whose oldest frame has waited max_latency_ms
+ * 
+ * Called by the processing task after every wakeup.
+ * 
+ * @param instance Driver instance
+ */
+void ld2450_batch_poll(ld2450_state_t *instance)
+{
+    ld2450_batch_t *batch = instance->batch;
+    
+    if (!batch || !batch->count) {
+        return;
+    }
+    
+    if (esp_timer_get_time() - batch->first_us >= batch->max_latency_us) {
+        batch_flush(instance, batch);
+    }
+}
+
+/**
+ * @brief Ticks until a partial batch is due
+ * 
+ * @param instance Driver instance
+ * @return Ticks to wait (portMAX_DELAY if batching is not enabled or the batch is empty)
+ */
+TickType_t ld2450_batch_wait_ticks(ld2450_state_t *instance)
+{
+    ld2450_batch_t *batch = instance->batch;
+    
+    if (!batch || !batch->count) {
+        return portMAX_DELAY;
+    }
+    
+    int64_t remaining_us = batch->first_us + batch->max_latency_us - esp_timer_get_time();
+    if (remaining_us <= 0) {
+        return 0;
+    }
+    
+    return pdMS_TO_TICKS((remaining_us + 999) / 1000) + 1;
+}
+
+/**
+ * @brief Register a callback for batched frame delivery
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param callback Function to call with each batch (NULL to unregister)
+ * @param user_ctx User context pointer passed to the callback function
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_STATE if batching is not enabled,
+ *         error code otherwise
+ */
+esp_err_t ld2450_register_batch_callback(ld2450_handle_t handle, ld2450_batch_cb_t callback, void *user_ctx)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    ld2450_batch_t *batch = instance->batch;
+    if (!batch) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    portENTER_CRITICAL(&batch->lock);
+    batch->callback = callback;
+    batch->user_ctx = user_ctx;
+    portEXIT_CRITICAL(&batch->lock);
+    
+    ESP_LOGI(TAG, "Batch callback %sregistered", callback ? "" : "un");
+    return ESP_OK;
+}
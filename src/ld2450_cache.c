@@ -0,0 +1,351 @@
+/**
+ * @file ld2450_cache.c
+ * @brief NVS cache of module identity and last-applied settings
+ * 
+ * Lets a restarted host skip the configuration-mode round trips of its boot
+ * sequence: getters answer from the cache, setters skip writes that match it, and
+ * the identity is re-read in the background once the first data frame arrived.
+ * 
+ * @author NieRVoid
+ * @date 2025-03-12
+ * @license MIT
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "ld2450.h"
+#include "ld2450_private.h"
+#include "esp_log.h"
+#include "nvs.h"
+
+static const char *TAG = LD2450_LOG_TAG;
+
+/**
+ * @brief Locate the cache member holding a field
+ * 
+ * @param cache Cache
+ * @param field LD2450_CACHE_* bit
+ * @param size Size of the member
+ * @return Pointer to the member, NULL for an unknown field
+ */
+static void *cache_member(ld2450_cache_t *cache, uint8_t field, size_t *size)
+{
+    switch (field) {
+        case LD2450_CACHE_FIRMWARE:
+            *size = sizeof(cache->firmware);
+            return &cache->firmware;
+        case LD2450_CACHE_MAC:
+            *size = sizeof(cache->mac);
+            return cache->mac;
+        case LD2450_CACHE_TRACKING:
+            *size = sizeof(cache->tracking_mode);
+            return &cache->tracking_mode;
+        case LD2450_CACHE_BLUETOOTH:
+            *size = sizeof(cache->bluetooth);
+            return &cache->bluetooth;
+        case LD2450_CACHE_REGION:
+            *size = sizeof(cache->region);
+            return &cache->region;
+        default:
+            *size = 0;
+            return NULL;
+    }
+}
+
+/**
+ * @brief Write the cache to NVS
+ * 
+ * @param instance Driver instance
+ */
+static void cache_persist(ld2450_state_t *instance)
+{
+    ld2450_cache_t snapshot;
+    nvs_handle_t nvs;
+    
+    portENTER_CRITICAL(&instance->cache_lock);
+    snapshot = instance->cache;
+    portEXIT_CRITICAL(&instance->cache_lock);
+    
+    esp_err_t ret = nvs_open(instance->cache_namespace, NVS_READWRITE, &nvs);
+    if (ret == ESP_OK) {
+        ret = nvs_set_blob(nvs, instance->cache_key, &snapshot, sizeof(snapshot));
+        if (ret == ESP_OK) {
+            ret = nvs_commit(nvs);
+        }
+        nvs_close(nvs);
+    }
+    
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to persist module cache: %s", esp_err_to_name(ret));
+    }
+}
+
+/**
+ * @brief Load the NVS cache of an instance
+ * 
+ * A missing blob, or one written with a different layout, starts an empty cache.
+ * 
+ * @param instance Driver instance
+ * @param nvs_namespace NVS namespace (NULL disables the cache)
+ */
+void ld2450_cache_init(ld2450_state_t *instance, const char *nvs_namespace)
+{
+    nvs_handle_t nvs;
+    
+    if (!nvs_namespace) {
+        return;
+    }
+    
+    portMUX_INITIALIZE(&instance->cache_lock);
+    snprintf(instance->cache_namespace, sizeof(instance->cache_namespace), "%s", nvs_namespace);
+    snprintf(instance->cache_key, sizeof(instance->cache_key), "uart%d", (int)instance->uart_port);
+    instance->cache_enabled = true;
+    
+    if (nvs_open(instance->cache_namespace, NVS_READONLY, &nvs) == ESP_OK) {
+        size_t len = sizeof(instance->cache);
+        esp_err_t ret = nvs_get_blob(nvs, instance->cache_key, &instance->cache, &len);
+        nvs_close(nvs);
+        
+        if (ret != ESP_OK || len != sizeof(instance->cache) ||
+            instance->cache.layout != LD2450_CACHE_LAYOUT) {
+            memset(&instance->cache, 0, sizeof(instance->cache));
+        }
+    }
+    instance->cache.layout = LD2450_CACHE_LAYOUT;
+    
+    ESP_LOGD(TAG, "Module cache %s/%s loaded, valid=0x%02x",
+             instance->cache_namespace, instance->cache_key, instance->cache.valid);
+    
+    // Re-read the identity in the background to catch a swapped module
+    instance->cache_refresh_pending = instance->auto_processing;
+}
+
+/**
+ * @brief Check whether a cached value is available
+ * 
+ * @param instance Driver instance
+ * @param field LD2450_CACHE_* bit
+ * @return true if the cache is enabled and holds the field
+ */
+bool ld2450_cache_has(ld2450_state_t *instance, uint8_t field)
+{
+    return instance->cache_enabled && (instance->cache.valid & field);
+}
+
+/**
+ * @brief Store a value into the cache and persist it
+ * 
+ * NVS is only written when the value actually changed.
+ * 
+ * @param instance Driver instance
+ * @param field LD2450_CACHE_* bit of the value
+ * @param value Value to copy into its ld2450_cache_t member
+ * @param len Size of the value
+ */
+void ld2450_cache_store(ld2450_state_t *instance, uint8_t field, const void *value, size_t len)
+{
+    size_t size;
+    bool changed = false;
+    
+    if (!instance->cache_enabled) {
+        return;
+    }
+    
+    portENTER_CRITICAL(&instance->cache_lock);
+    void *member = cache_member(&instance->cache, field, &size);
+    if (member && size == len &&
+        (!(instance->cache.valid & field) || memcmp(member, value, len) != 0)) {
+        memcpy(member, value, len);
+        instance->cache.valid |= field;
+        changed = true;
+    }
+    portEXIT_CRITICAL(&instance->cache_lock);
+    
+    if (changed) {
+        cache_persist(instance);
+    }
+}
+
+/**
+ * @brief Compare a value with the cache
+ * 
+ * @param instance Driver instance
+ * @param field LD2450_CACHE_* bit of the value
+ * @param value Value to compare with its ld2450_cache_t member
+ * @param len Size of the value
+ * @return true if the cache holds the field and it equals value
+ */
+bool ld2450_cache_matches(ld2450_state_t *instance, uint8_t field, const void *value, size_t len)
+{
+    size_t size;
+    bool match = false;
+    
+    if (!instance->cache_enabled) {
+        return false;
+    }
+    
+    portENTER_CRITICAL(&instance->cache_lock);
+    void *member = cache_member(&instance->cache, field, &size);
+    if (member && size == len && (instance->cache.valid & field)) {
+        match = memcmp(member, value, len) == 0;
+    }
+    portEXIT_CRITICAL(&instance->cache_lock);
+    
+    return match;
+}
+
+/**
+ * @brief Copy a cached value out
+ * 
+ * @param instance Driver instance
+ * @param field LD2450_CACHE_* bit of the value
+ * @param value Destination
+ * @param len Size of the value
+ * @return true if the cache held the field
+ */
+bool ld2450_cache_load(ld2450_state_t *instance, uint8_t field, void *value, size_t len)
+{
+    size_t size;
+    bool found = false;
+    
+    if (!instance->cache_enabled) {
+        return false;
+    }
+    
+    portENTER_CRITICAL(&instance->cache_lock);
+    void *member = cache_member(&instance->cache, field, &size);
+    if (member && size == len && (instance->cache.valid & field)) {
+        memcpy(value, member, len);
+        found = true;
+    }
+    portEXIT_CRITICAL(&instance->cache_lock);
+    
+    return found;
+}
+
+/**
+ * @brief Drop cached values and persist the change
+ * 
+ * @param instance Driver instance
+ * @param fields LD2450_CACHE_* bits to drop
+ */
+void ld2450_cache_invalidate(ld2450_state_t *instance, uint8_t fields)
+{
+    bool changed;
+    
+    if (!instance->cache_enabled) {
+        return;
+    }
+    
+    portENTER_CRITICAL(&instance->cache_lock);
+    changed = (instance->cache.valid & fields) != 0;
+    instance->cache.valid &= (uint8_t)~fields;
+    portEXIT_CRITICAL(&instance->cache_lock);
+    
+    if (changed) {
+        cache_persist(instance);
+    }
+}
+
+/**
+ * @brief Completion of the background firmware version query
+ */
+static void cache_firmware_done(ld2450_handle_t handle, uint16_t command, esp_err_t result,
+                                const uint8_t *ack, size_t ack_len, void *user_ctx)
+{
+    ld2450_state_t *instance = user_ctx;
+    ld2450_firmware_version_t version;
+    (void)handle;
+    (void)command;
+    
+    if (result == ESP_OK && ld2450_parse_firmware_ack(ack, ack_len, &version) == ESP_OK) {
+        ld2450_cache_store(instance, LD2450_CACHE_FIRMWARE, &version, sizeof(version));
+    } else {
+        ESP_LOGW(TAG, "Background firmware version query failed: %s", esp_err_to_name(result));
+    }
+}
+
+/**
+ * @brief Completion of the background MAC address query
+ * 
+ * A MAC address different from the cached one means the module was swapped, so
+ * the settings cached for the old module are dropped.
+ */
+static void cache_mac_done(ld2450_handle_t handle, uint16_t command, esp_err_t result,
+                           const uint8_t *ack, size_t ack_len, void *user_ctx)
+{
+    ld2450_state_t *instance = user_ctx;
+    uint8_t mac[6];
+    (void)handle;
+    (void)command;
+    
+    if (result != ESP_OK || ld2450_parse_mac_ack(ack, ack_len, mac) != ESP_OK) {
+        ESP_LOGW(TAG, "Background MAC address query failed: %s", esp_err_to_name(result));
+        return;
+    }
+    
+    if (ld2450_cache_has(instance, LD2450_CACHE_MAC) &&
+        !ld2450_cache_matches(instance, LD2450_CACHE_MAC, mac, sizeof(mac))) {
+        ESP_LOGW(TAG, "Module MAC address changed, dropping cached settings");
+        ld2450_cache_invalidate(instance, LD2450_CACHE_SETTINGS);
+    }
+    
+    ld2450_cache_store(instance, LD2450_CACHE_MAC, mac, sizeof(mac));
+}
+
+/**
+ * @brief Queue the deferred identity queries once the data stream is live
+ * 
+ * Both queries share one configuration-mode window on the command engine.
+ * 
+ * @param instance Driver instance
+ */
+void ld2450_cache_refresh_identity(ld2450_state_t *instance)
+{
+    if (!instance->cache_refresh_pending) {
+        return;
+    }
+    instance->cache_refresh_pending = false;
+    
+    ld2450_command_t firmware = {
+        .command = LD2450_CMD_READ_FW_VERSION,
+        .callback = cache_firmware_done,
+        .user_ctx = instance,
+    };
+    ld2450_command_t mac = {
+        .command = LD2450_CMD_GET_MAC_ADDRESS,
+        .value = {0x01, 0x00},
+        .value_len = 2,
+        .callback = cache_mac_done,
+        .user_ctx = instance,
+    };
+    
+    if (ld2450_command_submit(instance, &firmware) != ESP_OK ||
+        ld2450_command_submit(instance, &mac) != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to queue background identity queries");
+    }
+}
+
+/**
+ * @brief Drop an instance's cached module identity and settings
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_SUPPORTED if no cache is configured
+ */
+esp_err_t ld2450_clear_cache(ld2450_handle_t handle)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    if (!instance->cache_enabled) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    
+    ld2450_cache_invalidate(instance, 0xFF);
+    instance->cache_refresh_pending = instance->auto_processing;
+    
+    return ESP_OK;
+}
@@ -0,0 +1,472 @@
+/**
+ * @file ld2450_capture.c
+ * @brief Raw UART capture and deterministic replay
+ * 
+ * Captures are chunk records (ld2450_capture_record_t plus the raw bytes) in a
+ * byte ring that the processing task reads the UART into directly. A replay walks
+ * such a capture and feeds each chunk to ld2450_rx_feed(), the same entry point
+ * UART data takes, with timestamps rebuilt from the recorded timeline so that
+ * downstream consumers see the same frame intervals at any replay speed.
+ * 
+ * @author NieRVoid
+ * @date 2025-03-12
+ * @license MIT
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "ld2450.h"
+#include "ld2450_private.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = LD2450_LOG_TAG;
+
+#define RECORD_SIZE sizeof(ld2450_capture_record_t)
+
+/**
+ * @brief Reserve room for a UART chunk in the capture ring
+ * 
+ * @param instance Driver instance
+ * @param len Largest chunk that will be committed
+ * @return Where to read the chunk to, NULL if not recording or the ring is full
+ */
+uint8_t *ld2450_capture_reserve(ld2450_state_t *instance, size_t len)
+{
+    ld2450_capture_t *capture = instance->capture;
+    
+    if (!capture || !atomic_load(&capture->recording)) {
+        return NULL;
+    }
+    
+    size_t need = RECORD_SIZE + len;
+    size_t write = atomic_load_explicit(&capture->write, memory_order_relaxed);
+    size_t read = atomic_load_explicit(&capture->read, memory_order_acquire);
+    size_t at = write;
+    
+    // One byte always stays free so that write == read means empty
+    if (write >= read) {
+        size_t tail = capture->size - write - (read == 0 ? 1 : 0);
+        if (need > tail) {
+            if (read == 0 || need > read - 1) {
+                LD2450_STATS_INC(instance, capture_drops);
+                return NULL;
+            }
+            at = 0;
+        }
+    } else if (need > read - write - 1) {
+        LD2450_STATS_INC(instance, capture_drops);
+        return NULL;
+    }
+    
+    if (at != write && capture->size - write >= RECORD_SIZE) {
+        ld2450_capture_record_t wrap = { .length = LD2450_CAPTURE_WRAP };
+        memcpy(capture->buffer + write, &wrap, sizeof(wrap));
+    }
+    
+    capture->reserved = at;
+    return capture->buffer + at + RECORD_SIZE;
+}
+
+/**
+ * @brief Publish the chunk read into the reserved space
+ * 
+ * @param instance Driver instance
+ * @param timestamp_us Time the chunk was taken off the UART
+ * @param len Chunk length (at most the reserved length)
+ */
+void ld2450_capture_commit(ld2450_state_t *instance, int64_t timestamp_us, size_t len)
+{
+    ld2450_capture_t *capture = instance->capture;
+    
+    if (len == 0) {
+        return;
+    }
+    
+    ld2450_capture_record_t record = { .timestamp_us = timestamp_us, .length = (uint16_t)len };
+    memcpy(capture->buffer + capture->reserved, &record, sizeof(record));
+    
+    size_t next = capture->reserved + RECORD_SIZE + len;
+    atomic_store_explicit(&capture->write, next == capture->size ? 0 : next, memory_order_release);
+}
+
+/**
+ * @brief Release the capture ring
+ * 
+ * @param instance Driver instance, with its processing task stopped
+ */
+void ld2450_capture_deinit(ld2450_state_t *instance)
+{
+    ld2450_capture_t *capture = instance->capture;
+    
+    instance->capture = NULL;
+    if (capture) {
+        if (capture->owned) {
+            free(capture->buffer);
+        }
+        free(capture);
+    }
+}
+
+/**
+ * @brief Wait until the processing task has left the capture ring
+ */
+static void capture_quiesce(ld2450_state_t *instance)
+{
+    if (ld2450_command_via_task(instance)) {
+        while (atomic_load(&instance->capture_busy)) {
+            vTaskDelay(1);
+        }
+    }
+}
+
+/**
+ * @brief Start recording raw UART bytes
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param config Ring to record into (copied)
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NO_MEM if the ring cannot be allocated,
+ *         ESP_ERR_INVALID_STATE without a processing task, error code otherwise
+ */
+esp_err_t ld2450_capture_start(ld2450_handle_t handle, const ld2450_capture_config_t *config)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized || !config ||
+        config->size < RECORD_SIZE + LD2450_UART_RX_BUF_SIZE + 1) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    if (!instance->auto_processing) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    ld2450_capture_t *capture = calloc(1, sizeof(ld2450_capture_t));
+    if (!capture) {
+        return ESP_ERR_NO_MEM;
+    }
+    capture->size = config->size;
+    capture->buffer = config->buffer;
+    if (!capture->buffer) {
+        capture->buffer = malloc(config->size);
+        capture->owned = true;
+        if (!capture->buffer) {
+            ESP_LOGE(TAG, "Failed to allocate %u byte capture ring", (unsigned)config->size);
+            free(capture);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    atomic_init(&capture->write, 0);
+    atomic_init(&capture->read, 0);
+    atomic_init(&capture->recording, true);
+    
+    if (xSemaphoreTake(instance->mutex, portMAX_DELAY) != pdTRUE) {
+        if (capture->owned) {
+            free(capture->buffer);
+        }
+        free(capture);
+        return ESP_FAIL;
+    }
+    
+    // Retire the previous ring once the processing task cannot be inside it
+    ld2450_capture_t *old = instance->capture;
+    instance->capture = NULL;
+    capture_quiesce(instance);
+    if (old) {
+        if (old->owned) {
+            free(old->buffer);
+        }
+        free(old);
+    }
+    instance->capture = capture;
+    
+    xSemaphoreGive(instance->mutex);
+    
+    ESP_LOGI(TAG, "Capturing UART%d into %u bytes", (int)instance->uart_port, (unsigned)config->size);
+    return ESP_OK;
+}
+
+/**
+ * @brief Stop recording
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_STATE if no capture exists
+ */
+esp_err_t ld2450_capture_stop(ld2450_handle_t handle)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    ld2450_capture_t *capture = instance->capture;
+    if (!capture) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    atomic_store(&capture->recording, false);
+    capture_quiesce(instance);
+    
+    ESP_LOGI(TAG, "Capture stopped");
+    return ESP_OK;
+}
+
+/**
+ * @brief Move recorded chunks out of the capture ring
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param buffer Destination
+ * @param size Size of buffer
+ * @param length Pointer to store the number of bytes copied (0 if nothing is pending)
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_SIZE if the next record does not fit,
+ *         ESP_ERR_INVALID_STATE if no capture exists
+ */
+esp_err_t ld2450_capture_read(ld2450_handle_t handle, uint8_t *buffer, size_t size, size_t *length)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized || !buffer || !length) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    ld2450_capture_t *capture = instance->capture;
+    if (!capture) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    size_t read = atomic_load_explicit(&capture->read, memory_order_relaxed);
+    size_t copied = 0;
+    
+    *length = 0;
+    while (true) {
+        size_t write = atomic_load_explicit(&capture->write, memory_order_acquire);
+        if (read == write) {
+            break;
+        }
+        
+        ld2450_capture_record_t record;
+        if (capture->size - read < RECORD_SIZE) {
+            read = 0;
+            continue;
+        }
+        memcpy(&record, capture->buffer + read, sizeof(record));
+        if (record.length == LD2450_CAPTURE_WRAP) {
+            read = 0;
+            continue;
+        }
+        
+        size_t total = RECORD_SIZE + record.length;
+        if (copied + total > size) {
+            break;
+        }
+        memcpy(buffer + copied, capture->buffer + read, total);
+        copied += total;
+        read += total;
+        if (read == capture->size) {
+            read = 0;
+        }
+    }
+    
+    atomic_store_explicit(&capture->read, read, memory_order_release);
+    *length = copied;
+    
+    return copied == 0 && atomic_load(&capture->write) != read ? ESP_ERR_INVALID_SIZE : ESP_OK;
+}
+
+/**
+ * @brief Adopt a replay staged by ld2450_replay_start()/ld2450_replay_stop()
+ */
+static void replay_adopt(ld2450_state_t *instance)
+{
+    ld2450_replay_t *replay = &instance->replay;
+    
+    portENTER_CRITICAL(&instance->replay_lock);
+    replay->config = instance->replay_pending;
+    instance->replay_dirty = false;
+    portEXIT_CRITICAL(&instance->replay_lock);
+    
+    replay->pos = 0;
+    replay->base_us = esp_timer_get_time();
+    if (replay->config.data) {
+        ld2450_capture_record_t first;
+        memcpy(&first, replay->config.data, sizeof(first));
+        replay->first_us = first.timestamp_us;
+    }
+    
+    // Start parsing the replay from a clean scanner state
+    instance->frame_synced = false;
+    instance->frame_idx = 0;
+    instance->header_match = 0;
+    instance->replay_running = replay->config.data != NULL;
+}
+
+/**
+ * @brief End the running replay and return to UART data
+ */
+static void replay_finish(ld2450_state_t *instance)
+{
+    instance->replay.config.data = NULL;
+    instance->frame_synced = false;
+    instance->frame_idx = 0;
+    instance->header_match = 0;
+    instance->replay_running = false;
+    ESP_LOGI(TAG, "Replay finished");
+}
+
+/**
+ * @brief Time until the next replay chunk is due
+ * 
+ * @param instance Driver instance
+ * @return Ticks to wait (portMAX_DELAY if no replay runs)
+ */
+TickType_t ld2450_replay_wait_ticks(ld2450_state_t *instance)
+{
+    ld2450_replay_t *replay = &instance->replay;
+    
+    if (instance->replay_dirty) {
+        return 0;
+    }
+    if (!replay->config.data) {
+        return portMAX_DELAY;
+    }
+    if (replay->config.max_speed) {
+        // Let lower-priority tasks run between batches
+        return 1;
+    }
+    
+    ld2450_capture_record_t record;
+    memcpy(&record, replay->config.data + replay->pos, sizeof(record));
+    int64_t wait_us = replay->base_us + (record.timestamp_us - replay->first_us) - esp_timer_get_time();
+    
+    return wait_us <= 0 ? 0 : pdMS_TO_TICKS((wait_us + 999) / 1000) + 1;
+}
+
+/**
+ * @brief Feed due replay chunks into the receive path
+ * 
+ * @param instance Driver instance
+ */
+void ld2450_replay_poll(ld2450_state_t *instance)
+{
+    ld2450_replay_t *replay = &instance->replay;
+    
+    if (instance->replay_dirty) {
+        replay_adopt(instance);
+    }
+    
+    for (int fed = 0; replay->config.data && fed < LD2450_REPLAY_BATCH; fed++) {
+        const ld2450_replay_config_t *config = &replay->config;
+        ld2450_capture_record_t record;
+        
+        if (config->length - replay->pos < RECORD_SIZE) {
+            replay_finish(instance);
+            break;
+        }
+        memcpy(&record, config->data + replay->pos, sizeof(record));
+        if (record.length > config->length - replay->pos - RECORD_SIZE) {
+            ESP_LOGW(TAG, "Truncated capture record at offset %u", (unsigned)replay->pos);
+            replay_finish(instance);
+            break;
+        }
+        
+        // Timestamps follow the recorded timeline, whatever the replay speed
+        int64_t timestamp_us = replay->base_us + (record.timestamp_us - replay->first_us);
+        if (!config->max_speed && timestamp_us > esp_timer_get_time()) {
+            break;
+        }
+        
+        ld2450_rx_feed(instance, config->data + replay->pos + RECORD_SIZE, record.length, timestamp_us);
+        replay->pos += RECORD_SIZE + record.length;
+        
+        if (config->loop && config->length - replay->pos < RECORD_SIZE) {
+            replay->base_us = timestamp_us + LD2450_REPLAY_LOOP_GAP_US;
+            replay->pos = 0;
+        }
+    }
+}
+
+/**
+ * @brief Stage a replay change and wait for the processing task to adopt it
+ */
+static esp_err_t replay_stage(ld2450_state_t *instance, const ld2450_replay_config_t *config)
+{
+    portENTER_CRITICAL(&instance->replay_lock);
+    instance->replay_pending = *config;
+    instance->replay_dirty = true;
+    portEXIT_CRITICAL(&instance->replay_lock);
+    
+    // Wake the processing task wherever it is blocked
+    uart_event_t wake = { .type = LD2450_UART_EVENT_WAKE };
+    xQueueSend(instance->uart_queue, &wake, 0);
+    
+    // The previous capture may be released once the task no longer reads it
+    if (ld2450_command_via_task(instance)) {
+        while (instance->replay_dirty) {
+            vTaskDelay(1);
+        }
+    }
+    
+    return ESP_OK;
+}
+
+/**
+ * @brief Inject a capture into the receive pipeline
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param config Replay (copied)
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_STATE without a processing task,
+ *         error code otherwise
+ */
+esp_err_t ld2450_replay_start(ld2450_handle_t handle, const ld2450_replay_config_t *config)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized || !config || !config->data ||
+        config->length < RECORD_SIZE) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    if (!instance->auto_processing) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    ESP_LOGI(TAG, "Replaying %u byte capture%s", (unsigned)config->length,
+             config->max_speed ? " at max speed" : "");
+    return replay_stage(instance, config);
+}
+
+/**
+ * @brief Stop a replay and return to UART data
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_replay_stop(ld2450_handle_t handle)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    ld2450_replay_config_t none = {0};
+    
+    if (!instance || !instance->initialized) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    return replay_stage(instance, &none);
+}
+
+/**
+ * @brief Check whether a replay is running
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @return true while the processing task is feeding a capture
+ */
+bool ld2450_replay_active(ld2450_handle_t handle)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    return instance && instance->initialized && (instance->replay_running || instance->replay_dirty);
+}
@@ -0,0 +1,384 @@
+/**
+ * @file ld2450_command.c
+ * @brief Asynchronous command engine serviced by the processing task
+ * 
+ * Commands are queued by any task and put on the wire by the processing task,
+ * which also owns the UART receive path. ACK frames are picked out of the
+ * received stream and matched to the command on the wire by their echo, so no
+ * application task ever blocks on the UART.
+ * 
+ * @author NieRVoid
+ * @date 2025-03-12
+ * @license MIT
+ */
+
+#include <string.h>
+#include "ld2450.h"
+#include "ld2450_private.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "driver/uart.h"
+
+static const char *TAG = LD2450_LOG_TAG;
+
+/**
+ * @brief Build a command packet in the instance command buffer
+ * 
+ * @param instance Driver instance
+ * @param cmd Command word
+ * @param value Command value buffer
+ * @param value_len Length of the command value in bytes
+ * @return Size of the command packet
+ */
+size_t ld2450_build_command(ld2450_state_t *instance, uint16_t cmd, const void *value, size_t value_len)
+{
+    uint8_t *buffer = instance->cmd_buffer;
+    
+    memcpy(buffer, LD2450_CONFIG_FRAME_HEADER, 4);
+    
+    // Add data length (command word (2 bytes) + value length)
+    buffer[4] = (value_len + 2) & 0xFF;
+    buffer[5] = ((value_len + 2) >> 8) & 0xFF;
+    
+    // Add command word (little-endian)
+    buffer[6] = cmd & 0xFF;
+    buffer[7] = (cmd >> 8) & 0xFF;
+    
+    // Add command value if present
+    if (value != NULL && value_len > 0) {
+        memcpy(&buffer[8], value, value_len);
+    }
+    
+    memcpy(&buffer[8 + value_len], LD2450_CONFIG_FRAME_FOOTER, 4);
+    
+    return 8 + value_len + 4;
+}
+
+/**
+ * @brief Create the command engine resources of an instance
+ * 
+ * @param instance Driver instance
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_command_init(ld2450_state_t *instance)
+{
+    instance->cmd_queue = xQueueCreateStatic(LD2450_CMD_QUEUE_SIZE, sizeof(ld2450_cmd_request_t),
+                                             instance->cmd_queue_storage, &instance->cmd_queue_buffer);
+    instance->cmd_done = xSemaphoreCreateBinaryStatic(&instance->cmd_done_buffer);
+    
+    if (!instance->cmd_queue || !instance->cmd_done) {
+        ESP_LOGE(TAG, "Failed to create command queue");
+        ld2450_command_deinit(instance);
+        return ESP_ERR_NO_MEM;
+    }
+    
+    return ESP_OK;
+}
+
+/**
+ * @brief Release the command engine resources of an instance
+ * 
+ * @param instance Driver instance
+ */
+void ld2450_command_deinit(ld2450_state_t *instance)
+{
+    if (instance->cmd_queue) {
+        vQueueDelete(instance->cmd_queue);
+        instance->cmd_queue = NULL;
+    }
+    if (instance->cmd_done) {
+        vSemaphoreDelete(instance->cmd_done);
+        instance->cmd_done = NULL;
+    }
+}
+
+/**
+ * @brief Queue a request and wake the processing task
+ * 
+ * @param instance Driver instance
+ * @param request Request to queue (copied)
+ * @return esp_err_t ESP_OK if queued, ESP_ERR_NO_MEM if the queue is full
+ */
+esp_err_t ld2450_command_enqueue(ld2450_state_t *instance, const ld2450_cmd_request_t *request)
+{
+    if (xQueueSend(instance->cmd_queue, request, 0) != pdTRUE) {
+        ESP_LOGW(TAG, "Command queue full, dropping command %04x", request->command.command);
+        return ESP_ERR_NO_MEM;
+    }
+    
+    // If the event queue is full the task is awake anyway and polls after the next event
+    uart_event_t wake = { .type = LD2450_UART_EVENT_WAKE };
+    xQueueSend(instance->uart_queue, &wake, 0);
+    
+    return ESP_OK;
+}
+
+/**
+ * @brief Queue a command for the driver's processing task and return immediately
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param command Command to queue (copied)
+ * @return esp_err_t ESP_OK if queued, ESP_ERR_NOT_SUPPORTED without auto-processing,
+ *         ESP_ERR_NO_MEM if the command queue is full, error code otherwise
+ */
+esp_err_t ld2450_command_submit(ld2450_handle_t handle, const ld2450_command_t *command)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized || !command ||
+        command->value_len > LD2450_COMMAND_VALUE_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    if (!instance->auto_processing) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    
+    ld2450_cmd_request_t request = {
+        .command = *command,
+        .auto_config = true,
+        .sync = false,
+    };
+    
+    return ld2450_command_enqueue(instance, &request);
+}
+
+/**
+ * @brief Put a command frame on the wire and arm its ACK deadline
+ * 
+ * @param instance Driver instance
+ * @param cmd Command word
+ * @param value Command value buffer
+ * @param value_len Length of the command value in bytes
+ * @param timeout_ms ACK timeout in milliseconds
+ */
+void ld2450_command_send(ld2450_state_t *instance, uint16_t cmd, const void *value,
+                         size_t value_len, uint32_t timeout_ms)
+{
+    size_t cmd_len = ld2450_build_command(instance, cmd, value, value_len);
+    
+    instance->ack_idx = 0;
+    instance->cmd_wire = cmd;
+    instance->cmd_waiting = true;
+    instance->cmd_deadline_us = esp_timer_get_time() + (int64_t)timeout_ms * 1000;
+    
+    int bytes_sent = uart_write_bytes(instance->uart_port, (const char *)instance->cmd_buffer, cmd_len);
+    if (bytes_sent != (int)cmd_len) {
+        // Let the deadline report the failure through the normal completion path
+        ESP_LOGE(TAG, "Failed to send command %04x (sent %d/%zu bytes)", cmd, bytes_sent, cmd_len);
+        instance->cmd_deadline_us = 0;
+        return;
+    }
+    
+    LD2450_TRACE(instance, LD2450_TRACE_CMD_SENT, 0, cmd, (uint32_t)cmd_len);
+}
+
+/**
+ * @brief Report the active request's outcome to whoever is waiting for it
+ * 
+ * @param instance Driver instance
+ * @param result Command result
+ * @param ack ACK frame (NULL if none)
+ * @param len ACK frame length
+ */
+static void command_finish(ld2450_state_t *instance, esp_err_t result, const uint8_t *ack, size_t len)
+{
+    const ld2450_cmd_request_t *request = &instance->cmd_active;
+    
+    instance->cmd_pending = false;
+    
+    if (request->sync) {
+        instance->cmd_sync_result = result;
+        instance->cmd_sync_ack_len = ack ? len : 0;
+        if (ack) {
+            memcpy(instance->ack_buffer, ack, len);
+        }
+        instance->cmd_sync_done_seq = request->sync_seq;
+        xSemaphoreGive(instance->cmd_done);
+        return;
+    }
+    
+    if (request->command.callback) {
+        request->command.callback(instance, request->command.command, result, ack, len,
+                                  request->command.user_ctx);
+    }
+    if (request->command.notify_task) {
+        xTaskNotify(request->command.notify_task, (uint32_t)result, eSetValueWithOverwrite);
+    }
+}
+
+/**
+ * @brief Handle the outcome of the command on the wire
+ * 
+ * @param instance Driver instance
+ * @param result Command result
+ * @param ack ACK frame (NULL on timeout)
+ * @param len ACK frame length
+ */
+static void command_complete(ld2450_state_t *instance, esp_err_t result, const uint8_t *ack, size_t len)
+{
+    uint16_t wire = instance->cmd_wire;
+    bool own = instance->cmd_pending && wire == instance->cmd_active.command.command;
+    
+    LD2450_TRACE(instance, LD2450_TRACE_CMD_DONE, 0, wire, (uint32_t)result);
+    
+    instance->cmd_waiting = false;
+    instance->cmd_wire_result = result;
+    instance->cmd_wire_ack_len = ack ? len : 0;
+    
+    if (result == ESP_OK) {
+        switch (wire) {
+            case LD2450_CMD_ENABLE_CONFIG:
+                instance->in_config_mode = true;
+                break;
+            case LD2450_CMD_END_CONFIG:
+                instance->in_config_mode = false;
+                instance->cmd_auto_opened = false;
+                break;
+            case LD2450_CMD_RESTART_MODULE:
+                // The module reboots into normal mode; hold the queue until it is back
+                instance->in_config_mode = false;
+                instance->cmd_auto_opened = false;
+                instance->cmd_hold_until_us = esp_timer_get_time() +
+                                              (int64_t)LD2450_RESTART_TIMEOUT_MS * 1000;
+                if (own) {
+                    // Completion is reported once the hold expires
+                    instance->cmd_restarting = true;
+                    return;
+                }
+                break;
+            default:
+                break;
+        }
+    } else {
+        ESP_LOGW(TAG, "Command %04x failed: %s", wire, esp_err_to_name(result));
+        if (wire == LD2450_CMD_END_CONFIG && !own) {
+            instance->cmd_auto_opened = false;
+        }
+    }
+    
+    if (wire == LD2450_CMD_END_CONFIG && instance->event_loop) {
+        ld2450_event_config_done_t event = { .handle = instance, .result = result };
+        ld2450_event_post(instance, LD2450_EVENT_CONFIG_DONE, &event, sizeof(event));
+    }
+    
+    if (own) {
+        command_finish(instance, result, ack, len);
+    } else if (wire == LD2450_CMD_ENABLE_CONFIG && result != ESP_OK && instance->cmd_pending) {
+        // Implicit enable failed: the queued command cannot run
+        instance->cmd_auto_opened = false;
+        command_finish(instance, result, NULL, 0);
+    }
+}
+
+/**
+ * @brief Deliver a complete ACK frame from the receive path to the command engine
+ * 
+ * @param instance Driver instance
+ * @param ack ACK frame
+ * @param len ACK frame length
+ */
+void ld2450_command_ack(ld2450_state_t *instance, const uint8_t *ack, size_t len)
+{
+    if (!instance->cmd_waiting || len < 10) {
+        return;
+    }
+    
+    // ACK command word is the request word with 0x0100 set
+    if (ack[6] != (instance->cmd_wire & 0xFF) || ack[7] != 0x01) {
+        ESP_LOGV(TAG, "Ignoring ACK for %02x while waiting for %04x", ack[6], instance->cmd_wire);
+        return;
+    }
+    
+    command_complete(instance, ld2450_validate_ack(ack, len, (ld2450_cmd_t)instance->cmd_wire), ack, len);
+}
+
+/**
+ * @brief Advance the command engine (processing task only)
+ * 
+ * @param instance Driver instance
+ */
+void ld2450_command_poll(ld2450_state_t *instance)
+{
+    int64_t now = esp_timer_get_time();
+    
+    if (instance->cmd_waiting) {
+        if (now < instance->cmd_deadline_us) {
+            return;
+        }
+        
+        ESP_LOGE(TAG, "No ACK for command %04x", instance->cmd_wire);
+        LD2450_TRACE(instance, LD2450_TRACE_CMD_TIMEOUT, 0, instance->cmd_wire, 0);
+        
+        // Keep the partial frame for ld2450_get_last_error_data()
+        instance->error_buffer_len = MIN(instance->ack_idx, LD2450_ERROR_BUFFER_SIZE);
+        memcpy(instance->error_buffer, instance->ack_rx, instance->error_buffer_len);
+        
+        command_complete(instance, ESP_ERR_TIMEOUT, NULL, 0);
+    }
+    
+    if (now < instance->cmd_hold_until_us) {
+        return;
+    }
+    
+    if (instance->cmd_restarting) {
+        // Restart hold expired
+        instance->cmd_restarting = false;
+        command_finish(instance, ESP_OK, NULL, 0);
+    }
+    
+    if (!instance->cmd_pending) {
+        if (xQueueReceive(instance->cmd_queue, &instance->cmd_active, 0) == pdTRUE) {
+            instance->cmd_pending = true;
+        } else {
+            if (instance->cmd_auto_opened && instance->in_config_mode) {
+                // Queue drained: leave the configuration mode we entered implicitly
+                ld2450_command_send(instance, LD2450_CMD_END_CONFIG, NULL, 0, LD2450_CONFIG_TIMEOUT_MS);
+            }
+            return;
+        }
+    }
+    
+    const ld2450_command_t *command = &instance->cmd_active.command;
+    
+    if (instance->cmd_active.auto_config && !instance->in_config_mode &&
+        command->command != LD2450_CMD_ENABLE_CONFIG) {
+        uint8_t value[2] = {0x01, 0x00};
+        instance->cmd_auto_opened = true;
+        ld2450_command_send(instance, LD2450_CMD_ENABLE_CONFIG, value, sizeof(value), LD2450_CONFIG_TIMEOUT_MS);
+        return;
+    }
+    
+    ld2450_command_send(instance, command->command, command->value, command->value_len,
+                 command->timeout_ms ? command->timeout_ms : LD2450_CONFIG_TIMEOUT_MS);
+}
+
+/**
+ * @brief Time the processing task may block before the engine needs attention
+ * 
+ * @param instance Driver instance
+ * @return Ticks until the next engine deadline, portMAX_DELAY if none
+ */
+TickType_t ld2450_command_wait_ticks(const ld2450_state_t *instance)
+{
+    int64_t deadline;
+    
+    if (instance->cmd_waiting) {
+        deadline = instance->cmd_deadline_us;
+    } else if (instance->cmd_hold_until_us > esp_timer_get_time()) {
+        deadline = instance->cmd_hold_until_us;
+    } else if (instance->cmd_pending || uxQueueMessagesWaiting(instance->cmd_queue) > 0 ||
+               (instance->cmd_auto_opened && instance->in_config_mode)) {
+        return 0;
+    } else {
+        return portMAX_DELAY;
+    }
+    
+    int64_t remaining_us = deadline - esp_timer_get_time();
+    if (remaining_us <= 0) {
+        return 0;
+    }
+    
+    // Round up so the task never wakes just before the deadline
+    return pdMS_TO_TICKS((remaining_us + 999) / 1000) + 1;
+}
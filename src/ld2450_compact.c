@@ -0,0 +1,86 @@
+/**
+ * @file ld2450_compact.c
+ * @brief Conversion between full and compact frame representations
+ * 
+ * The compact form drops the derived fields and padding of ld2450_frame_t and
+ * delta-encodes the timestamp, cutting a frame from 80 to 36 bytes for
+ * buffering and network transmission.
+ * 
+ * @author NieRVoid
+ * @date 2025-03-12
+ * @license MIT
+ */
+
+#include <string.h>
+#include "ld2450.h"
+#include "ld2450_private.h"
+
+/**
+ * @brief Convert a frame to the compact representation
+ * 
+ * @param frame Source frame
+ * @param prev_timestamp_us Timestamp of the previous frame in the stream (or the stream base time)
+ * @param compact Destination compact frame
+ */
+void ld2450_frame_to_compact(const ld2450_frame_t *frame, int64_t prev_timestamp_us,
+                             ld2450_compact_frame_t *compact)
+{
+    compact->valid_mask = 0;
+    
+    for (int i = 0; i < 3; i++) {
+        const ld2450_target_t *target = &frame->targets[i];
+        
+        compact->targets[i].x = target->x;
+        compact->targets[i].y = target->y;
+        compact->targets[i].speed = target->speed;
+        compact->targets[i].resolution = target->resolution;
+        
+        if (target->valid) {
+            compact->valid_mask |= (uint8_t)(1U << i);
+        }
+    }
+    
+    int64_t delta = frame->timestamp_us - prev_timestamp_us;
+    if (delta < 0) {
+        delta = 0;
+    } else if (delta > UINT32_MAX) {
+        delta = UINT32_MAX;
+    }
+    
+    compact->sequence = frame->sequence;
+    compact->timestamp_delta_us = (uint32_t)delta;
+}
+
+/**
+ * @brief Expand a compact frame back into a full frame
+ * 
+ * @param compact Source compact frame
+ * @param prev_timestamp_us Timestamp of the previous frame in the stream (or the stream base time)
+ * @param mode How distance and angle are recomputed
+ * @param frame Destination frame
+ */
+void ld2450_frame_from_compact(const ld2450_compact_frame_t *compact, int64_t prev_timestamp_us,
+                               ld2450_derived_mode_t mode, ld2450_frame_t *frame)
+{
+    frame->count = 0;
+    
+    for (int i = 0; i < 3; i++) {
+        ld2450_target_t *target = &frame->targets[i];
+        
+        if (!(compact->valid_mask & (1U << i))) {
+            memset(target, 0, sizeof(ld2450_target_t));
+            continue;
+        }
+        
+        target->x = compact->targets[i].x;
+        target->y = compact->targets[i].y;
+        target->speed = compact->targets[i].speed;
+        target->resolution = compact->targets[i].resolution;
+        target->valid = true;
+        ld2450_compute_derived(target, mode);
+        frame->count++;
+    }
+    
+    frame->sequence = compact->sequence;
+    frame->timestamp_us = prev_timestamp_us + compact->timestamp_delta_us;
+}
@@ -11,9 +11,11 @@
  */
 
 #include <string.h>
+#include <inttypes.h>
 #include "ld2450.h"
 #include "ld2450_private.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "driver/uart.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -22,46 +24,18 @@
 static const char *TAG = LD2450_LOG_TAG;
 
 /**
- * @brief Build a command packet in the command buffer
+ * @brief Get the last error data buffer for debugging
  * 
- * @param instance Driver instance
- * @param cmd Command word
- * @param value Command value buffer
- * @param value_len Length of the command value in bytes
- * @return Size of the command packet
+ * @param handle Driver handle (NULL for the default instance)
+ * @param buffer Buffer to copy the error data into
+ * @param buffer_size Size of the provided buffer
+ * @param length Pointer to store the actual length of error data
+ * @return esp_err_t ESP_OK on success, error code otherwise
  */
-static size_t build_command_packet(ld2450_state_t *instance, ld2450_cmd_t cmd, 
-                                  const void *value, size_t value_len)
+esp_err_t ld2450_dev_get_last_error_data(ld2450_handle_t handle, uint8_t *buffer, size_t buffer_size,
+                                         size_t *length)
 {
-    uint8_t *buffer = instance->cmd_buffer;
-    
-    // Use direct 32-bit writes for header when possible
-    *(uint32_t*)buffer = *(uint32_t*)LD2450_CONFIG_FRAME_HEADER;
-    
-    // Add data length (command word (2 bytes) + value length)
-    buffer[4] = (value_len + 2) & 0xFF;
-    buffer[5] = ((value_len + 2) >> 8) & 0xFF;
-    
-    // Add command word (little-endian)
-    buffer[6] = cmd & 0xFF;
-    buffer[7] = (cmd >> 8) & 0xFF;
-    
-    // Add command value if present
-    if (value != NULL && value_len > 0) {
-        memcpy(&buffer[8], value, value_len);
-    }
-    
-    // Add footer
-    *(uint32_t*)&buffer[8 + value_len] = *(uint32_t*)LD2450_CONFIG_FRAME_FOOTER;
-    
-    return 8 + value_len + 4;
-}
-
-/**
- * @brief Get the last error data buffer for debugging
- */
-esp_err_t ld2450_get_last_error_data(uint8_t *buffer, size_t buffer_size, size_t *length) {
-    ld2450_state_t *instance = ld2450_get_instance();
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
     
     if (!instance || !instance->initialized || !buffer || !length) {
         return ESP_ERR_INVALID_ARG;
@@ -87,8 +61,22 @@ esp_err_t ld2450_get_last_error_data(uint8_t *buffer, size_t buffer_size, size_t
 }
 
 /**
- * @brief Send a command packet and wait for acknowledgement
+ * @brief Get the last error data buffer for debugging
+ * 
+ * @param buffer Buffer to copy the error data into
+ * @param buffer_size Size of the provided buffer
+ * @param length Pointer to store the actual length of error data
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_get_last_error_data(uint8_t *buffer, size_t buffer_size, size_t *length)
+{
+    return ld2450_dev_get_last_error_data(NULL, buffer, buffer_size, length);
+}
+
+/**
+ * @brief Send a command through the processing task and wait for its completion
  * 
+ * @param instance Driver instance
  * @param cmd Command word
  * @param value Command value buffer
  * @param value_len Length of the command value in bytes
@@ -97,14 +85,31 @@ esp_err_t ld2450_get_last_error_data(uint8_t *buffer, size_t buffer_size, size_t
  * @param timeout_ms Timeout in milliseconds
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
-esp_err_t ld2450_send_command(ld2450_cmd_t cmd, const void *value, size_t value_len, 
-                             uint8_t *ack_buffer, size_t *ack_len, uint32_t timeout_ms)
+static esp_err_t send_command_via_task(ld2450_state_t *instance, ld2450_cmd_t cmd,
+                                       const void *value, size_t value_len,
+                                       uint8_t *ack_buffer, size_t *ack_len, uint32_t timeout_ms)
 {
-    ld2450_state_t *instance = ld2450_get_instance();
-    esp_err_t ret = ESP_OK;
+    if (value_len > LD2450_COMMAND_VALUE_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
     
-    if (!instance || !instance->initialized) {
-        return ESP_ERR_INVALID_STATE;
+    ld2450_cmd_request_t request = {
+        .command = {
+            .command = cmd,
+            .value_len = (uint8_t)value_len,
+            .timeout_ms = timeout_ms,
+        },
+        .auto_config = false,
+        .sync = true,
+    };
+    if (value_len > 0) {
+        memcpy(request.command.value, value, value_len);
+    }
+    
+    // A restart completes only after the module has rebooted
+    uint32_t wait_ms = timeout_ms + LD2450_CMD_SYNC_MARGIN_MS;
+    if (cmd == LD2450_CMD_RESTART_MODULE) {
+        wait_ms += LD2450_RESTART_TIMEOUT_MS;
     }
     
     if (xSemaphoreTake(instance->mutex, pdMS_TO_TICKS(timeout_ms)) != pdTRUE) {
@@ -112,122 +117,167 @@ esp_err_t ld2450_send_command(ld2450_cmd_t cmd, const void *value, size_t value_
         return ESP_ERR_TIMEOUT;
     }
     
-    // Build the command packet
-    size_t cmd_len = build_command_packet(instance, cmd, value, value_len);
-    
-    // Clear UART RX buffer before sending command
-    uart_flush(instance->uart_port);
+    // A caller that gave up waiting may still have a request in the queue or the
+    // engine; the tag tells its completion apart from this one
+    request.sync_seq = ++instance->cmd_sync_seq;
     
-    // Clear UART event queue to ensure no old events interfere
-    uart_event_t event;
-    while (xQueueReceive(instance->uart_queue, &event, 0) == pdTRUE) {
-        // Just drain the queue
+    esp_err_t ret = ld2450_command_enqueue(instance, &request);
+    if (ret == ESP_OK) {
+        int64_t deadline_us = esp_timer_get_time() + (int64_t)wait_ms * 1000;
+        bool done = false;
+        
+        while (!done) {
+            int64_t remaining_us = deadline_us - esp_timer_get_time();
+            if (remaining_us <= 0 ||
+                xSemaphoreTake(instance->cmd_done, pdMS_TO_TICKS((remaining_us + 999) / 1000) + 1) != pdTRUE) {
+                break;
+            }
+            // Stale completions are dropped; requests run in order, so ours comes last
+            done = instance->cmd_sync_done_seq == request.sync_seq;
+        }
+        
+        if (done) {
+            ret = instance->cmd_sync_result;
+            if (ack_buffer != NULL && ack_len != NULL) {
+                memcpy(ack_buffer, instance->ack_buffer, instance->cmd_sync_ack_len);
+                *ack_len = instance->cmd_sync_ack_len;
+            }
+        } else {
+            ESP_LOGE(TAG, "Processing task did not complete command %04x", cmd);
+            ret = ESP_ERR_TIMEOUT;
+        }
     }
     
-    // Send the command
-    int bytes_sent = uart_write_bytes(instance->uart_port, (const char *)instance->cmd_buffer, cmd_len);
-    if (bytes_sent != cmd_len) {
-        ESP_LOGE(TAG, "Failed to send command %04x (sent %d/%zu bytes)", cmd, bytes_sent, cmd_len);
-        xSemaphoreGive(instance->mutex);
-        return ESP_FAIL;
+    xSemaphoreGive(instance->mutex);
+    return ret;
+}
+
+/**
+ * @brief Send a command and collect its ACK on the calling task
+ * 
+ * Used when no processing task is running, or when the processing task itself
+ * issues a command. Received bytes go through the same demultiplexing receive
+ * path, so data frames arriving around the ACK are still delivered. A nested
+ * call from the processing task extracts the ACK and holds the rest for the
+ * frame scanner, which is busy further up its stack. Shared-task instances
+ * refuse nested calls: their UART queues may only be read through the queue set.
+ * 
+ * @param instance Driver instance
+ * @param cmd Command word
+ * @param value Command value buffer
+ * @param value_len Length of the command value in bytes
+ * @param ack_buffer Buffer to store the ACK response
+ * @param ack_len Pointer to store ACK response length
+ * @param timeout_ms Timeout in milliseconds
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+static esp_err_t send_command_direct(ld2450_state_t *instance, ld2450_cmd_t cmd,
+                                     const void *value, size_t value_len,
+                                     uint8_t *ack_buffer, size_t *ack_len, uint32_t timeout_ms)
+{
+    bool nested = instance->auto_processing;
+    uint8_t buffer[LD2450_ACK_BUFFER_SIZE];
+    
+    if (nested && instance->shared_task) {
+        ESP_LOGE(TAG, "Command %04x from a shared-task callback: use ld2450_command_submit()", cmd);
+        return ESP_ERR_INVALID_STATE;
     }
     
-    ESP_LOGD(TAG, "Sent command %04x (%zu bytes):", cmd, cmd_len);
-    ESP_LOG_BUFFER_HEX_LEVEL(TAG, instance->cmd_buffer, cmd_len, ESP_LOG_VERBOSE);
+    if (xSemaphoreTake(instance->mutex, pdMS_TO_TICKS(timeout_ms)) != pdTRUE) {
+        ESP_LOGE(TAG, "Failed to take mutex for command %04x", cmd);
+        return ESP_ERR_TIMEOUT;
+    }
     
-    // Wait for ACK response
-    bool found_header = false;
-    bool found_footer = false;
-    bool found_cmd_echo = false;
-    int idx = 0;
+    ld2450_command_send(instance, cmd, value, value_len, timeout_ms);
     
-    // Use a queue-based approach to check for events
-    TickType_t start_time = xTaskGetTickCount();
-    TickType_t timeout_ticks = pdMS_TO_TICKS(timeout_ms);
-    
-    while ((xTaskGetTickCount() - start_time) < timeout_ticks && idx < LD2450_ACK_BUFFER_SIZE) {
-        // Wait for UART event with timeout
-        if (xQueueReceive(instance->uart_queue, &event, pdMS_TO_TICKS(10)) == pdTRUE) {
-            if (event.type == UART_DATA) {
-                // Read available data
-                int bytes_to_read = MIN(event.size, LD2450_ACK_BUFFER_SIZE - idx);
-                int bytes_read = uart_read_bytes(instance->uart_port, 
-                                                &instance->ack_buffer[idx], 
-                                                bytes_to_read, 
-                                                pdMS_TO_TICKS(10));
-                
-                if (bytes_read > 0) {
-                    // Check for radar data frame header and skip it - this is crucial!
-                    if (!found_header && idx + bytes_read >= 4) {
-                        // Check if we got a radar data frame instead of config ACK
-                        if (memcmp(instance->ack_buffer, LD2450_DATA_FRAME_HEADER, 4) == 0) {
-                            ESP_LOGW(TAG, "Received radar data frame instead of ACK, skipping");
-                            idx = 0; // Reset buffer, this isn't our ACK
-                            continue;
-                        }
-                    }
-                    
-                    idx += bytes_read;
-                    
-                    // Look for config header
-                    if (!found_header && idx >= 4) {
-                        if (memcmp(instance->ack_buffer, LD2450_CONFIG_FRAME_HEADER, 4) == 0) {
-                            found_header = true;
-                            ESP_LOGV(TAG, "Found ACK header");
-                        }
-                    }
-                    
-                    // Look for command echo
-                    if (found_header && !found_cmd_echo && idx >= 8) {
-                        if (instance->ack_buffer[6] == (cmd & 0xFF) && instance->ack_buffer[7] == 0x01) {
-                            found_cmd_echo = true;
-                            ESP_LOGV(TAG, "Found command echo in ACK");
-                        }
-                    }
-                    
-                    // Look for footer
-                    if (found_header && idx >= 12) { // Minimum ACK size with header, length, command, status and footer
-                        if (memcmp(&instance->ack_buffer[idx-4], LD2450_CONFIG_FRAME_FOOTER, 4) == 0) {
-                            found_footer = true;
-                            ESP_LOGV(TAG, "Found ACK footer");
-                            break;
-                        }
-                    }
-                }
+    while (instance->cmd_waiting && esp_timer_get_time() < instance->cmd_deadline_us) {
+        uart_event_t event;
+        if (xQueueReceive(instance->uart_queue, &event, pdMS_TO_TICKS(10)) != pdTRUE) {
+            continue;
+        }
+        if (event.type == LD2450_UART_EVENT_DMA) {
+            ld2450_uhci_service(instance, nested);
+            continue;
+        }
+        if (event.type != UART_DATA) {
+            continue;
+        }
+        
+        size_t remaining = event.size;
+        while (remaining > 0 && instance->cmd_waiting) {
+            int len = uart_read_bytes(instance->uart_port, buffer, MIN(remaining, sizeof(buffer)),
+                                      pdMS_TO_TICKS(10));
+            if (len <= 0) {
+                break;
+            }
+            remaining -= (size_t)len;
+            
+            if (nested) {
+                ld2450_scan_ack(instance, buffer, (size_t)len);
+                ld2450_rx_defer(instance, buffer, (size_t)len);
+            } else {
+                instance->chunk_timestamp_us = esp_timer_get_time();
+                ld2450_uart_event_handler(instance, buffer, (size_t)len);
             }
         }
     }
     
-    if (!found_header || !found_footer) {
-        ESP_LOGE(TAG, "Failed to receive complete ACK for command %04x (got %d bytes)", cmd, idx);
+    esp_err_t ret = instance->cmd_wire_result;
+    
+    if (instance->cmd_waiting) {
+        ESP_LOGE(TAG, "Failed to receive complete ACK for command %04x (got %u bytes)",
+                 cmd, (unsigned)instance->ack_idx);
         
         // Store error data for debugging
-        instance->error_buffer_len = idx > LD2450_ERROR_BUFFER_SIZE ? 
-                                     LD2450_ERROR_BUFFER_SIZE : idx;
-        if (idx > 0) {
-            memcpy(instance->error_buffer, instance->ack_buffer, instance->error_buffer_len);
-            ESP_LOG_BUFFER_HEX_LEVEL(TAG, instance->ack_buffer, idx, ESP_LOG_DEBUG);
-        }
+        instance->error_buffer_len = MIN(instance->ack_idx, LD2450_ERROR_BUFFER_SIZE);
+        memcpy(instance->error_buffer, instance->ack_rx, instance->error_buffer_len);
         
-        xSemaphoreGive(instance->mutex);
-        return ESP_ERR_TIMEOUT;
+        instance->cmd_waiting = false;
+        ret = ESP_ERR_TIMEOUT;
+    } else if (ack_buffer != NULL && ack_len != NULL) {
+        memcpy(ack_buffer, instance->ack_rx, instance->cmd_wire_ack_len);
+        *ack_len = instance->cmd_wire_ack_len;
     }
     
-    ESP_LOGD(TAG, "Received ACK for command %04x (%d bytes):", cmd, idx);
-    ESP_LOG_BUFFER_HEX_LEVEL(TAG, instance->ack_buffer, idx, ESP_LOG_VERBOSE);
-    
-    if (ack_buffer != NULL && ack_len != NULL) {
-        memcpy(ack_buffer, instance->ack_buffer, idx);
-        *ack_len = idx;
+    // Without a processing task to hold later commands, wait for the reboot here
+    if (ret == ESP_OK && cmd == LD2450_CMD_RESTART_MODULE) {
+        vTaskDelay(pdMS_TO_TICKS(LD2450_RESTART_TIMEOUT_MS));
     }
     
-    // Validate ACK
-    ret = ld2450_validate_ack(instance->ack_buffer, idx, cmd);
-    
     xSemaphoreGive(instance->mutex);
     return ret;
 }
 
+/**
+ * @brief Send a command packet and wait for acknowledgement
+ * 
+ * With a processing task the command is queued to it; otherwise (or when called
+ * from that task) the UART is read directly on the calling task.
+ * 
+ * @param instance Driver instance
+ * @param cmd Command word
+ * @param value Command value buffer
+ * @param value_len Length of the command value in bytes
+ * @param ack_buffer Buffer to store the ACK response
+ * @param ack_len Pointer to store ACK response length
+ * @param timeout_ms Timeout in milliseconds
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_send_command(ld2450_state_t *instance, ld2450_cmd_t cmd,
+                             const void *value, size_t value_len,
+                             uint8_t *ack_buffer, size_t *ack_len, uint32_t timeout_ms)
+{
+    if (!instance || !instance->initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    if (ld2450_command_via_task(instance)) {
+        return send_command_via_task(instance, cmd, value, value_len, ack_buffer, ack_len, timeout_ms);
+    }
+    
+    return send_command_direct(instance, cmd, value, value_len, ack_buffer, ack_len, timeout_ms);
+}
+
 /**
  * @brief Validate an ACK response for a specific command
  * 
@@ -271,11 +321,11 @@ esp_err_t ld2450_validate_ack(const uint8_t *ack, size_t len, ld2450_cmd_t cmd)
  * 
  * This function must be called before sending any other configuration commands.
  * 
+ * @param instance Driver instance
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
-esp_err_t ld2450_enter_config_mode(void)
+esp_err_t ld2450_enter_config_mode(ld2450_state_t *instance)
 {
-    ld2450_state_t *instance = ld2450_get_instance();
     
     if (!instance || !instance->initialized) {
         return ESP_ERR_INVALID_STATE;
@@ -286,26 +336,17 @@ esp_err_t ld2450_enter_config_mode(void)
         return ESP_OK;
     }
     
-    // Set config mode flag first to pause normal data processing
-    instance->in_config_mode = true;
-    
-    // Allow time for processing task to respect the flag
-    vTaskDelay(pdMS_TO_TICKS(50));
-    
-    // Flush any pending data in UART buffer
-    uart_flush(instance->uart_port);
-    
     // Command value: 0x0001 (little-endian)
     uint8_t value[2] = {0x01, 0x00};
-    esp_err_t ret = ld2450_send_command(LD2450_CMD_ENABLE_CONFIG, value, sizeof(value), 
+    esp_err_t ret = ld2450_send_command(instance, LD2450_CMD_ENABLE_CONFIG, value, sizeof(value), 
                                        NULL, NULL, LD2450_CONFIG_TIMEOUT_MS);
     
     if (ret == ESP_OK) {
+        // Also set by the processing task when it sees the ACK
+        instance->in_config_mode = true;
         ESP_LOGI(TAG, "Entered configuration mode");
     } else {
         ESP_LOGE(TAG, "Failed to enter configuration mode: %s", esp_err_to_name(ret));
-        // Revert config mode flag on failure
-        instance->in_config_mode = false;
     }
     
     return ret;
@@ -317,11 +358,11 @@ esp_err_t ld2450_enter_config_mode(void)
  * This function must be called after configuration is complete to return
  * the radar to normal operating mode.
  * 
+ * @param instance Driver instance
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
-esp_err_t ld2450_exit_config_mode(void)
+esp_err_t ld2450_exit_config_mode(ld2450_state_t *instance)
 {
-    ld2450_state_t *instance = ld2450_get_instance();
     
     if (!instance || !instance->initialized) {
         return ESP_ERR_INVALID_STATE;
@@ -332,7 +373,7 @@ esp_err_t ld2450_exit_config_mode(void)
         return ESP_OK;
     }
     
-    esp_err_t ret = ld2450_send_command(LD2450_CMD_END_CONFIG, NULL, 0, 
+    esp_err_t ret = ld2450_send_command(instance, LD2450_CMD_END_CONFIG, NULL, 0, 
                                        NULL, NULL, LD2450_CONFIG_TIMEOUT_MS);
     
     if (ret == ESP_OK) {
@@ -345,23 +386,131 @@ esp_err_t ld2450_exit_config_mode(void)
     return ret;
 }
 
+/**
+ * @brief Enter configuration mode for a single operation
+ * 
+ * No-op while a ld2450_config_begin() session is open.
+ * 
+ * @param instance Driver instance
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+static esp_err_t config_op_begin(ld2450_state_t *instance)
+{
+    if (instance->config_session) {
+        return ESP_OK;
+    }
+    
+    return ld2450_enter_config_mode(instance);
+}
+
+/**
+ * @brief Finish a single operation started with config_op_begin()
+ * 
+ * Exits configuration mode, or inside a session records the first failure
+ * for ld2450_config_commit() and leaves the module in configuration mode.
+ * 
+ * @param instance Driver instance
+ * @param ret Result of the operation
+ * @return esp_err_t The operation result, or the exit error if the operation succeeded
+ */
+static esp_err_t config_op_end(ld2450_state_t *instance, esp_err_t ret)
+{
+    if (instance->config_session) {
+        if (ret != ESP_OK && instance->config_session_err == ESP_OK) {
+            instance->config_session_err = ret;
+        }
+        return ret;
+    }
+    
+    esp_err_t exit_ret = ld2450_exit_config_mode(instance);
+    
+    // Return the first error if any
+    return (ret != ESP_OK) ? ret : exit_ret;
+}
+
+/**
+ * @brief Open a configuration session
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_config_begin(ld2450_handle_t handle)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    if (instance->config_session) {
+        ESP_LOGW(TAG, "Configuration session already open");
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    esp_err_t ret = ld2450_enter_config_mode(instance);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    
+    instance->config_session = true;
+    instance->config_session_err = ESP_OK;
+    
+    return ESP_OK;
+}
+
+/**
+ * @brief Close a configuration session and return the radar to normal operation
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @return esp_err_t ESP_OK if every operation in the session and the exit succeeded,
+ *         otherwise the first error encountered
+ */
+esp_err_t ld2450_config_commit(ld2450_handle_t handle)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    if (!instance->config_session) {
+        ESP_LOGW(TAG, "No configuration session open");
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    esp_err_t ret = instance->config_session_err;
+    instance->config_session = false;
+    
+    // A session ends even when exiting fails, so a later begin can try again
+    esp_err_t exit_ret = ld2450_exit_config_mode(instance);
+    
+    return (ret != ESP_OK) ? ret : exit_ret;
+}
+
 /**
  * @brief Set target tracking mode
  * 
+ * @param handle Driver handle (NULL for the default instance)
  * @param mode Tracking mode to set
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
-esp_err_t ld2450_set_tracking_mode(ld2450_tracking_mode_t mode)
+esp_err_t ld2450_dev_set_tracking_mode(ld2450_handle_t handle, ld2450_tracking_mode_t mode)
 {
-    ld2450_state_t *instance = ld2450_get_instance();
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
     esp_err_t ret;
     
     if (!instance || !instance->initialized) {
         return ESP_ERR_INVALID_STATE;
     }
     
-    // Enter configuration mode
-    ret = ld2450_enter_config_mode();
+    // Skip the write if the module already runs this mode
+    uint8_t cached = (uint8_t)mode;
+    if (ld2450_cache_matches(instance, LD2450_CACHE_TRACKING, &cached, sizeof(cached))) {
+        return ESP_OK;
+    }
+    
+    // Enter configuration mode unless a session is already open
+    ret = config_op_begin(instance);
     if (ret != ESP_OK) {
         return ret;
     }
@@ -370,24 +519,37 @@ esp_err_t ld2450_set_tracking_mode(ld2450_tracking_mode_t mode)
     ld2450_cmd_t cmd = (mode == LD2450_MODE_SINGLE_TARGET) ? 
                        LD2450_CMD_SINGLE_TARGET : LD2450_CMD_MULTI_TARGET;
     
-    ret = ld2450_send_command(cmd, NULL, 0, NULL, NULL, LD2450_CONFIG_TIMEOUT_MS);
+    ret = ld2450_send_command(instance, cmd, NULL, 0, NULL, NULL, LD2450_CONFIG_TIMEOUT_MS);
     
-    // Exit configuration mode
-    esp_err_t exit_ret = ld2450_exit_config_mode();
+    if (ret == ESP_OK) {
+        ld2450_cache_store(instance, LD2450_CACHE_TRACKING, &cached, sizeof(cached));
+    }
     
-    // Return the first error if any
-    return (ret != ESP_OK) ? ret : exit_ret;
+    // Exit configuration mode unless a session is open
+    return config_op_end(instance, ret);
+}
+
+/**
+ * @brief Set target tracking mode
+ * 
+ * @param mode Tracking mode to set
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_set_tracking_mode(ld2450_tracking_mode_t mode)
+{
+    return ld2450_dev_set_tracking_mode(NULL, mode);
 }
 
 /**
  * @brief Get current target tracking mode
  * 
+ * @param handle Driver handle (NULL for the default instance)
  * @param mode Pointer to store the current tracking mode
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
-esp_err_t ld2450_get_tracking_mode(ld2450_tracking_mode_t *mode)
+esp_err_t ld2450_dev_get_tracking_mode(ld2450_handle_t handle, ld2450_tracking_mode_t *mode)
 {
-    ld2450_state_t *instance = ld2450_get_instance();
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
     esp_err_t ret;
     size_t ack_len;
     uint8_t ack_buffer[LD2450_ACK_BUFFER_SIZE];
@@ -396,14 +558,20 @@ esp_err_t ld2450_get_tracking_mode(ld2450_tracking_mode_t *mode)
         return ESP_ERR_INVALID_ARG;
     }
     
-    // Enter configuration mode
-    ret = ld2450_enter_config_mode();
+    uint8_t cached;
+    if (ld2450_cache_load(instance, LD2450_CACHE_TRACKING, &cached, sizeof(cached))) {
+        *mode = (ld2450_tracking_mode_t)cached;
+        return ESP_OK;
+    }
+    
+    // Enter configuration mode unless a session is already open
+    ret = config_op_begin(instance);
     if (ret != ESP_OK) {
         return ret;
     }
     
     // Query tracking mode
-    ret = ld2450_send_command(LD2450_CMD_QUERY_TARGET_MODE, NULL, 0, 
+    ret = ld2450_send_command(instance, LD2450_CMD_QUERY_TARGET_MODE, NULL, 0, 
                              ack_buffer, &ack_len, LD2450_CONFIG_TIMEOUT_MS);
     
     if (ret == ESP_OK && ack_len >= 12) {
@@ -422,109 +590,150 @@ esp_err_t ld2450_get_tracking_mode(ld2450_tracking_mode_t *mode)
                 ret = ESP_ERR_INVALID_RESPONSE;
                 break;
         }
+        
+        if (ret == ESP_OK) {
+            cached = (uint8_t)*mode;
+            ld2450_cache_store(instance, LD2450_CACHE_TRACKING, &cached, sizeof(cached));
+        }
+    }
+    
+    // Exit configuration mode unless a session is open
+    return config_op_end(instance, ret);
+}
+
+/**
+ * @brief Get current target tracking mode
+ * 
+ * @param mode Pointer to store the current tracking mode
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_get_tracking_mode(ld2450_tracking_mode_t *mode)
+{
+    return ld2450_dev_get_tracking_mode(NULL, mode);
+}
+
+/**
+ * @brief Decode a firmware version ACK
+ * 
+ * @param ack ACK frame
+ * @param len ACK frame length
+ * @param version Decoded version
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_RESPONSE if the ACK is too short
+ */
+esp_err_t ld2450_parse_firmware_ack(const uint8_t *ack, size_t len, ld2450_firmware_version_t *version)
+{
+    if (len < 22) {
+        return ESP_ERR_INVALID_RESPONSE;
     }
     
-    // Exit configuration mode
-    esp_err_t exit_ret = ld2450_exit_config_mode();
+    // Zero padding and string tail so cached copies compare byte for byte
+    memset(version, 0, sizeof(*version));
     
-    // Return the first error if any
-    return (ret != ESP_OK) ? ret : exit_ret;
+    // Extract firmware version information based on protocol documentation
+    // Main version is at offset 12-13 (little-endian)
+    version->main_version = ack[12] | (ack[13] << 8);
+    
+    // Sub-version is at offset 14-17 (little-endian)
+    version->sub_version = ack[14] | 
+                          (ack[15] << 8) | 
+                          ((uint32_t)ack[16] << 16) | 
+                          ((uint32_t)ack[17] << 24);
+    
+    // Format version string according to the protocol example (V1.02.22062416)
+    // Per protocol: high byte is first digit, low byte is digits after first dot
+    snprintf(version->version_string, sizeof(version->version_string),
+            "V%u.%02u.%08lu", 
+            (version->main_version >> 8) & 0xFF,  // High byte (0x01 -> 1)
+            version->main_version & 0xFF,        // Low byte (0x02 -> 02)
+            (unsigned long)version->sub_version); // Sub-version (0x22062416 -> 22062416)
+    
+    return ESP_OK;
 }
 
 /**
- * @brief Get firmware version information
+ * @brief Read the firmware version from the module, bypassing the cache
  * 
+ * Used wherever the answer itself matters, such as confirming the link after a
+ * baud rate switch. A successful read refreshes the cache.
+ * 
+ * @param instance Driver instance
  * @param version Pointer to structure to store version information
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
-esp_err_t ld2450_get_firmware_version(ld2450_firmware_version_t *version)
+static esp_err_t read_firmware_uncached(ld2450_state_t *instance, ld2450_firmware_version_t *version)
 {
-    ld2450_state_t *instance = ld2450_get_instance();
     esp_err_t ret;
     size_t ack_len;
     uint8_t ack_buffer[LD2450_ACK_BUFFER_SIZE];
     
-    if (!instance || !instance->initialized || !version) {
-        return ESP_ERR_INVALID_ARG;
-    }
-    
-    // Enter configuration mode
-    ret = ld2450_enter_config_mode();
+    // Enter configuration mode unless a session is already open
+    ret = config_op_begin(instance);
     if (ret != ESP_OK) {
         return ret;
     }
     
-    // Allow extra settling time after entering config mode
-    vTaskDelay(pdMS_TO_TICKS(100));
-    
-    // Flush any pending data in UART buffer before sending command
-    uart_flush(instance->uart_port);
+    // The command engine waits for the ACK itself, so no settling delay or retries are needed
+    ret = ld2450_send_command(instance, LD2450_CMD_READ_FW_VERSION, NULL, 0, 
+                             ack_buffer, &ack_len, LD2450_CONFIG_TIMEOUT_MS);
     
-    // Clear UART event queue to ensure no old events interfere
-    uart_event_t event;
-    while (xQueueReceive(instance->uart_queue, &event, 0) == pdTRUE) {
-        // Just drain the queue
+    if (ret == ESP_OK) {
+        ret = ld2450_parse_firmware_ack(ack_buffer, ack_len, version);
     }
     
-    // Try up to 3 times with shorter timeout
-    for (int attempt = 0; attempt < 3; attempt++) {
-        ESP_LOGI(TAG, "Querying firmware version, attempt %d", attempt + 1);
-        
-        // Query firmware version with a shorter timeout (1 second instead of 3)
-        ret = ld2450_send_command(LD2450_CMD_READ_FW_VERSION, NULL, 0, 
-                                 ack_buffer, &ack_len, 1000);
-        
-        if (ret == ESP_OK && ack_len >= 22) {
-            // Extract firmware version information based on protocol documentation
-            // Main version is at offset 12-13 (little-endian)
-            version->main_version = ack_buffer[12] | (ack_buffer[13] << 8);
-            
-            // Sub-version is at offset 14-17 (little-endian)
-            version->sub_version = ack_buffer[14] | 
-                                  (ack_buffer[15] << 8) | 
-                                  ((uint32_t)ack_buffer[16] << 16) | 
-                                  ((uint32_t)ack_buffer[17] << 24);
-            
-            // Format version string according to the protocol example (V1.02.22062416)
-            // Per protocol: high byte is first digit, low byte is digits after first dot
-            snprintf(version->version_string, sizeof(version->version_string),
-                    "V%u.%02u.%08lu", 
-                    (version->main_version >> 8) & 0xFF,  // High byte (0x01 -> 1)
-                    version->main_version & 0xFF,        // Low byte (0x02 -> 02)
-                    (unsigned long)version->sub_version); // Sub-version (0x22062416 -> 22062416)
-            
-            ESP_LOGI(TAG, "Firmware version: %s", version->version_string);
-            break; // Success, exit retry loop
-        } else {
-            ESP_LOGW(TAG, "Attempt %d failed, %s", attempt + 1, esp_err_to_name(ret));
-            // Short delay before retrying
-            vTaskDelay(pdMS_TO_TICKS(200));
-            // Flush UART again
-            uart_flush(instance->uart_port);
-        }
+    if (ret == ESP_OK) {
+        ESP_LOGI(TAG, "Firmware version: %s", version->version_string);
+        ld2450_cache_store(instance, LD2450_CACHE_FIRMWARE, version, sizeof(*version));
+    } else {
+        ESP_LOGE(TAG, "Failed to read firmware version: %s", esp_err_to_name(ret));
     }
     
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to read firmware version after multiple attempts");
-        ret = ESP_ERR_INVALID_RESPONSE;
+    // Exit configuration mode unless a session is open
+    return config_op_end(instance, ret);
+}
+
+/**
+ * @brief Get firmware version information
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param version Pointer to structure to store version information
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_dev_get_firmware_version(ld2450_handle_t handle, ld2450_firmware_version_t *version)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized || !version) {
+        return ESP_ERR_INVALID_ARG;
     }
     
-    // Exit configuration mode
-    esp_err_t exit_ret = ld2450_exit_config_mode();
+    if (ld2450_cache_load(instance, LD2450_CACHE_FIRMWARE, version, sizeof(*version))) {
+        return ESP_OK;
+    }
     
-    // Return the first error if any
-    return (ret != ESP_OK) ? ret : exit_ret;
+    return read_firmware_uncached(instance, version);
+}
+
+/**
+ * @brief Get firmware version information
+ * 
+ * @param version Pointer to structure to store version information
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_get_firmware_version(ld2450_firmware_version_t *version)
+{
+    return ld2450_dev_get_firmware_version(NULL, version);
 }
 
 /**
  * @brief Set serial port baud rate
  * 
+ * @param handle Driver handle (NULL for the default instance)
  * @param baud_rate Baud rate to set
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
-esp_err_t ld2450_set_baud_rate(ld2450_baud_rate_t baud_rate)
+esp_err_t ld2450_dev_set_baud_rate(ld2450_handle_t handle, ld2450_baud_rate_t baud_rate)
 {
-    ld2450_state_t *instance = ld2450_get_instance();
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
     esp_err_t ret;
     
     if (!instance || !instance->initialized) {
@@ -537,15 +746,15 @@ esp_err_t ld2450_set_baud_rate(ld2450_baud_rate_t baud_rate)
         return ESP_ERR_INVALID_ARG;
     }
     
-    // Enter configuration mode
-    ret = ld2450_enter_config_mode();
+    // Enter configuration mode unless a session is already open
+    ret = config_op_begin(instance);
     if (ret != ESP_OK) {
         return ret;
     }
     
     // Set baud rate (little-endian)
     uint8_t value[2] = {baud_rate & 0xFF, (baud_rate >> 8) & 0xFF};
-    ret = ld2450_send_command(LD2450_CMD_SET_BAUD_RATE, value, sizeof(value), 
+    ret = ld2450_send_command(instance, LD2450_CMD_SET_BAUD_RATE, value, sizeof(value), 
                              NULL, NULL, LD2450_CONFIG_TIMEOUT_MS);
     
     if (ret == ESP_OK) {
@@ -554,140 +763,404 @@ esp_err_t ld2450_set_baud_rate(ld2450_baud_rate_t baud_rate)
         ESP_LOGE(TAG, "Failed to set baud rate: %s", esp_err_to_name(ret));
     }
     
-    // Exit configuration mode
-    esp_err_t exit_ret = ld2450_exit_config_mode();
+    // Exit configuration mode unless a session is open
+    return config_op_end(instance, ret);
+}
+
+/**
+ * @brief Set serial port baud rate
+ * 
+ * @param baud_rate Baud rate to set
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_set_baud_rate(ld2450_baud_rate_t baud_rate)
+{
+    return ld2450_dev_set_baud_rate(NULL, baud_rate);
+}
+
+/**
+ * @brief Convert a baud rate setting to bits per second
+ * 
+ * @param baud_rate Baud rate setting
+ * @return Bits per second, 0 for an invalid setting
+ */
+uint32_t ld2450_baud_rate_to_bps(ld2450_baud_rate_t baud_rate)
+{
+    static const uint32_t bps[] = {
+        0, 9600, 19200, 38400, 57600, 115200, 230400, 256000, 460800
+    };
     
-    // Return the first error if any
-    return (ret != ESP_OK) ? ret : exit_ret;
+    if (baud_rate < LD2450_BAUD_9600 || baud_rate > LD2450_BAUD_460800) {
+        return 0;
+    }
+    
+    return bps[baud_rate];
+}
+
+/**
+ * @brief Reconfigure the host UART of an instance to a new baud rate
+ * 
+ * @param instance Driver instance
+ * @param bps Bits per second
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_set_host_baud(ld2450_state_t *instance, uint32_t bps)
+{
+    esp_err_t ret = uart_set_baudrate(instance->uart_port, bps);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set UART%d to %" PRIu32 " baud: %s",
+                 (int)instance->uart_port, bps, esp_err_to_name(ret));
+        return ret;
+    }
+    
+    instance->baud_rate = bps;
+    instance->byte_time_ns = 10000000000ULL / bps;
+    
+    return ESP_OK;
+}
+
+/**
+ * @brief Switch the module and the host UART to a new baud rate
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param baud_rate Baud rate to switch to
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_STATE inside a configuration
+ *         session, error code otherwise
+ */
+esp_err_t ld2450_switch_baud_rate(ld2450_handle_t handle, ld2450_baud_rate_t baud_rate)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    ld2450_firmware_version_t version;
+    esp_err_t ret;
+    
+    if (!instance || !instance->initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    uint32_t bps = ld2450_baud_rate_to_bps(baud_rate);
+    if (bps == 0) {
+        ESP_LOGE(TAG, "Invalid baud rate: %d", baud_rate);
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    // The restart would end the session behind the caller's back
+    if (instance->config_session) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    if (instance->baud_rate == bps) {
+        return ESP_OK;
+    }
+    
+    uint32_t old_bps = instance->baud_rate;
+    
+    ret = ld2450_dev_set_baud_rate(instance, baud_rate);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    
+    // Returns once the module has rebooted at the new rate
+    ret = ld2450_dev_restart_module(instance);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    
+    ret = ld2450_set_host_baud(instance, bps);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    
+    // A cached version would confirm a dead link: the module has to answer
+    ret = read_firmware_uncached(instance, &version);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "No response at %" PRIu32 " baud, reverting host to %" PRIu32, bps, old_bps);
+        ld2450_set_host_baud(instance, old_bps);
+        return ret;
+    }
+    
+    ESP_LOGI(TAG, "Link switched to %" PRIu32 " baud", bps);
+    return ESP_OK;
+}
+
+/**
+ * @brief Check whether the module answers at the host UART's current rate
+ * 
+ * Listens for a valid data frame first; a module in configuration mode or with
+ * reporting stalled is probed with an enable-configuration command instead.
+ * 
+ * @param instance Driver instance
+ * @return true if the module answered
+ */
+static bool baud_probe(ld2450_state_t *instance)
+{
+    uint32_t frames = instance->sync_stats.frames_ok;
+    
+    // Data frames are only scanned when something reads the UART: with a processing task.
+    // The module streams at 10 Hz, so a live rate usually answers well before the window ends.
+    if (instance->auto_processing) {
+        int64_t deadline_us = esp_timer_get_time() + (int64_t)LD2450_AUTOBAUD_LISTEN_MS * 1000;
+        do {
+            vTaskDelay(MAX(pdMS_TO_TICKS(LD2450_AUTOBAUD_POLL_MS), 1));
+            if (instance->sync_stats.frames_ok != frames) {
+                return true;
+            }
+        } while (esp_timer_get_time() < deadline_us);
+    }
+    
+    uint8_t value[2] = {0x01, 0x00};
+    if (ld2450_send_command(instance, LD2450_CMD_ENABLE_CONFIG, value, sizeof(value),
+                            NULL, NULL, LD2450_AUTOBAUD_CMD_TIMEOUT_MS) != ESP_OK) {
+        return instance->sync_stats.frames_ok != frames;
+    }
+    
+    ld2450_exit_config_mode(instance);
+    return true;
+}
+
+/**
+ * @brief Find the baud rate the module is transmitting at
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param detected Pointer to store the detected rate (may be NULL)
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_FOUND if no rate answered, error code otherwise
+ */
+esp_err_t ld2450_detect_baud_rate(ld2450_handle_t handle, ld2450_baud_rate_t *detected)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    if (instance->config_session) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    uint32_t old_bps = instance->baud_rate;
+    
+    // Current rate first, then the factory default, then the rest from fastest down
+    ld2450_baud_rate_t order[LD2450_BAUD_460800];
+    size_t count = 0;
+    for (int rate = LD2450_BAUD_460800; rate >= LD2450_BAUD_9600; rate--) {
+        if (ld2450_baud_rate_to_bps(rate) == old_bps) {
+            order[count++] = rate;
+        }
+    }
+    if (old_bps != ld2450_baud_rate_to_bps(LD2450_BAUD_256000)) {
+        order[count++] = LD2450_BAUD_256000;
+    }
+    for (int rate = LD2450_BAUD_460800; rate >= LD2450_BAUD_9600; rate--) {
+        uint32_t bps = ld2450_baud_rate_to_bps(rate);
+        if (bps != old_bps && rate != LD2450_BAUD_256000) {
+            order[count++] = rate;
+        }
+    }
+    
+    for (size_t i = 0; i < count; i++) {
+        uint32_t bps = ld2450_baud_rate_to_bps(order[i]);
+        
+        if (bps != instance->baud_rate && ld2450_set_host_baud(instance, bps) != ESP_OK) {
+            continue;
+        }
+        
+        ESP_LOGD(TAG, "Probing %" PRIu32 " baud", bps);
+        if (baud_probe(instance)) {
+            ESP_LOGI(TAG, "Module detected at %" PRIu32 " baud", bps);
+            if (detected) {
+                *detected = order[i];
+            }
+            return ESP_OK;
+        }
+    }
+    
+    ESP_LOGW(TAG, "Module not detected at any baud rate");
+    ld2450_set_host_baud(instance, old_bps);
+    return ESP_ERR_NOT_FOUND;
 }
 
 /**
  * @brief Restore factory default settings
  * 
+ * @param handle Driver handle (NULL for the default instance)
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
-esp_err_t ld2450_restore_factory_settings(void)
+esp_err_t ld2450_dev_restore_factory_settings(ld2450_handle_t handle)
 {
-    ld2450_state_t *instance = ld2450_get_instance();
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
     esp_err_t ret;
     
     if (!instance || !instance->initialized) {
         return ESP_ERR_INVALID_STATE;
     }
     
-    // Enter configuration mode
-    ret = ld2450_enter_config_mode();
+    // Enter configuration mode unless a session is already open
+    ret = config_op_begin(instance);
     if (ret != ESP_OK) {
         return ret;
     }
     
     // Restore factory settings
-    ret = ld2450_send_command(LD2450_CMD_RESTORE_FACTORY, NULL, 0, 
+    ret = ld2450_send_command(instance, LD2450_CMD_RESTORE_FACTORY, NULL, 0, 
                              NULL, NULL, LD2450_CONFIG_TIMEOUT_MS);
     
     if (ret == ESP_OK) {
         ESP_LOGI(TAG, "Factory settings restored");
+        ld2450_cache_invalidate(instance, LD2450_CACHE_SETTINGS);
     } else {
         ESP_LOGE(TAG, "Failed to restore factory settings: %s", esp_err_to_name(ret));
     }
     
-    // Exit configuration mode
-    esp_err_t exit_ret = ld2450_exit_config_mode();
-    
-    // Return the first error if any
-    return (ret != ESP_OK) ? ret : exit_ret;
+    // Exit configuration mode unless a session is open
+    return config_op_end(instance, ret);
+}
+
+/**
+ * @brief Restore factory default settings
+ * 
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_restore_factory_settings(void)
+{
+    return ld2450_dev_restore_factory_settings(NULL);
 }
 
 /**
  * @brief Restart the radar module
  * 
+ * @param handle Driver handle (NULL for the default instance)
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
-esp_err_t ld2450_restart_module(void)
+esp_err_t ld2450_dev_restart_module(ld2450_handle_t handle)
 {
-    ld2450_state_t *instance = ld2450_get_instance();
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
     esp_err_t ret;
     
     if (!instance || !instance->initialized) {
         return ESP_ERR_INVALID_STATE;
     }
     
-    // Enter configuration mode
-    ret = ld2450_enter_config_mode();
+    // Enter configuration mode unless a session is already open
+    ret = config_op_begin(instance);
     if (ret != ESP_OK) {
         return ret;
     }
     
     // Restart module
-    ret = ld2450_send_command(LD2450_CMD_RESTART_MODULE, NULL, 0, 
+    ret = ld2450_send_command(instance, LD2450_CMD_RESTART_MODULE, NULL, 0, 
                              NULL, NULL, LD2450_CONFIG_TIMEOUT_MS);
     
     if (ret == ESP_OK) {
-        ESP_LOGI(TAG, "Module restart command sent successfully");
+        // ld2450_send_command() returns once the module has rebooted
+        ESP_LOGI(TAG, "Module restarted");
         
-        // Wait for module to restart
-        vTaskDelay(pdMS_TO_TICKS(LD2450_RESTART_TIMEOUT_MS));
-        
-        // Reset configuration mode state since module restarted
+        // Reset configuration mode state since module restarted; this ends any session
         instance->in_config_mode = false;
+        instance->config_session = false;
     } else {
         ESP_LOGE(TAG, "Failed to restart module: %s", esp_err_to_name(ret));
         
         // Try to exit configuration mode
-        ld2450_exit_config_mode();
+        config_op_end(instance, ret);
     }
     
     return ret;
 }
 
+/**
+ * @brief Restart the radar module
+ * 
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_restart_module(void)
+{
+    return ld2450_dev_restart_module(NULL);
+}
+
 /**
  * @brief Enable or disable Bluetooth functionality
  * 
+ * @param handle Driver handle (NULL for the default instance)
  * @param enable true to enable Bluetooth, false to disable
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
-esp_err_t ld2450_set_bluetooth(bool enable)
+esp_err_t ld2450_dev_set_bluetooth(ld2450_handle_t handle, bool enable)
 {
-    ld2450_state_t *instance = ld2450_get_instance();
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
     esp_err_t ret;
     
     if (!instance || !instance->initialized) {
         return ESP_ERR_INVALID_STATE;
     }
     
-    // Enter configuration mode
-    ret = ld2450_enter_config_mode();
+    // Skip the write if the module already has this state
+    uint8_t cached = enable ? 1 : 0;
+    if (ld2450_cache_matches(instance, LD2450_CACHE_BLUETOOTH, &cached, sizeof(cached))) {
+        return ESP_OK;
+    }
+    
+    // Enter configuration mode unless a session is already open
+    ret = config_op_begin(instance);
     if (ret != ESP_OK) {
         return ret;
     }
     
     // Set Bluetooth state (little-endian)
     uint8_t value[2] = {enable ? 0x01 : 0x00, 0x00};
-    ret = ld2450_send_command(LD2450_CMD_SET_BLUETOOTH, value, sizeof(value), 
+    ret = ld2450_send_command(instance, LD2450_CMD_SET_BLUETOOTH, value, sizeof(value), 
                              NULL, NULL, LD2450_CONFIG_TIMEOUT_MS);
     
     if (ret == ESP_OK) {
         ESP_LOGI(TAG, "Bluetooth %s", enable ? "enabled" : "disabled");
+        ld2450_cache_store(instance, LD2450_CACHE_BLUETOOTH, &cached, sizeof(cached));
     } else {
         ESP_LOGE(TAG, "Failed to set Bluetooth state: %s", esp_err_to_name(ret));
     }
     
-    // Exit configuration mode
-    esp_err_t exit_ret = ld2450_exit_config_mode();
+    // Exit configuration mode unless a session is open
+    return config_op_end(instance, ret);
+}
+
+/**
+ * @brief Enable or disable Bluetooth functionality
+ * 
+ * @param enable true to enable Bluetooth, false to disable
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_set_bluetooth(bool enable)
+{
+    return ld2450_dev_set_bluetooth(NULL, enable);
+}
+
+/**
+ * @brief Decode a MAC address ACK
+ * 
+ * @param ack ACK frame
+ * @param len ACK frame length
+ * @param mac Decoded MAC address
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_RESPONSE if the ACK is too short
+ */
+esp_err_t ld2450_parse_mac_ack(const uint8_t *ack, size_t len, uint8_t mac[6])
+{
+    if (len < 16) {
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    
+    // MAC address is 6 bytes starting at offset 10
+    memcpy(mac, &ack[10], 6);
     
-    // Return the first error if any
-    return (ret != ESP_OK) ? ret : exit_ret;
+    return ESP_OK;
 }
 
 /**
  * @brief Get the module's MAC address
  * 
+ * @param handle Driver handle (NULL for the default instance)
  * @param mac Buffer to store the 6-byte MAC address
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
-esp_err_t ld2450_get_mac_address(uint8_t mac[6])
+esp_err_t ld2450_dev_get_mac_address(ld2450_handle_t handle, uint8_t mac[6])
 {
-    ld2450_state_t *instance = ld2450_get_instance();
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
     esp_err_t ret;
     size_t ack_len;
     uint8_t ack_buffer[LD2450_ACK_BUFFER_SIZE];
@@ -696,53 +1169,72 @@ esp_err_t ld2450_get_mac_address(uint8_t mac[6])
         return ESP_ERR_INVALID_ARG;
     }
     
-    // Enter configuration mode
-    ret = ld2450_enter_config_mode();
+    if (ld2450_cache_load(instance, LD2450_CACHE_MAC, mac, 6)) {
+        return ESP_OK;
+    }
+    
+    // Enter configuration mode unless a session is already open
+    ret = config_op_begin(instance);
     if (ret != ESP_OK) {
         return ret;
     }
     
     // Command value: 0x0001 (little-endian)
     uint8_t value[2] = {0x01, 0x00};
-    ret = ld2450_send_command(LD2450_CMD_GET_MAC_ADDRESS, value, sizeof(value), 
+    ret = ld2450_send_command(instance, LD2450_CMD_GET_MAC_ADDRESS, value, sizeof(value), 
                              ack_buffer, &ack_len, LD2450_CONFIG_TIMEOUT_MS);
     
-    if (ret == ESP_OK && ack_len >= 16) {
-        // Extract MAC address (6 bytes starting at offset 10)
-        memcpy(mac, &ack_buffer[10], 6);
-        
+    if (ret == ESP_OK && ld2450_parse_mac_ack(ack_buffer, ack_len, mac) == ESP_OK) {
         ESP_LOGI(TAG, "MAC Address: %02X:%02X:%02X:%02X:%02X:%02X",
                 mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+        ld2450_cache_store(instance, LD2450_CACHE_MAC, mac, 6);
     } else {
         ESP_LOGE(TAG, "Failed to get MAC address or invalid response");
         ret = ESP_ERR_INVALID_RESPONSE;
     }
     
-    // Exit configuration mode
-    esp_err_t exit_ret = ld2450_exit_config_mode();
-    
-    // Return the first error if any
-    return (ret != ESP_OK) ? ret : exit_ret;
+    // Exit configuration mode unless a session is open
+    return config_op_end(instance, ret);
+}
+
+/**
+ * @brief Get the module's MAC address
+ * 
+ * @param mac Buffer to store the 6-byte MAC address
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_get_mac_address(uint8_t mac[6])
+{
+    return ld2450_dev_get_mac_address(NULL, mac);
 }
 
 /**
  * @brief Set region filtering configuration
  * 
+ * @param handle Driver handle (NULL for the default instance)
  * @param type Filtering type (disabled, include only, exclude)
  * @param regions Array of 3 region definitions
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
-esp_err_t ld2450_set_region_filter(ld2450_filter_type_t type, const ld2450_region_t regions[3])
+esp_err_t ld2450_dev_set_region_filter(ld2450_handle_t handle, ld2450_filter_type_t type,
+                                      const ld2450_region_t regions[3])
 {
-    ld2450_state_t *instance = ld2450_get_instance();
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
     esp_err_t ret;
     
     if (!instance || !instance->initialized || !regions) {
         return ESP_ERR_INVALID_ARG;
     }
     
-    // Enter configuration mode
-    ret = ld2450_enter_config_mode();
+    // Skip the write if the module already has this filter
+    ld2450_cache_region_t cached = { .type = (uint16_t)type };
+    memcpy(cached.regions, regions, sizeof(cached.regions));
+    if (ld2450_cache_matches(instance, LD2450_CACHE_REGION, &cached, sizeof(cached))) {
+        return ESP_OK;
+    }
+    
+    // Enter configuration mode unless a session is already open
+    ret = config_op_begin(instance);
     if (ret != ESP_OK) {
         return ret;
     }
@@ -771,32 +1263,44 @@ esp_err_t ld2450_set_region_filter(ld2450_filter_type_t type, const ld2450_regio
     }
     
     // Send command
-    ret = ld2450_send_command(LD2450_CMD_SET_REGION, value, sizeof(value), 
+    ret = ld2450_send_command(instance, LD2450_CMD_SET_REGION, value, sizeof(value), 
                              NULL, NULL, LD2450_CONFIG_TIMEOUT_MS);
     
     if (ret == ESP_OK) {
         ESP_LOGI(TAG, "Region filtering set to type %d", type);
+        ld2450_cache_store(instance, LD2450_CACHE_REGION, &cached, sizeof(cached));
     } else {
         ESP_LOGE(TAG, "Failed to set region filtering: %s", esp_err_to_name(ret));
     }
     
-    // Exit configuration mode
-    esp_err_t exit_ret = ld2450_exit_config_mode();
-    
-    // Return the first error if any
-    return (ret != ESP_OK) ? ret : exit_ret;
+    // Exit configuration mode unless a session is open
+    return config_op_end(instance, ret);
+}
+
+/**
+ * @brief Set region filtering configuration
+ * 
+ * @param type Filtering type (disabled, include only, exclude)
+ * @param regions Array of 3 region definitions
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_set_region_filter(ld2450_filter_type_t type, const ld2450_region_t regions[3])
+{
+    return ld2450_dev_set_region_filter(NULL, type, regions);
 }
 
 /**
  * @brief Query current region filtering configuration
  * 
+ * @param handle Driver handle (NULL for the default instance)
  * @param type Pointer to store the filtering type
  * @param regions Array of 3 region definitions to store the current configuration
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
-esp_err_t ld2450_get_region_filter(ld2450_filter_type_t *type, ld2450_region_t regions[3])
+esp_err_t ld2450_dev_get_region_filter(ld2450_handle_t handle, ld2450_filter_type_t *type,
+                                      ld2450_region_t regions[3])
 {
-    ld2450_state_t *instance = ld2450_get_instance();
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
     esp_err_t ret;
     size_t ack_len;
     uint8_t ack_buffer[LD2450_ACK_BUFFER_SIZE];
@@ -805,14 +1309,21 @@ esp_err_t ld2450_get_region_filter(ld2450_filter_type_t *type, ld2450_region_t r
         return ESP_ERR_INVALID_ARG;
     }
     
-    // Enter configuration mode
-    ret = ld2450_enter_config_mode();
+    ld2450_cache_region_t cached;
+    if (ld2450_cache_load(instance, LD2450_CACHE_REGION, &cached, sizeof(cached))) {
+        *type = (ld2450_filter_type_t)cached.type;
+        memcpy(regions, cached.regions, sizeof(cached.regions));
+        return ESP_OK;
+    }
+    
+    // Enter configuration mode unless a session is already open
+    ret = config_op_begin(instance);
     if (ret != ESP_OK) {
         return ret;
     }
     
     // Query region filtering
-    ret = ld2450_send_command(LD2450_CMD_QUERY_REGION, NULL, 0, 
+    ret = ld2450_send_command(instance, LD2450_CMD_QUERY_REGION, NULL, 0, 
                              ack_buffer, &ack_len, LD2450_CONFIG_TIMEOUT_MS);
     
     if (ret == ESP_OK && ack_len >= 40) {
@@ -843,14 +1354,27 @@ esp_err_t ld2450_get_region_filter(ld2450_filter_type_t *type, ld2450_region_t r
                          i + 1, regions[i].x1, regions[i].y1, regions[i].x2, regions[i].y2);
             }
         }
+        
+        cached.type = (uint16_t)*type;
+        memcpy(cached.regions, regions, sizeof(cached.regions));
+        ld2450_cache_store(instance, LD2450_CACHE_REGION, &cached, sizeof(cached));
     } else {
         ESP_LOGE(TAG, "Failed to query region filtering or invalid response");
         ret = ESP_ERR_INVALID_RESPONSE;
     }
     
-    // Exit configuration mode
-    esp_err_t exit_ret = ld2450_exit_config_mode();
-    
-    // Return the first error if any
-    return (ret != ESP_OK) ? ret : exit_ret;
-}
\ No newline at end of file
+    // Exit configuration mode unless a session is open
+    return config_op_end(instance, ret);
+}
+
+/**
+ * @brief Query current region filtering configuration
+ * 
+ * @param type Pointer to store the filtering type
+ * @param regions Array of 3 region definitions to store the current configuration
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_get_region_filter(ld2450_filter_type_t *type, ld2450_region_t regions[3])
+{
+    return ld2450_dev_get_region_filter(NULL, type, regions);
+}
@@ -0,0 +1,167 @@
+/**
+ * @file ld2450_delivery.c
+ * @brief Frame delivery policies (decimation, rate limiting, change filters)
+ * 
+ * Runs in the processing task after a frame is parsed and before it reaches the
+ * frame ring or callback, so an idle scene costs the application nothing.
+ * 
+ * @author NieRVoid
+ * @date 2025-03-12
+ * @license MIT
+ */
+
+#include <stdlib.h>
+#include "ld2450.h"
+#include "ld2450_private.h"
+
+/**
+ * @brief Check whether a frame differs from the last delivered one
+ * 
+ * @param policy Active policy
+ * @param last Reference frame
+ * @param frame Candidate frame
+ * @return true if the change filters let the frame through
+ */
+static bool delivery_changed(const ld2450_delivery_policy_t *policy,
+                             const ld2450_compact_frame_t *last, const ld2450_frame_t *frame)
+{
+    uint8_t mask = 0;
+    for (int i = 0; i < 3; i++) {
+        if (frame->targets[i].valid) {
+            mask |= (uint8_t)(1U << i);
+        }
+    }
+    
+    // Targets appearing or disappearing always count as a change
+    if (mask != last->valid_mask) {
+        return true;
+    }
+    
+    if (policy->count_change_only) {
+        return false;
+    }
+    
+    if (policy->deadband_xy_mm == 0 && policy->deadband_speed == 0) {
+        return true;
+    }
+    
+    for (int i = 0; i < 3; i++) {
+        if (!(mask & (1U << i))) {
+            continue;
+        }
+        
+        const ld2450_target_t *target = &frame->targets[i];
+        const ld2450_compact_target_t *ref = &last->targets[i];
+        
+        if (policy->deadband_xy_mm &&
+            (abs(target->x - ref->x) > policy->deadband_xy_mm ||
+             abs(target->y - ref->y) > policy->deadband_xy_mm)) {
+            return true;
+        }
+        if (policy->deadband_speed &&
+            abs(target->speed - ref->speed) > policy->deadband_speed) {
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+/**
+ * @brief Apply the delivery policy to a parsed frame
+ * 
+ * @param instance Driver instance
+ * @param frame Parsed and timestamped frame
+ * @return true if the frame should be delivered
+ */
+bool ld2450_delivery_filter(ld2450_state_t *instance, const ld2450_frame_t *frame)
+{
+    ld2450_delivery_policy_t policy;
+    bool primed;
+    
+    portENTER_CRITICAL(&instance->delivery_lock);
+    policy = instance->delivery;
+    primed = instance->delivery_primed;
+    portEXIT_CRITICAL(&instance->delivery_lock);
+    
+    // Decimation: consider one frame out of every N received
+    if (policy.decimation > 1) {
+        if (++instance->delivery_skip < policy.decimation) {
+            return false;
+        }
+        instance->delivery_skip = 0;
+    }
+    
+    // Nothing else to evaluate: skip the reference bookkeeping
+    if (!policy.min_interval_ms && !policy.count_change_only &&
+        !policy.deadband_xy_mm && !policy.deadband_speed) {
+        return true;
+    }
+    
+    int64_t since_us = frame->timestamp_us - instance->delivery_last_us;
+    
+    if (primed) {
+        if (policy.min_interval_ms && since_us < (int64_t)policy.min_interval_ms * 1000) {
+            return false;
+        }
+        
+        bool heartbeat = policy.heartbeat_ms && since_us >= (int64_t)policy.heartbeat_ms * 1000;
+        if (!heartbeat && !delivery_changed(&policy, &instance->delivery_last, frame)) {
+            return false;
+        }
+    }
+    
+    instance->delivery_last_us = frame->timestamp_us;
+    ld2450_frame_to_compact(frame, frame->timestamp_us, &instance->delivery_last);
+    
+    portENTER_CRITICAL(&instance->delivery_lock);
+    instance->delivery_primed = true;
+    portEXIT_CRITICAL(&instance->delivery_lock);
+    
+    return true;
+}
+
+/**
+ * @brief Replace an instance's frame delivery policy
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param policy New policy
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_set_delivery_policy(ld2450_handle_t handle, const ld2450_delivery_policy_t *policy)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized || !policy) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    portENTER_CRITICAL(&instance->delivery_lock);
+    instance->delivery = *policy;
+    instance->delivery_primed = false;
+    portEXIT_CRITICAL(&instance->delivery_lock);
+    
+    return ESP_OK;
+}
+
+/**
+ * @brief Get an instance's frame delivery policy
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param policy Pointer to store the policy
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_get_delivery_policy(ld2450_handle_t handle, ld2450_delivery_policy_t *policy)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized || !policy) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    portENTER_CRITICAL(&instance->delivery_lock);
+    *policy = instance->delivery;
+    portEXIT_CRITICAL(&instance->delivery_lock);
+    
+    return ESP_OK;
+}
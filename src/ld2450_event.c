@@ -0,0 +1,214 @@
+/**
+ * @file ld2450_event.c
+ * @brief esp_event integration
+ * 
+ * Events are posted from the processing task without blocking; handlers run on
+ * the event loop's own task, so slow handlers never hold up the UART. Frames are
+ * passed by reference into a small ring of recent frames instead of being copied
+ * into every event.
+ * 
+ * @author NieRVoid
+ * @date 2025-03-12
+ * @license MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "ld2450.h"
+#include "ld2450_private.h"
+#include "esp_log.h"
+#include "esp_event.h"
+
+static const char *TAG = LD2450_LOG_TAG;
+
+ESP_EVENT_DEFINE_BASE(LD2450_EVENT);
+
+/**
+ * @brief Set up event posting for an instance
+ * 
+ * @param instance Driver instance
+ * @param config Event configuration
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_event_init(ld2450_state_t *instance, const ld2450_event_config_t *config)
+{
+    if (!config->enabled) {
+        return ESP_OK;
+    }
+    
+    instance->event_frames = calloc(LD2450_EVENT_FRAME_SLOTS, sizeof(ld2450_frame_t));
+    if (!instance->event_frames) {
+        ESP_LOGE(TAG, "Failed to allocate event frames");
+        return ESP_ERR_NO_MEM;
+    }
+    
+    if (config->loop) {
+        instance->event_loop = config->loop;
+        return ESP_OK;
+    }
+    
+    char task_name[16];
+    snprintf(task_name, sizeof(task_name), "ld2450_evt%d", (int)instance->uart_port);
+    
+    esp_event_loop_args_t args = {
+        .queue_size = config->queue_size ? config->queue_size : 16,
+        .task_name = task_name,
+        .task_priority = config->task_priority ? config->task_priority : 1,
+        .task_stack_size = config->task_stack_size ? config->task_stack_size : 3072,
+        .task_core_id = tskNO_AFFINITY,
+    };
+    
+    esp_err_t ret = esp_event_loop_create(&args, &instance->event_loop);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create event loop: %s", esp_err_to_name(ret));
+        ld2450_event_deinit(instance);
+        return ret;
+    }
+    
+    instance->event_loop_owned = true;
+    return ESP_OK;
+}
+
+/**
+ * @brief Stop event posting and delete the driver-owned loop
+ * 
+ * @param instance Driver instance
+ */
+void ld2450_event_deinit(ld2450_state_t *instance)
+{
+    if (instance->event_loop_owned) {
+        esp_event_loop_delete(instance->event_loop);
+    }
+    instance->event_loop = NULL;
+    instance->event_loop_owned = false;
+    free(instance->event_frames);
+    instance->event_frames = NULL;
+}
+
+/**
+ * @brief Post an event without blocking
+ * 
+ * @param instance Driver instance with events enabled
+ * @param id Event ID
+ * @param data Event data (copied by the loop)
+ * @param size Size of the event data
+ */
+void ld2450_event_post(ld2450_state_t *instance, ld2450_event_id_t id, const void *data, size_t size)
+{
+    if (esp_event_post_to(instance->event_loop, LD2450_EVENT, id, data, size, 0) != ESP_OK) {
+        LD2450_STATS_INC(instance, events_dropped);
+    }
+}
+
+/**
+ * @brief Post LD2450_EVENT_PRESENCE_CHANGED on presence edges
+ * 
+ * @param instance Driver instance with events enabled
+ * @param frame Parsed frame
+ */
+void ld2450_event_presence(ld2450_state_t *instance, const ld2450_frame_t *frame)
+{
+    bool present = frame->count > 0;
+    
+    instance->event_synced = true;
+    
+    if (present == instance->event_present) {
+        return;
+    }
+    instance->event_present = present;
+    
+    ld2450_event_presence_t event = {
+        .handle = instance,
+        .present = present,
+        .count = frame->count,
+        .sequence = frame->sequence,
+        .timestamp_us = frame->timestamp_us,
+    };
+    ld2450_event_post(instance, LD2450_EVENT_PRESENCE_CHANGED, &event, sizeof(event));
+}
+
+/**
+ * @brief Post LD2450_EVENT_FRAME for a delivered frame
+ * 
+ * @param instance Driver instance with events enabled
+ * @param frame Delivered frame
+ */
+void ld2450_event_frame(ld2450_state_t *instance, const ld2450_frame_t *frame)
+{
+    ld2450_frame_t *slot = &instance->event_frames[instance->event_frame_head++ % LD2450_EVENT_FRAME_SLOTS];
+    
+    // Seqlock-style overwrite: first mark the slot with a sequence no event refers
+    // to yet, then copy, then publish the real sequence last
+    __atomic_store_n(&slot->sequence, frame->sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    *slot = *frame;
+    __atomic_store_n(&slot->sequence, frame->sequence, __ATOMIC_RELEASE);
+    
+    ld2450_event_frame_t event = {
+        .handle = instance,
+        .frame = slot,
+        .sequence = frame->sequence,
+    };
+    ld2450_event_post(instance, LD2450_EVENT_FRAME, &event, sizeof(event));
+}
+
+/**
+ * @brief Post LD2450_EVENT_SYNC_LOST unless a loss was already reported
+ * 
+ * @param instance Driver instance with events enabled
+ * @param reason Cause
+ */
+void ld2450_event_sync_lost(ld2450_state_t *instance, ld2450_sync_lost_reason_t reason)
+{
+    if (!instance->event_synced) {
+        return;
+    }
+    instance->event_synced = false;
+    
+    ld2450_event_sync_lost_t event = {
+        .handle = instance,
+        .reason = reason,
+        .stats = instance->sync_stats,
+    };
+    ld2450_event_post(instance, LD2450_EVENT_SYNC_LOST, &event, sizeof(event));
+}
+
+/**
+ * @brief Get the event loop an instance posts to
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param loop Pointer to store the loop
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_STATE if events are disabled
+ */
+esp_err_t ld2450_get_event_loop(ld2450_handle_t handle, esp_event_loop_handle_t *loop)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized || !loop) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    if (!instance->event_loop) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    *loop = instance->event_loop;
+    return ESP_OK;
+}
+
+/**
+ * @brief Check that the frame of an LD2450_EVENT_FRAME has not been overwritten
+ * 
+ * @param event Event data
+ * @return true if event->frame still holds the frame the event was posted for
+ */
+bool ld2450_event_frame_valid(const ld2450_event_frame_t *event)
+{
+    if (!event || !event->frame) {
+        return false;
+    }
+    
+    // Order the caller's reads of the frame before the sequence check
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&event->frame->sequence, __ATOMIC_RELAXED) == event->sequence;
+}
@@ -0,0 +1,432 @@
+/**
+ * @file ld2450_fusion.c
+ * @brief Multi-radar fusion into room coordinates
+ * 
+ * Each radar added as a fusion source has its mounting pose reduced to a Q15
+ * rotation and a translation, so mapping a target into room coordinates costs
+ * four multiplies. The latest transformed frame of every source is kept; once
+ * each source that reported within the time window has delivered a frame, the
+ * detections are merged: greedy nearest-neighbour association within the gating
+ * distance joins detections of the same person seen by overlapping radars, and
+ * each radar contributes at most one detection to a fused target.
+ * 
+ * @author NieRVoid
+ * @date 2025-03-12
+ * @license MIT
+ */
+
+#include <math.h>
+#include <string.h>
+#include "ld2450.h"
+#include "ld2450_private.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = LD2450_LOG_TAG;
+
+/**
+ * @brief A radar feeding the fusion stage
+ */
+typedef struct {
+    /** @brief Instance (NULL for a free slot) */
+    ld2450_state_t *instance;
+    /** @brief Room position of the radar (mm) */
+    int16_t x;
+    int16_t y;
+    /** @brief Rotation onto the room axes in Q15 */
+    int16_t cos_q15;
+    int16_t sin_q15;
+    /** @brief Latest frame's valid targets in room coordinates */
+    ld2450_fusion_target_t targets[3];
+    /** @brief Squared range of each target from the radar (mm^2) */
+    uint32_t range_sq[3];
+    uint8_t count;
+    /** @brief Timestamp of the latest frame (0 = none since added) */
+    int64_t timestamp_us;
+} fusion_source_t;
+
+/**
+ * @brief Fusion stage, shared by all instances
+ */
+static struct {
+    /** @brief Guards everything below, taken by the member processing tasks */
+    SemaphoreHandle_t lock;
+    ld2450_fusion_config_t config;
+    fusion_source_t sources[LD2450_FUSION_MAX_RADARS];
+    /** @brief Sources with a frame since the last fused frame */
+    uint8_t pending;
+    /** @brief Newest timestamp among the pending frames */
+    int64_t pending_us;
+    /** @brief Sequence number of the next fused frame */
+    uint32_t sequence;
+    /** @brief Last fused frame (valid once sequence > 0) */
+    ld2450_fusion_frame_t latest;
+    ld2450_fusion_cb_t callback;
+    void *user_ctx;
+} s_fusion;
+
+/**
+ * @brief Fill in defaults for zero configuration fields
+ * 
+ * @param config Configuration to resolve
+ */
+static void fusion_resolve(ld2450_fusion_config_t *config)
+{
+    if (!config->gate_mm) {
+        config->gate_mm = 500;
+    }
+    if (!config->window_ms) {
+        config->window_ms = 150;
+    }
+}
+
+/**
+ * @brief Take the fusion lock, creating it on first use
+ */
+static esp_err_t fusion_lock(void)
+{
+    if (!ld2450_mutex_once(&s_fusion.lock)) {
+        return ESP_ERR_NO_MEM;
+    }
+    
+    xSemaphoreTake(s_fusion.lock, portMAX_DELAY);
+    // Defaults for a stage never configured; a no-op once they are filled in
+    fusion_resolve(&s_fusion.config);
+    return ESP_OK;
+}
+
+/**
+ * @brief Saturate a value to int16_t
+ */
+static inline int16_t clamp16(int32_t value)
+{
+    return value > INT16_MAX ? INT16_MAX : (value < INT16_MIN ? INT16_MIN : (int16_t)value);
+}
+
+/**
+ * @brief Slot of an instance among the sources, or -1
+ */
+static int fusion_find(const ld2450_state_t *instance)
+{
+    for (int i = 0; i < LD2450_FUSION_MAX_RADARS; i++) {
+        if (s_fusion.sources[i].instance == instance) {
+            return i;
+        }
+    }
+    
+    return -1;
+}
+
+/**
+ * @brief Merge the latest frames of all fresh sources into s_fusion.latest
+ * 
+ * @param newest_us Timestamp of the newest frame to merge
+ */
+static void fusion_emit(int64_t newest_us)
+{
+    ld2450_fusion_frame_t *out = &s_fusion.latest;
+    int32_t sum_x[LD2450_FUSION_MAX_TARGETS];
+    int32_t sum_y[LD2450_FUSION_MAX_TARGETS];
+    uint8_t weight[LD2450_FUSION_MAX_TARGETS];
+    uint32_t best_range_sq[LD2450_FUSION_MAX_TARGETS];
+    int64_t window_us = (int64_t)s_fusion.config.window_ms * 1000;
+    int64_t gate_sq = (int64_t)s_fusion.config.gate_mm * s_fusion.config.gate_mm;
+    
+    out->count = 0;
+    out->radars = 0;
+    
+    for (int i = 0; i < LD2450_FUSION_MAX_RADARS; i++) {
+        const fusion_source_t *src = &s_fusion.sources[i];
+        uint8_t bit = 1U << i;
+        
+        if (!src->instance || !src->timestamp_us || newest_us - src->timestamp_us > window_us) {
+            continue;
+        }
+        out->radars |= bit;
+        
+        for (int t = 0; t < src->count; t++) {
+            const ld2450_fusion_target_t *det = &src->targets[t];
+            int best = -1;
+            int64_t best_sq = gate_sq;
+            
+            // Nearest fused target this radar has not contributed to yet
+            for (int k = 0; k < out->count; k++) {
+                if (out->targets[k].radars & bit) {
+                    continue;
+                }
+                int32_t dx = det->x - out->targets[k].x;
+                int32_t dy = det->y - out->targets[k].y;
+                int64_t d_sq = (int64_t)dx * dx + (int64_t)dy * dy;
+                if (d_sq <= best_sq) {
+                    best = k;
+                    best_sq = d_sq;
+                }
+            }
+            
+            if (best < 0) {
+                best = out->count++;
+                out->targets[best] = *det;
+                sum_x[best] = det->x;
+                sum_y[best] = det->y;
+                weight[best] = 1;
+                best_range_sq[best] = src->range_sq[t];
+                continue;
+            }
+            
+            ld2450_fusion_target_t *fused = &out->targets[best];
+            sum_x[best] += det->x;
+            sum_y[best] += det->y;
+            weight[best]++;
+            fused->x = (int16_t)(sum_x[best] / weight[best]);
+            fused->y = (int16_t)(sum_y[best] / weight[best]);
+            fused->radars |= bit;
+            // Radial speed does not transform; keep the closest radar's measurement
+            if (src->range_sq[t] < best_range_sq[best]) {
+                fused->speed = det->speed;
+                best_range_sq[best] = src->range_sq[t];
+            }
+        }
+    }
+    
+    out->sequence = s_fusion.sequence++;
+    out->timestamp_us = newest_us;
+    s_fusion.pending = 0;
+    s_fusion.pending_us = 0;
+}
+
+/**
+ * @brief Feed a parsed frame of a fusion source to the fusion stage
+ * 
+ * @param instance Driver instance
+ * @param frame Parsed and timestamped frame
+ */
+void ld2450_fusion_frame(ld2450_state_t *instance, const ld2450_frame_t *frame)
+{
+    // A frame can close a late group and then a complete one
+    ld2450_fusion_frame_t fused[2];
+    int emitted = 0;
+    
+    xSemaphoreTake(s_fusion.lock, portMAX_DELAY);
+    
+    int i = fusion_find(instance);
+    if (i < 0) {
+        // Removed since the caller checked
+        xSemaphoreGive(s_fusion.lock);
+        return;
+    }
+    
+    fusion_source_t *src = &s_fusion.sources[i];
+    uint8_t bit = 1U << i;
+    
+    // A second frame before the others arrived: they are late, close the group without them
+    if (s_fusion.pending & bit) {
+        fusion_emit(s_fusion.pending_us);
+        fused[emitted++] = s_fusion.latest;
+    }
+    
+    src->count = 0;
+    for (int t = 0; t < 3; t++) {
+        const ld2450_target_t *target = &frame->targets[t];
+        if (!target->valid) {
+            continue;
+        }
+        
+        ld2450_fusion_target_t *det = &src->targets[src->count];
+        int32_t rx = ((int32_t)target->x * src->cos_q15 - (int32_t)target->y * src->sin_q15 + (1 << 14)) >> 15;
+        int32_t ry = ((int32_t)target->x * src->sin_q15 + (int32_t)target->y * src->cos_q15 + (1 << 14)) >> 15;
+        det->x = clamp16(src->x + rx);
+        det->y = clamp16(src->y + ry);
+        det->speed = target->speed;
+        det->radars = bit;
+        src->range_sq[src->count] = (uint32_t)((int32_t)target->x * target->x) +
+                                    (uint32_t)((int32_t)target->y * target->y);
+        src->count++;
+    }
+    src->timestamp_us = frame->timestamp_us;
+    s_fusion.pending |= bit;
+    s_fusion.pending_us = MAX(s_fusion.pending_us, frame->timestamp_us);
+    
+    // Wait for every source that is still reporting, i.e. sent a frame within the window
+    int64_t window_us = (int64_t)s_fusion.config.window_ms * 1000;
+    uint8_t expected = 0;
+    for (int j = 0; j < LD2450_FUSION_MAX_RADARS; j++) {
+        const fusion_source_t *other = &s_fusion.sources[j];
+        if (other->instance && other->timestamp_us &&
+            frame->timestamp_us - other->timestamp_us <= window_us) {
+            expected |= 1U << j;
+        }
+    }
+    if ((s_fusion.pending & expected) == expected) {
+        fusion_emit(s_fusion.pending_us);
+        fused[emitted++] = s_fusion.latest;
+    }
+    
+    ld2450_fusion_cb_t callback = s_fusion.callback;
+    void *user_ctx = s_fusion.user_ctx;
+    xSemaphoreGive(s_fusion.lock);
+    
+    // Outside the lock: the callback may call back into the fusion API, and the
+    // other sources' processing tasks are not held up while it runs
+    for (int k = 0; callback && k < emitted; k++) {
+        callback(&fused[k], user_ctx);
+    }
+}
+
+/**
+ * @brief Add a radar to the fusion stage, or move one already added
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param pose Mounting pose
+ * @param source Pointer to store the source index used in the radars bitmasks (may be NULL)
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NO_MEM if LD2450_FUSION_MAX_RADARS
+ *         radars were added already, error code otherwise
+ */
+esp_err_t ld2450_fusion_add_radar(ld2450_handle_t handle, const ld2450_pose_t *pose, uint8_t *source)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized || !pose) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    esp_err_t ret = fusion_lock();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    
+    int i = fusion_find(instance);
+    if (i < 0) {
+        i = fusion_find(NULL);
+    }
+    if (i < 0) {
+        xSemaphoreGive(s_fusion.lock);
+        ESP_LOGE(TAG, "Fusion stage already has %d radars", LD2450_FUSION_MAX_RADARS);
+        return ESP_ERR_NO_MEM;
+    }
+    
+    // Trig once here, so frames only need the fixed-point rotation
+    float yaw = (float)pose->yaw_cdeg * ((float)M_PI / 18000.0f);
+    fusion_source_t *src = &s_fusion.sources[i];
+    src->instance = instance;
+    src->x = pose->x;
+    src->y = pose->y;
+    src->cos_q15 = clamp16((int32_t)lroundf(cosf(yaw) * 32768.0f));
+    src->sin_q15 = clamp16((int32_t)lroundf(sinf(yaw) * 32768.0f));
+    // Its last frame was in the old pose
+    src->count = 0;
+    src->timestamp_us = 0;
+    s_fusion.pending &= ~(1U << i);
+    instance->fusion_source = true;
+    
+    xSemaphoreGive(s_fusion.lock);
+    
+    if (source) {
+        *source = (uint8_t)i;
+    }
+    
+    ESP_LOGI(TAG, "UART%d is fusion source %d at (%d, %d) mm, yaw %.2f deg", (int)instance->uart_port,
+             i, pose->x, pose->y, pose->yaw_cdeg / 100.0);
+    return ESP_OK;
+}
+
+/**
+ * @brief Remove a radar from the fusion stage
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_FOUND if the radar was not added
+ */
+esp_err_t ld2450_fusion_remove_radar(ld2450_handle_t handle)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    if (!s_fusion.lock) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    
+    xSemaphoreTake(s_fusion.lock, portMAX_DELAY);
+    int i = fusion_find(instance);
+    if (i >= 0) {
+        memset(&s_fusion.sources[i], 0, sizeof(s_fusion.sources[i]));
+        s_fusion.pending &= ~(1U << i);
+        instance->fusion_source = false;
+    }
+    xSemaphoreGive(s_fusion.lock);
+    
+    return i >= 0 ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+/**
+ * @brief Replace the fusion stage configuration
+ * 
+ * @param config New configuration
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_fusion_set_config(const ld2450_fusion_config_t *config)
+{
+    if (!config) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    esp_err_t ret = fusion_lock();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    
+    s_fusion.config = *config;
+    fusion_resolve(&s_fusion.config);
+    
+    xSemaphoreGive(s_fusion.lock);
+    return ESP_OK;
+}
+
+/**
+ * @brief Get the most recent fused frame
+ * 
+ * @param frame Pointer to store the frame
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_FOUND if no fused frame was produced yet
+ */
+esp_err_t ld2450_fusion_get_frame(ld2450_fusion_frame_t *frame)
+{
+    if (!frame) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    if (!s_fusion.lock) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    
+    xSemaphoreTake(s_fusion.lock, portMAX_DELAY);
+    bool produced = s_fusion.sequence > 0;
+    if (produced) {
+        *frame = s_fusion.latest;
+    }
+    xSemaphoreGive(s_fusion.lock);
+    
+    return produced ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+/**
+ * @brief Register a callback for fused frames
+ * 
+ * @param callback Function to call for every fused frame (NULL to unregister)
+ * @param user_ctx User context pointer passed to the callback function
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_register_fusion_callback(ld2450_fusion_cb_t callback, void *user_ctx)
+{
+    esp_err_t ret = fusion_lock();
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    
+    s_fusion.callback = callback;
+    s_fusion.user_ctx = user_ctx;
+    
+    xSemaphoreGive(s_fusion.lock);
+    return ESP_OK;
+}
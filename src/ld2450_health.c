@@ -0,0 +1,434 @@
+/**
+ * @file ld2450_health.c
+ * @brief Stream health watchdog
+ * 
+ * A state machine run by the processing task. It learns the radar's frame
+ * interval and, once frames stop for LD2450_HEALTH_MISSED_FRAMES intervals,
+ * escalates through increasingly disruptive recovery steps, giving each one a
+ * timeout to bring frames back: resynchronize the scanner, send end-configuration
+ * through the command engine, restart the module, then listen at every other baud
+ * rate. Commands are queued rather than waited for, and the clock of a step only
+ * runs while the command engine is idle, so neither the task nor any caller
+ * blocks on a recovery.
+ * 
+ * @author NieRVoid
+ * @date 2025-03-12
+ * @license MIT
+ */
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include "ld2450.h"
+#include "ld2450_private.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "driver/uart.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+static const char *TAG = LD2450_LOG_TAG;
+
+/**
+ * @brief Watchdog state of an instance, owned by its processing task
+ */
+struct ld2450_health {
+    ld2450_health_config_t config;
+    /** @brief Timestamp of the last parsed frame */
+    int64_t last_frame_us;
+    /** @brief Smoothed frame interval (0 until two frames were seen) */
+    int64_t interval_us;
+    /** @brief Start of the current timeout: the last frame, step or engine activity */
+    int64_t ref_us;
+    /** @brief Last frame before the stall in progress */
+    int64_t stall_us;
+    /** @brief Host baud rate when the stall was detected */
+    uint32_t home_bps;
+    /** @brief Rates the baud probe listens at, in order */
+    ld2450_baud_rate_t probe_order[LD2450_BAUD_460800];
+    uint8_t probe_count;
+    uint8_t probe_idx;
+    /** @brief Guards stats against ld2450_get_health_stats() */
+    portMUX_TYPE stats_lock;
+    ld2450_health_stats_t stats;
+};
+
+/**
+ * @brief Gap without frames that counts as a stall, also the time given to a step
+ */
+static int64_t health_timeout_us(const ld2450_health_t *health)
+{
+    if (health->config.timeout_ms) {
+        return (int64_t)health->config.timeout_ms * 1000;
+    }
+    if (!health->interval_us) {
+        return LD2450_HEALTH_TIMEOUT_MS * 1000;
+    }
+    
+    return MAX(health->interval_us * LD2450_HEALTH_MISSED_FRAMES, LD2450_HEALTH_MIN_TIMEOUT_MS * 1000);
+}
+
+/**
+ * @brief Deadline of the current state
+ */
+static int64_t health_deadline_us(ld2450_state_t *instance)
+{
+    ld2450_health_t *health = instance->health;
+    
+    switch (health->stats.state) {
+        case LD2450_HEALTH_OK:
+            // A duty-cycled radar only has frames parsed once per period
+            return health->ref_us + health_timeout_us(health) + ld2450_power_duty_period_us(instance);
+        case LD2450_HEALTH_BAUD_PROBE:
+            return health->ref_us + LD2450_AUTOBAUD_LISTEN_MS * 1000;
+        case LD2450_HEALTH_FAILED:
+            return health->ref_us + (int64_t)health->config.retry_ms * 1000;
+        default:
+            return health->ref_us + health_timeout_us(health);
+    }
+}
+
+/**
+ * @brief Whether the module is legitimately not streaming
+ * 
+ * Commands, configuration sessions and restart holds keep the module quiet,
+ * and a replay stands in for the UART.
+ */
+static bool health_busy(ld2450_state_t *instance)
+{
+    return instance->config_session || instance->cmd_pending || instance->cmd_waiting ||
+           instance->cmd_restarting || instance->replay_running ||
+           uxQueueMessagesWaiting(instance->cmd_queue) > 0;
+}
+
+/**
+ * @brief Drop any partial frame so the scanner waits for a fresh header
+ */
+static void health_reset_scanner(ld2450_state_t *instance)
+{
+    instance->frame_synced = false;
+    instance->frame_idx = 0;
+    instance->header_match = 0;
+}
+
+/**
+ * @brief Queue a recovery command for the command engine
+ */
+static void health_command(ld2450_state_t *instance, uint16_t command, bool auto_config)
+{
+    ld2450_cmd_request_t request = {
+        .command = {
+            .command = command,
+        },
+        .auto_config = auto_config,
+        .sync = false,
+    };
+    
+    // A full queue means commands are flowing; the step times out and escalates
+    ld2450_command_enqueue(instance, &request);
+}
+
+/**
+ * @brief Fill the probe order: the factory default first, then fastest down
+ */
+static void health_plan_probe(ld2450_health_t *health)
+{
+    uint32_t factory_bps = ld2450_baud_rate_to_bps(LD2450_BAUD_256000);
+    
+    health->probe_count = 0;
+    health->probe_idx = 0;
+    if (health->home_bps != factory_bps) {
+        health->probe_order[health->probe_count++] = LD2450_BAUD_256000;
+    }
+    for (int rate = LD2450_BAUD_460800; rate >= LD2450_BAUD_9600; rate--) {
+        uint32_t bps = ld2450_baud_rate_to_bps(rate);
+        if (bps != health->home_bps && bps != factory_bps) {
+            health->probe_order[health->probe_count++] = rate;
+        }
+    }
+}
+
+/**
+ * @brief Move to a new state, running its recovery step
+ */
+static void health_enter(ld2450_state_t *instance, ld2450_health_state_t state, int64_t now)
+{
+    ld2450_health_t *health = instance->health;
+    ld2450_health_state_t prev = health->stats.state;
+    uint32_t stalled_ms = 0;
+    
+    if (state != LD2450_HEALTH_OK) {
+        stalled_ms = (uint32_t)(MAX(now - health->stall_us, 0) / 1000);
+    }
+    
+    switch (state) {
+        case LD2450_HEALTH_RESYNC:
+            health_reset_scanner(instance);
+            // The DMA backend owns the RX FIFO; with the UART driver, drop its stale bytes
+            if (!instance->uhci) {
+                uart_flush_input(instance->uart_port);
+            }
+            break;
+        case LD2450_HEALTH_EXIT_CONFIG:
+            health_command(instance, LD2450_CMD_END_CONFIG, false);
+            break;
+        case LD2450_HEALTH_RESTART:
+            health_command(instance, LD2450_CMD_RESTART_MODULE, true);
+            break;
+        case LD2450_HEALTH_BAUD_PROBE: {
+            uint32_t bps = ld2450_baud_rate_to_bps(health->probe_order[health->probe_idx]);
+            ld2450_set_host_baud(instance, bps);
+            health_reset_scanner(instance);
+            break;
+        }
+        case LD2450_HEALTH_FAILED:
+            if (instance->baud_rate != health->home_bps) {
+                ld2450_set_host_baud(instance, health->home_bps);
+            }
+            break;
+        default:
+            break;
+    }
+    
+    portENTER_CRITICAL(&health->stats_lock);
+    switch (state) {
+        case LD2450_HEALTH_OK:
+            health->stats.recoveries++;
+            health->stats.recovered_by = prev;
+            health->stats.last_downtime_ms = (uint32_t)(MAX(now - health->stall_us, 0) / 1000);
+            health->stats.downtime_us += (uint64_t)MAX(now - health->stall_us, 0);
+            break;
+        case LD2450_HEALTH_RESYNC:
+            if (prev == LD2450_HEALTH_OK) {
+                health->stats.stalls++;
+            }
+            health->stats.resyncs++;
+            break;
+        case LD2450_HEALTH_EXIT_CONFIG:
+            health->stats.exit_configs++;
+            break;
+        case LD2450_HEALTH_RESTART:
+            health->stats.restarts++;
+            break;
+        case LD2450_HEALTH_BAUD_PROBE:
+            health->stats.baud_probes++;
+            break;
+        default:
+            break;
+    }
+    health->stats.frame_interval_us = (uint32_t)health->interval_us;
+    health->stats.state = state;
+    portEXIT_CRITICAL(&health->stats_lock);
+    
+    health->ref_us = now;
+    
+    if (state == LD2450_HEALTH_OK) {
+        ESP_LOGI(TAG, "UART%d stream recovered at %" PRIu32 " baud after %" PRIu32 " ms",
+                 (int)instance->uart_port, instance->baud_rate, health->stats.last_downtime_ms);
+    } else if (state == LD2450_HEALTH_BAUD_PROBE) {
+        ESP_LOGD(TAG, "UART%d probing %" PRIu32 " baud", (int)instance->uart_port, instance->baud_rate);
+    } else {
+        ESP_LOGW(TAG, "UART%d no frames for %" PRIu32 " ms, health state %d -> %d",
+                 (int)instance->uart_port, stalled_ms, prev, state);
+    }
+    
+    LD2450_TRACE(instance, LD2450_TRACE_HEALTH, (uint8_t)state, 0, stalled_ms);
+    if (instance->event_loop) {
+        ld2450_event_health_t event = {
+            .handle = instance,
+            .state = state,
+            .prev = prev,
+            .stalled_ms = stalled_ms,
+            .baud_rate = instance->baud_rate,
+        };
+        ld2450_event_post(instance, LD2450_EVENT_HEALTH, &event, sizeof(event));
+    }
+}
+
+/**
+ * @brief Note a parsed frame, ending a stall in progress
+ * 
+ * @param instance Driver instance
+ * @param frame Parsed frame
+ */
+void ld2450_health_frame(ld2450_state_t *instance, const ld2450_frame_t *frame)
+{
+    ld2450_health_t *health = instance->health;
+    int64_t now = frame->timestamp_us;
+    
+    // Replayed frames say nothing about the radar
+    if (instance->replay_running) {
+        return;
+    }
+    
+    if (health->stats.state != LD2450_HEALTH_OK) {
+        health->last_frame_us = now;
+        health_enter(instance, LD2450_HEALTH_OK, esp_timer_get_time());
+        return;
+    }
+    
+    // Learn the interval from gaps that are not stalls (or duty-cycle pauses)
+    int64_t gap = now - health->last_frame_us;
+    if (gap > 0 && gap < health_timeout_us(health)) {
+        health->interval_us = health->interval_us ? health->interval_us + (gap - health->interval_us) / 8 : gap;
+    }
+    health->last_frame_us = now;
+    health->ref_us = MAX(health->ref_us, now);
+}
+
+/**
+ * @brief Detect stalls and advance the recovery steps
+ * 
+ * @param instance Driver instance
+ */
+void ld2450_health_poll(ld2450_state_t *instance)
+{
+    ld2450_health_t *health = instance->health;
+    
+    if (!health) {
+        return;
+    }
+    
+    int64_t now = esp_timer_get_time();
+    
+    // Time only counts against the module while nothing else keeps it quiet
+    if (health_busy(instance)) {
+        health->ref_us = now;
+        return;
+    }
+    
+    if (now < health_deadline_us(instance)) {
+        return;
+    }
+    
+    switch (health->stats.state) {
+        case LD2450_HEALTH_OK:
+            health->stall_us = health->last_frame_us;
+            health->home_bps = instance->baud_rate;
+            health_enter(instance, LD2450_HEALTH_RESYNC, now);
+            break;
+        case LD2450_HEALTH_RESYNC:
+            health_enter(instance, LD2450_HEALTH_EXIT_CONFIG, now);
+            break;
+        case LD2450_HEALTH_EXIT_CONFIG:
+            health_enter(instance, LD2450_HEALTH_RESTART, now);
+            break;
+        case LD2450_HEALTH_RESTART:
+            if (health->config.skip_baud_probe) {
+                health_enter(instance, LD2450_HEALTH_FAILED, now);
+                break;
+            }
+            health_plan_probe(health);
+            health_enter(instance, LD2450_HEALTH_BAUD_PROBE, now);
+            break;
+        case LD2450_HEALTH_BAUD_PROBE:
+            if (++health->probe_idx < health->probe_count) {
+                health_enter(instance, LD2450_HEALTH_BAUD_PROBE, now);
+            } else {
+                health_enter(instance, LD2450_HEALTH_FAILED, now);
+            }
+            break;
+        case LD2450_HEALTH_FAILED:
+            health_enter(instance, LD2450_HEALTH_RESYNC, now);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Time until the watchdog's next deadline
+ * 
+ * @param instance Driver instance
+ * @return Ticks to wait (portMAX_DELAY if the watchdog is not enabled)
+ */
+TickType_t ld2450_health_wait_ticks(ld2450_state_t *instance)
+{
+    if (!instance->health) {
+        return portMAX_DELAY;
+    }
+    
+    int64_t remaining_us = health_deadline_us(instance) - esp_timer_get_time();
+    if (remaining_us <= 0) {
+        return 0;
+    }
+    
+    return pdMS_TO_TICKS((remaining_us + 999) / 1000) + 1;
+}
+
+/**
+ * @brief Set up the stream health watchdog
+ * 
+ * @param instance Driver instance
+ * @param config Watchdog configuration
+ * @return esp_err_t ESP_OK on success (or if not enabled), error code otherwise
+ */
+esp_err_t ld2450_health_init(ld2450_state_t *instance, const ld2450_health_config_t *config)
+{
+    if (!config->enabled) {
+        return ESP_OK;
+    }
+    
+    ld2450_health_t *health = calloc(1, sizeof(ld2450_health_t));
+    if (!health) {
+        return ESP_ERR_NO_MEM;
+    }
+    
+    health->config = *config;
+    if (!health->config.retry_ms) {
+        health->config.retry_ms = LD2450_HEALTH_RETRY_MS;
+    }
+    portMUX_INITIALIZE(&health->stats_lock);
+    
+    // Startup counts as the last frame, so a radar that never streams is caught too
+    int64_t now = esp_timer_get_time();
+    health->last_frame_us = now;
+    health->ref_us = now;
+    health->stats.state = LD2450_HEALTH_OK;
+    instance->health = health;
+    
+    return ESP_OK;
+}
+
+/**
+ * @brief Release the stream health watchdog
+ * 
+ * @param instance Driver instance, with its processing task stopped
+ */
+void ld2450_health_deinit(ld2450_state_t *instance)
+{
+    free(instance->health);
+    instance->health = NULL;
+}
+
+/**
+ * @brief Get the stream health state and recovery counters
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param stats Pointer to store the counters
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_STATE if the watchdog is not enabled
+ */
+esp_err_t ld2450_get_health_stats(ld2450_handle_t handle, ld2450_health_stats_t *stats)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized || !stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    ld2450_health_t *health = instance->health;
+    if (!health) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    portENTER_CRITICAL(&health->stats_lock);
+    *stats = health->stats;
+    int64_t stall_us = health->stall_us;
+    portEXIT_CRITICAL(&health->stats_lock);
+    
+    // Include the stall still in progress
+    if (stats->state != LD2450_HEALTH_OK) {
+        stats->downtime_us += (uint64_t)MAX(esp_timer_get_time() - stall_us, 0);
+    }
+    
+    return ESP_OK;
+}
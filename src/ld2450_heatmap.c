@@ -0,0 +1,247 @@
+/**
+ * @file ld2450_heatmap.c
+ * @brief Occupancy heatmap and zone dwell-time accumulator
+ * 
+ * The parse path drops every valid target into a fixed grid of saturating
+ * 16-bit counters over the sensor's field of view, and credits the frame
+ * interval to each occupied software zone. Applications upload the aggregate
+ * once in a while instead of every frame. A second grid of the same size lets
+ * a resetting snapshot swap buffers in a short critical section, so no frame is
+ * lost or counted twice between two snapshots.
+ * 
+ * @author NieRVoid
+ * @date 2025-03-12
+ * @license MIT
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "ld2450.h"
+#include "ld2450_private.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = LD2450_LOG_TAG;
+
+/**
+ * @brief Heatmap state of an instance
+ */
+struct ld2450_heatmap {
+    uint16_t cell_mm;
+    uint8_t cols;
+    uint8_t rows;
+    /** @brief Grid being accumulated, and the one a resetting snapshot swaps in */
+    uint16_t *cells;
+    uint16_t *spare;
+    uint32_t frames;
+    uint32_t detections;
+    uint32_t outside;
+    /** @brief Start of the accumulation */
+    int64_t since_us;
+    /** @brief Timestamp of the previous frame (0 = none) */
+    int64_t last_frame_us;
+    uint64_t zone_occupied_us[LD2450_ZONE_MAX];
+    uint64_t zone_target_us[LD2450_ZONE_MAX];
+    /** @brief Guards the counters and the grid pointers against ld2450_heatmap_snapshot() */
+    portMUX_TYPE lock;
+};
+
+/**
+ * @brief Allocate the occupancy heatmap
+ * 
+ * @param instance Driver instance
+ * @param config Heatmap configuration
+ * @return esp_err_t ESP_OK on success (or if not enabled), error code otherwise
+ */
+esp_err_t ld2450_heatmap_init(ld2450_state_t *instance, const ld2450_heatmap_config_t *config)
+{
+    if (!config->enabled) {
+        return ESP_OK;
+    }
+    
+    uint16_t cell_mm = config->cell_mm ? config->cell_mm : 250;
+    if (cell_mm < 100) {
+        ESP_LOGE(TAG, "Heatmap cell of %u mm is below 100 mm", cell_mm);
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    ld2450_heatmap_t *heatmap = calloc(1, sizeof(ld2450_heatmap_t));
+    if (!heatmap) {
+        return ESP_ERR_NO_MEM;
+    }
+    
+    heatmap->cell_mm = cell_mm;
+    heatmap->cols = (uint8_t)((2 * LD2450_HEATMAP_HALF_WIDTH_MM + cell_mm - 1) / cell_mm);
+    heatmap->rows = (uint8_t)((LD2450_HEATMAP_DEPTH_MM + cell_mm - 1) / cell_mm);
+    size_t count = (size_t)heatmap->cols * heatmap->rows;
+    heatmap->cells = calloc(count, sizeof(uint16_t));
+    heatmap->spare = calloc(count, sizeof(uint16_t));
+    if (!heatmap->cells || !heatmap->spare) {
+        free(heatmap->cells);
+        free(heatmap->spare);
+        free(heatmap);
+        return ESP_ERR_NO_MEM;
+    }
+    portMUX_INITIALIZE(&heatmap->lock);
+    heatmap->since_us = esp_timer_get_time();
+    instance->heatmap = heatmap;
+    
+    ESP_LOGI(TAG, "UART%d heatmap %ux%u cells of %u mm", (int)instance->uart_port, heatmap->cols,
+             heatmap->rows, cell_mm);
+    return ESP_OK;
+}
+
+/**
+ * @brief Release the occupancy heatmap
+ * 
+ * @param instance Driver instance
+ */
+void ld2450_heatmap_deinit(ld2450_state_t *instance)
+{
+    ld2450_heatmap_t *heatmap = instance->heatmap;
+    
+    if (!heatmap) {
+        return;
+    }
+    
+    instance->heatmap = NULL;
+    free(heatmap->cells);
+    free(heatmap->spare);
+    free(heatmap);
+}
+
+/**
+ * @brief Count a parsed frame into the heatmap and zone dwell times
+ * 
+ * @param instance Driver instance
+ * @param frame Parsed frame, after zone evaluation
+ */
+void ld2450_heatmap_update(ld2450_state_t *instance, const ld2450_frame_t *frame)
+{
+    ld2450_heatmap_t *heatmap = instance->heatmap;
+    int32_t cell[3];
+    int n = 0;
+    uint32_t outside = 0;
+    
+    // Cell indices outside the lock, so it only covers the increments
+    for (int t = 0; t < 3; t++) {
+        const ld2450_target_t *target = &frame->targets[t];
+        if (!target->valid) {
+            continue;
+        }
+        // Against the area itself: the last row and column may reach past it when cell_mm does not divide it
+        if (target->x < -LD2450_HEATMAP_HALF_WIDTH_MM || target->x >= LD2450_HEATMAP_HALF_WIDTH_MM ||
+            target->y < 0 || target->y >= LD2450_HEATMAP_DEPTH_MM) {
+            outside++;
+            continue;
+        }
+        int32_t col = ((int32_t)target->x + LD2450_HEATMAP_HALF_WIDTH_MM) / heatmap->cell_mm;
+        int32_t row = (int32_t)target->y / heatmap->cell_mm;
+        cell[n++] = row * heatmap->cols + col;
+    }
+    
+    // A stall is not dwell time
+    int64_t dt_us = heatmap->last_frame_us ? frame->timestamp_us - heatmap->last_frame_us : 0;
+    dt_us = dt_us < 0 ? 0 : MIN(dt_us, LD2450_HEATMAP_DT_MAX_US);
+    heatmap->last_frame_us = frame->timestamp_us;
+    const ld2450_zone_engine_t *zones = instance->zones;
+    
+    portENTER_CRITICAL(&heatmap->lock);
+    for (int i = 0; i < n; i++) {
+        if (heatmap->cells[cell[i]] != UINT16_MAX) {
+            heatmap->cells[cell[i]]++;
+        }
+    }
+    heatmap->frames++;
+    heatmap->detections += (uint32_t)n;
+    heatmap->outside += outside;
+    if (zones && dt_us) {
+        for (uint16_t active = zones->table.active; active; active &= active - 1) {
+            int z = __builtin_ctz(active);
+            if (zones->occupancy[z]) {
+                heatmap->zone_occupied_us[z] += (uint64_t)dt_us;
+                heatmap->zone_target_us[z] += (uint64_t)dt_us * zones->occupancy[z];
+            }
+        }
+    }
+    portEXIT_CRITICAL(&heatmap->lock);
+}
+
+/**
+ * @brief Copy the occupancy heatmap and zone dwell times, optionally starting over
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param info Pointer to store the summary and dwell times
+ * @param cells Array receiving cols x rows cell counts (NULL for the summary only)
+ * @param max_cells Capacity of cells
+ * @param reset Clear the counters after copying
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_STATE if the heatmap is not enabled,
+ *         ESP_ERR_INVALID_SIZE if cells cannot hold the grid, error code otherwise
+ */
+esp_err_t ld2450_heatmap_snapshot(ld2450_handle_t handle, ld2450_heatmap_info_t *info, uint16_t *cells,
+                                  size_t max_cells, bool reset)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized || !info) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    ld2450_heatmap_t *heatmap = instance->heatmap;
+    if (!heatmap) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    size_t count = (size_t)heatmap->cols * heatmap->rows;
+    if (cells && max_cells < count) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    
+    // Serializes snapshots, which own the spare grid
+    if (xSemaphoreTake(instance->mutex, portMAX_DELAY) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+    
+    int64_t now = esp_timer_get_time();
+    uint16_t *grid;
+    
+    memset(info, 0, sizeof(*info));
+    info->cell_mm = heatmap->cell_mm;
+    info->cols = heatmap->cols;
+    info->rows = heatmap->rows;
+    
+    portENTER_CRITICAL(&heatmap->lock);
+    info->frames = heatmap->frames;
+    info->detections = heatmap->detections;
+    info->outside = heatmap->outside;
+    info->elapsed_ms = (uint32_t)((now - heatmap->since_us) / 1000);
+    for (int z = 0; z < LD2450_ZONE_MAX; z++) {
+        info->zone_occupied_ms[z] = (uint32_t)(heatmap->zone_occupied_us[z] / 1000);
+        info->zone_target_ms[z] = (uint32_t)(heatmap->zone_target_us[z] / 1000);
+    }
+    grid = heatmap->cells;
+    if (reset) {
+        // The spare grid is zeroed: swap it in and read the detached one at leisure
+        heatmap->cells = heatmap->spare;
+        heatmap->spare = grid;
+        heatmap->frames = 0;
+        heatmap->detections = 0;
+        heatmap->outside = 0;
+        heatmap->since_us = now;
+        memset(heatmap->zone_occupied_us, 0, sizeof(heatmap->zone_occupied_us));
+        memset(heatmap->zone_target_us, 0, sizeof(heatmap->zone_target_us));
+    }
+    portEXIT_CRITICAL(&heatmap->lock);
+    
+    if (cells) {
+        memcpy(cells, grid, count * sizeof(uint16_t));
+    }
+    if (reset) {
+        memset(grid, 0, count * sizeof(uint16_t));
+    }
+    
+    xSemaphoreGive(instance->mutex);
+    return ESP_OK;
+}
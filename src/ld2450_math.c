@@ -0,0 +1,175 @@
+/**
+ * @file ld2450_math.c
+ * @brief Integer distance/angle helpers and derived-field accessors
+ * 
+ * Provides the fixed-point path used by LD2450_DERIVED_FIXED (integer square root
+ * and a table-based atan2) for targets without a double-precision FPU, plus the
+ * accessors that compute derived fields on demand for LD2450_DERIVED_LAZY.
+ * 
+ * @author NieRVoid
+ * @date 2025-03-12
+ * @license MIT
+ */
+
+#include <math.h>
+#include "ld2450.h"
+#include "ld2450_private.h"
+
+/**
+ * @brief atan(i / 32) in thousandths of a degree for i = 0..32
+ * 
+ * Linear interpolation between entries keeps the error of ld2450_atan2_cdeg()
+ * below 0.01 degrees (interpolation error < 0.005 degrees plus rounding).
+ */
+static const uint16_t s_atan_table_mdeg[33] = {
+        0,  1790,  3576,  5356,  7125,  8881, 10620, 12339,
+    14036, 15709, 17354, 18970, 20556, 22109, 23629, 25115,
+    26565, 27979, 29358, 30700, 32005, 33275, 34509, 35707,
+    36870, 37999, 39094, 40156, 41186, 42184, 43152, 44091,
+    45000,
+};
+
+/**
+ * @brief Integer square root
+ * 
+ * @param value Input value
+ * @return floor(sqrt(value))
+ */
+uint32_t ld2450_isqrt32(uint32_t value)
+{
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+    
+    while (bit > value) {
+        bit >>= 2;
+    }
+    
+    while (bit != 0) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    
+    return root;
+}
+
+/**
+ * @brief Table-based atan2 in hundredths of a degree
+ * 
+ * @param y Y component
+ * @param x X component
+ * @return atan2(y, x) in the range -18000..18000 (0.01 degree units)
+ */
+int32_t ld2450_atan2_cdeg(int32_t y, int32_t x)
+{
+    if (x == 0 && y == 0) {
+        return 0;
+    }
+    
+    uint32_t ax = (uint32_t)(x < 0 ? -x : x);
+    uint32_t ay = (uint32_t)(y < 0 ? -y : y);
+    bool swap = ay > ax;
+    uint32_t num = swap ? ax : ay;
+    uint32_t den = swap ? ay : ax;
+    
+    // ratio = num / den in Q5.11 (0..32 table steps with 11 fractional bits)
+    uint32_t ratio = (num << 16) / den;
+    uint32_t idx = ratio >> 11;
+    uint32_t frac = ratio & 0x7FF;
+    
+    int32_t angle_mdeg = s_atan_table_mdeg[idx];
+    if (idx < 32) {
+        angle_mdeg += (int32_t)(((s_atan_table_mdeg[idx + 1] - s_atan_table_mdeg[idx]) * frac + 0x400) >> 11);
+    }
+    int32_t angle = (angle_mdeg + 5) / 10;
+    
+    // Undo the octant reduction
+    if (swap) {
+        angle = 9000 - angle;
+    }
+    if (x < 0) {
+        angle = 18000 - angle;
+    }
+    return (y < 0) ? -angle : angle;
+}
+
+/**
+ * @brief Fill a target's distance and angle according to a derived-field mode
+ * 
+ * @param target Target with x/y populated
+ * @param mode Derived-field mode
+ */
+void ld2450_compute_derived(ld2450_target_t *target, ld2450_derived_mode_t mode)
+{
+    switch (mode) {
+        case LD2450_DERIVED_FLOAT:
+        {
+            float x = target->x;
+            float y = target->y;
+            target->distance = sqrtf(x * x + y * y);
+            target->angle = -atan2f(x, y) * (180.0f / (float)M_PI);
+            target->derived_valid = true;
+            break;
+        }
+        case LD2450_DERIVED_FIXED:
+        {
+            int32_t x = target->x;
+            int32_t y = target->y;
+            target->distance = (float)ld2450_isqrt32((uint32_t)(x * x + y * y));
+            target->angle = (float)(-ld2450_atan2_cdeg(x, y)) * 0.01f;
+            target->derived_valid = true;
+            break;
+        }
+        case LD2450_DERIVED_NONE:
+        case LD2450_DERIVED_LAZY:
+        default:
+            target->distance = 0.0f;
+            target->angle = 0.0f;
+            target->derived_valid = false;
+            break;
+    }
+}
+
+/**
+ * @brief Get a target's distance from the radar
+ * 
+ * @param target Target
+ * @return Distance in mm
+ */
+float ld2450_target_get_distance(const ld2450_target_t *target)
+{
+    if (!target || !target->valid) {
+        return 0.0f;
+    }
+    
+    if (target->derived_valid) {
+        return target->distance;
+    }
+    
+    float x = target->x;
+    float y = target->y;
+    return sqrtf(x * x + y * y);
+}
+
+/**
+ * @brief Get a target's angle relative to the radar boresight
+ * 
+ * @param target Target
+ * @return Angle in degrees (negative = right of boresight, see README)
+ */
+float ld2450_target_get_angle(const ld2450_target_t *target)
+{
+    if (!target || !target->valid) {
+        return 0.0f;
+    }
+    
+    if (target->derived_valid) {
+        return target->angle;
+    }
+    
+    return -atan2f((float)target->x, (float)target->y) * (180.0f / (float)M_PI);
+}
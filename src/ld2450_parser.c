@@ -11,61 +11,58 @@
  */
 
 #include <string.h>
-#include <math.h>
 #include "ld2450.h"
 #include "ld2450_private.h"
-#include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/task.h"
 #include "freertos/semphr.h"
 
-static const char *TAG = LD2450_LOG_TAG;
+/**
+ * @brief Decode a sign-magnitude protocol value
+ * 
+ * For X, Y and speed the MSB set indicates positive and clear indicates negative,
+ * with the magnitude in the low 15 bits.
+ * 
+ * @param lo Low byte
+ * @param hi High byte
+ * @return Signed value
+ */
+static inline int16_t decode_signed(uint8_t lo, uint8_t hi)
+{
+    int16_t magnitude = (int16_t)(((hi & 0x7F) << 8) | lo);
+    return (hi & 0x80) ? magnitude : -magnitude;
+}
 
 /**
  * @brief Parse target data from a data segment within a frame
  * 
- * @param target_data Pointer to target data segment (8 bytes)
+ * @param target_data Pointer to target data segment (8 bytes, any alignment)
+ * @param mode How derived fields are computed
  * @param target Pointer to target structure to fill
  * @return true if target is valid, false if target segment is empty
  */
-static bool parse_target(const uint8_t *target_data, ld2450_target_t *target)
+static bool parse_target(const uint8_t *target_data, ld2450_derived_mode_t mode,
+                         ld2450_target_t *target)
 {
-    // Check if target segment is empty (all zeros) using faster 32-bit checks
-    uint32_t *data32 = (uint32_t*)target_data;
+    // Check if target segment is empty (all zeros); memcpy keeps this safe for
+    // frames parsed in place at unaligned offsets of the UART buffer
+    uint32_t data32[2];
+    memcpy(data32, target_data, sizeof(data32));
     if (data32[0] == 0 && data32[1] == 0) {
-        target->valid = false;
+        memset(target, 0, sizeof(ld2450_target_t));
         return false;
     }
     
-    // Parse target data according to protocol
-    // X coordinate (little-endian)
-    uint16_t x_raw = target_data[0] | (target_data[1] << 8);
-    // Y coordinate (little-endian)
-    uint16_t y_raw = target_data[2] | (target_data[3] << 8);
-    // Speed (little-endian)
-    uint16_t speed_raw = target_data[4] | (target_data[5] << 8);
-    // Distance resolution (little-endian)
-    uint16_t dist_res_raw = target_data[6] | (target_data[7] << 8);
-    
-    // Convert coordinates according to protocol
-    // For X, Y, Speed: MSB 1 indicates positive, 0 indicates negative
-    // Handle the 15-bit magnitude with proper sign
-    int16_t x_magnitude = x_raw & 0x7FFF;  // Mask off MSB to get magnitude (15 bits)
-    int16_t y_magnitude = y_raw & 0x7FFF;  // Mask off MSB to get magnitude (15 bits)
-    int16_t speed_magnitude = speed_raw & 0x7FFF; // Mask off MSB to get magnitude (15 bits)
-    
-    // Apply sign based on MSB
-    target->x = (target_data[1] & 0x80) ? x_magnitude : -x_magnitude;
-    target->y = (target_data[3] & 0x80) ? y_magnitude : -y_magnitude;
-    target->speed = (target_data[5] & 0x80) ? speed_magnitude : -speed_magnitude;
+    // Parse target data according to protocol (little-endian fields)
+    target->x = decode_signed(target_data[0], target_data[1]);
+    target->y = decode_signed(target_data[2], target_data[3]);
+    target->speed = decode_signed(target_data[4], target_data[5]);
     
     // Distance resolution is used directly
-    target->resolution = dist_res_raw;
-    
-    // Always calculate derived values
-    target->distance = sqrt(target->x * target->x + target->y * target->y);
-    target->angle = -atan2((float)target->x, (float)target->y) * (180.0f / M_PI);
+    target->resolution = target_data[6] | (target_data[7] << 8);
     
     target->valid = true;
+    ld2450_compute_derived(target, mode);
     
     return true;
 }
@@ -75,10 +72,12 @@ static bool parse_target(const uint8_t *target_data, ld2450_target_t *target)
  * 
  * @param data Raw frame data
  * @param len Length of the data
+ * @param mode How derived distance/angle fields are computed
  * @param frame Frame structure to fill
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
-esp_err_t ld2450_parse_frame(const uint8_t *data, size_t len, ld2450_frame_t *frame)
+esp_err_t ld2450_parse_frame(const uint8_t *data, size_t len, ld2450_derived_mode_t mode,
+                             ld2450_frame_t *frame)
 {
     if (!data || !frame || len < LD2450_DATA_FRAME_SIZE) {
         return ESP_ERR_INVALID_ARG;
@@ -87,25 +86,20 @@ esp_err_t ld2450_parse_frame(const uint8_t *data, size_t len, ld2450_frame_t *fr
     // Validate frame header and footer
     if (memcmp(data, LD2450_DATA_FRAME_HEADER, 4) != 0 || 
         memcmp(data + len - 2, LD2450_DATA_FRAME_FOOTER, 2) != 0) {
-        ESP_LOGW(TAG, "Invalid frame header or footer");
-        ESP_LOG_BUFFER_HEX_LEVEL(TAG, data, len, ESP_LOG_DEBUG);
+        // Not logged: a noisy line would flood the console from the processing task
         return ESP_ERR_INVALID_STATE;
     }
     
     // Reset target count
     frame->count = 0;
     
-    // Parse up to 3 targets
+    // Parse up to 3 targets; invalid targets are cleared by parse_target
     for (int i = 0; i < 3; i++) {
         // Target data starts at offset 4 and each target data segment is 8 bytes
         const uint8_t *target_data = data + 4 + (i * 8);
         
-        // Parse target data
-        if (parse_target(target_data, &frame->targets[i])) {
+        if (parse_target(target_data, mode, &frame->targets[i])) {
             frame->count++;
-        } else {
-            // Clear the target data for invalid targets
-            memset(&frame->targets[i], 0, sizeof(ld2450_target_t));
         }
     }
     
@@ -118,183 +112,541 @@ esp_err_t ld2450_parse_frame(const uint8_t *data, size_t len, ld2450_frame_t *fr
  * This function processes a complete data frame, parses it, and delivers
  * the results to the registered callback if any.
  * 
+ * @param instance Driver instance the frame was received on
  * @param data Frame data
  * @param len Frame length
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
-esp_err_t ld2450_handle_data_frame(const uint8_t *data, size_t len)
+esp_err_t ld2450_handle_data_frame(ld2450_state_t *instance, const uint8_t *data, size_t len)
 {
-    ld2450_state_t *instance = ld2450_get_instance();
     esp_err_t ret;
     
     if (!instance || !instance->initialized) {
         return ESP_ERR_INVALID_STATE;
     }
     
-    // Skip processing if we're in config mode
-    if (instance->in_config_mode) {
-        return ESP_OK;
-    }
-    
-    // Static frame structure for parsing
-    static ld2450_frame_t frame;
+    // Parse straight into the next ring slot (or the scratch frame if none is free)
+    bool in_ring;
+    ld2450_frame_t *frame = ld2450_ring_write_slot(instance, &in_ring);
     
     // Parse the frame
-    ret = ld2450_parse_frame(data, len, &frame);
+    ret = ld2450_parse_frame(data, len, instance->derived_mode, frame);
     if (ret != ESP_OK) {
         return ret;
     }
     
-    // Call the callback if registered - minimize mutex protected region
+    frame->timestamp_us = instance->frame_timestamp_us;
+    frame->sequence = instance->frame_sequence++;
+    LD2450_TRACE(instance, LD2450_TRACE_FRAME, frame->count, 0, frame->sequence);
+    
+    // Zones, tracker, heatmap and fusion see every frame, including those the delivery policy withholds
+    if (instance->zones) {
+        ld2450_zone_evaluate(instance, frame);
+    }
+    if (instance->heatmap) {
+        ld2450_heatmap_update(instance, frame);
+    }
+    ld2450_tracker_update(instance, frame);
+    if (instance->fusion_source) {
+        ld2450_fusion_frame(instance, frame);
+    }
+    if (instance->event_loop) {
+        ld2450_event_presence(instance, frame);
+    }
+    if (instance->power) {
+        ld2450_power_frame(instance, frame);
+    }
+    if (instance->health) {
+        ld2450_health_frame(instance, frame);
+    }
+    
+    // The stream is live: now run the identity queries deferred at startup
+    if (instance->cache_refresh_pending) {
+        ld2450_cache_refresh_identity(instance);
+    }
+    
+    if (!ld2450_delivery_filter(instance, frame)) {
+        LD2450_STATS_INC(instance, frames_suppressed);
+        return ESP_OK;
+    }
+    
+    ld2450_ring_publish(instance, frame, in_ring);
+    
+#if LD2450_ENABLE_STATS || LD2450_ENABLE_TRACE
+    int64_t deliver_us = esp_timer_get_time();
+#endif
+#if LD2450_ENABLE_STATS
+    portENTER_CRITICAL(&instance->stats_lock);
+    instance->stats.frames_delivered++;
+    ld2450_stats_sample(&instance->stats.latency, deliver_us - frame->timestamp_us);
+    portEXIT_CRITICAL(&instance->stats_lock);
+#endif
+    
+    // Call the callback if registered; the frame is passed by reference, not copied
     if (instance->target_callback != NULL) {
-        // Create a local copy of the frame before calling callback
-        ld2450_frame_t frame_copy = frame;
-        
-        // Call callback outside of any mutex lock
-        instance->target_callback(&frame_copy, instance->user_ctx);
+        instance->target_callback(frame, instance->user_ctx);
+#if LD2450_ENABLE_STATS || LD2450_ENABLE_TRACE
+        int64_t callback_us = esp_timer_get_time() - deliver_us;
+        LD2450_TRACE(instance, LD2450_TRACE_CALLBACK, 0, 0, (uint32_t)MIN(callback_us, UINT32_MAX));
+#endif
+#if LD2450_ENABLE_STATS
+        portENTER_CRITICAL(&instance->stats_lock);
+        ld2450_stats_sample(&instance->stats.callback_time, callback_us);
+        portEXIT_CRITICAL(&instance->stats_lock);
+#endif
+    }
+    
+    if (instance->batch) {
+        ld2450_batch_frame(instance, frame);
+    }
+    
+    ld2450_track_cb_t track_callback = instance->tracker.callback;
+    if (track_callback != NULL && instance->tracker.config.enabled) {
+        track_callback(&instance->tracker.published, instance->tracker.user_ctx);
+    }
+    
+    if (atomic_load_explicit(&instance->subscriber_count, memory_order_relaxed)) {
+        ld2450_subscriber_dispatch(instance, frame);
+    }
+    
+    if (instance->event_loop) {
+        ld2450_event_frame(instance, frame);
     }
     
     return ESP_OK;
 }
 
+/** @brief Data frame header as a 32-bit word for single-compare detection */
+static const frame_header_t s_data_header = { .bytes = {0xAA, 0xFF, 0x03, 0x00} };
+
+/**
+ * @brief Estimate the arrival time of a byte within a block
+ * 
+ * @param instance Driver instance
+ * @param start_us Arrival time of the first byte of the block
+ * @param offset Byte offset within the block
+ * @return Estimated arrival time in microseconds
+ */
+static inline int64_t byte_time_us(const ld2450_state_t *instance, int64_t start_us, size_t offset)
+{
+    return start_us + (int64_t)((uint64_t)offset * instance->byte_time_ns / 1000);
+}
+
 /**
- * @brief Process radar data coming in from UART
+ * @brief Scan a block of bytes for data frames
  * 
- * This function processes incoming data from the UART, looking for valid frame
- * headers and footers, and passing complete frames to the parser.
+ * Single receive path for UART chunks and externally sourced bytes. Headers are
+ * located with memchr() on the first header byte plus one 32-bit compare, and
+ * frames lying entirely inside the block are parsed in place without copying.
+ * Only a frame straddling block boundaries is assembled in frame_buffer, with
+ * bulk memcpy. Partial header state survives across calls, and a frame that
+ * fails its footer check is rescanned from its second byte instead of dropped.
  * 
- * @param byte Incoming byte to process
- * @return esp_err_t ESP_OK if a frame was successfully processed, ESP_ERR_NOT_FINISHED if still collecting data, or error code
+ * @param instance Driver instance
+ * @param data Bytes to scan
+ * @param len Number of bytes
+ * @param start_us Estimated arrival time of data[0]
+ * @return Number of frames delivered
  */
-esp_err_t ld2450_process_byte(uint8_t byte)
+static int ld2450_scan_block(ld2450_state_t *instance, const uint8_t *data, size_t len,
+                             int64_t start_us)
 {
-    ld2450_state_t *instance = ld2450_get_instance();
-    
-    if (!instance || !instance->initialized) {
-        return ESP_ERR_INVALID_STATE;
-    }
+    size_t rescan_end = 0;   // Headers found before this offset were recovered from a rejected frame
+    int frames = 0;
+    size_t i = 0;
     
-    // Skip data processing if we're in config mode
-    if (instance->in_config_mode) {
-        return ESP_ERR_NOT_FINISHED;
-    }
-    
-    // Check for frame header
-    if (!instance->frame_synced) {
-        // Shift bytes through a 4-byte window to look for header
-        memmove(instance->frame_buffer, instance->frame_buffer + 1, 3);
-        instance->frame_buffer[3] = byte;
+    while (i < len) {
+        if (instance->frame_synced) {
+            // Collecting a frame that started in an earlier block
+            size_t n = MIN((size_t)(LD2450_DATA_FRAME_SIZE - instance->frame_idx), len - i);
+            memcpy(instance->frame_buffer + instance->frame_idx, data + i, n);
+            instance->frame_idx += n;
+            i += n;
+            
+            if (instance->frame_idx < LD2450_DATA_FRAME_SIZE) {
+                break;
+            }
+            
+            instance->frame_synced = false;
+            instance->frame_idx = 0;
+            
+            if (memcmp(instance->frame_buffer + LD2450_DATA_FRAME_SIZE - 2,
+                       LD2450_DATA_FRAME_FOOTER, 2) == 0) {
+                LD2450_SYNC_ADD(instance, frames_ok, 1);
+                if (instance->resync_pending) {
+                    LD2450_SYNC_ADD(instance, frames_recovered, 1);
+                    instance->resync_pending = false;
+                    LD2450_TRACE(instance, LD2450_TRACE_RESYNC, 0, 0, instance->frame_sequence);
+                }
+                ld2450_handle_data_frame(instance, instance->frame_buffer, LD2450_DATA_FRAME_SIZE);
+                frames++;
+                continue;
+            }
+            
+            // False header: rescan everything after its first byte. The rescan holds
+            // fewer bytes than a frame, so it can never complete one and recurse again.
+            LD2450_SYNC_ADD(instance, footer_errors, 1);
+            LD2450_TRACE(instance, LD2450_TRACE_FOOTER_ERROR, 0, 0, instance->sync_stats.footer_errors);
+            if (instance->event_loop) {
+                ld2450_event_sync_lost(instance, LD2450_SYNC_LOST_BAD_FRAME);
+            }
+            LD2450_SYNC_ADD(instance, bytes_skipped, 1);
+            
+            uint8_t pending[LD2450_DATA_FRAME_SIZE - 1];
+            memcpy(pending, instance->frame_buffer + 1, sizeof(pending));
+            ld2450_scan_block(instance, pending, sizeof(pending),
+                              instance->frame_timestamp_us + instance->byte_time_ns / 1000);
+            instance->resync_pending = instance->frame_synced || instance->header_match > 0;
+            continue;
+        }
+        
+        if (instance->header_match > 0) {
+            // Finish a header that started at the end of the previous block
+            while (i < len && instance->header_match < sizeof(LD2450_DATA_FRAME_HEADER) &&
+                   data[i] == LD2450_DATA_FRAME_HEADER[instance->header_match]) {
+                instance->header_match++;
+                i++;
+            }
+            
+            if (instance->header_match == sizeof(LD2450_DATA_FRAME_HEADER)) {
+                memcpy(instance->frame_buffer, LD2450_DATA_FRAME_HEADER, 4);
+                instance->frame_idx = 4;
+                instance->frame_synced = true;
+                instance->header_match = 0;
+                continue;
+            }
+            if (i == len) {
+                break;
+            }
+            
+            // Mismatch: drop the partial header and search again from this byte
+            LD2450_SYNC_ADD(instance, bytes_skipped, instance->header_match);
+            instance->header_match = 0;
+        }
         
-        // Check if we've found a header
-        if (memcmp(instance->frame_buffer, LD2450_DATA_FRAME_HEADER, 4) == 0) {
+        // Locate the next candidate header byte
+        const uint8_t *p = memchr(data + i, LD2450_DATA_FRAME_HEADER[0], len - i);
+        if (!p) {
+            LD2450_SYNC_ADD(instance, bytes_skipped, len - i);
+            break;
+        }
+        
+        size_t at = (size_t)(p - data);
+        LD2450_SYNC_ADD(instance, bytes_skipped, at - i);
+        i = at;
+        size_t avail = len - i;
+        
+        if (avail < sizeof(LD2450_DATA_FRAME_HEADER)) {
+            // Possible header cut off by the end of the block: remember how much matched
+            size_t k = 1;
+            while (k < avail && p[k] == LD2450_DATA_FRAME_HEADER[k]) {
+                k++;
+            }
+            if (k == avail) {
+                instance->header_match = (uint8_t)k;
+                instance->frame_timestamp_us = byte_time_us(instance, start_us, i);
+                instance->resync_pending = (i < rescan_end);
+                break;
+            }
+            LD2450_SYNC_ADD(instance, bytes_skipped, 1);
+            i++;
+            continue;
+        }
+        
+        frame_header_t word;
+        memcpy(&word.value, p, sizeof(word.value));
+        if (word.value != s_data_header.value) {
+            LD2450_SYNC_ADD(instance, bytes_skipped, 1);
+            i++;
+            continue;
+        }
+        
+        instance->frame_timestamp_us = byte_time_us(instance, start_us, i);
+        instance->resync_pending = (i < rescan_end);
+        
+        if (avail < LD2450_DATA_FRAME_SIZE) {
+            // Frame continues in the next block
+            memcpy(instance->frame_buffer, p, avail);
+            instance->frame_idx = avail;
             instance->frame_synced = true;
-            instance->frame_idx = 4; // We already have 4 bytes
-            ESP_LOGV(TAG, "Frame sync acquired");
+            break;
         }
         
-        return ESP_ERR_NOT_FINISHED;
+        // Whole frame inside this block: validate and parse in place
+        if (p[LD2450_DATA_FRAME_SIZE - 2] == LD2450_DATA_FRAME_FOOTER[0] &&
+            p[LD2450_DATA_FRAME_SIZE - 1] == LD2450_DATA_FRAME_FOOTER[1]) {
+            LD2450_SYNC_ADD(instance, frames_ok, 1);
+            if (instance->resync_pending) {
+                LD2450_SYNC_ADD(instance, frames_recovered, 1);
+                instance->resync_pending = false;
+                LD2450_TRACE(instance, LD2450_TRACE_RESYNC, 0, 0, instance->frame_sequence);
+            }
+            ld2450_handle_data_frame(instance, p, LD2450_DATA_FRAME_SIZE);
+            frames++;
+            i += LD2450_DATA_FRAME_SIZE;
+            continue;
+        }
+        
+        // False header: keep scanning from its second byte
+        LD2450_SYNC_ADD(instance, footer_errors, 1);
+        LD2450_TRACE(instance, LD2450_TRACE_FOOTER_ERROR, 0, 0, instance->sync_stats.footer_errors);
+        if (instance->event_loop) {
+            ld2450_event_sync_lost(instance, LD2450_SYNC_LOST_BAD_FRAME);
+        }
+        LD2450_SYNC_ADD(instance, bytes_skipped, 1);
+        i++;
+        rescan_end = i + LD2450_DATA_FRAME_SIZE - 1;
     }
     
-    // If we're collecting a frame, add the byte
-    if (instance->frame_idx < LD2450_DATA_FRAME_SIZE) {
-        instance->frame_buffer[instance->frame_idx++] = byte;
-        
-        // Check if we have a complete frame
-        if (instance->frame_idx == LD2450_DATA_FRAME_SIZE) {
-            // Validate frame footer
-            if (memcmp(instance->frame_buffer + LD2450_DATA_FRAME_SIZE - 2, 
-                      LD2450_DATA_FRAME_FOOTER, 2) == 0) {
-                
-                // Process the complete frame
-                esp_err_t ret = ld2450_handle_data_frame(instance->frame_buffer, LD2450_DATA_FRAME_SIZE);
-                
-                // Reset for next frame
-                instance->frame_synced = false;
-                instance->frame_idx = 0;
-                
-                return ret;
+    return frames;
+}
+
+/**
+ * @brief Scan a block of bytes for configuration ACK frames
+ * 
+ * Runs alongside ld2450_scan_block() while a command awaits its ACK. ACKs are
+ * variable length (header, 16-bit length, payload, footer); a partial ACK is
+ * carried across blocks in ack_rx and complete ones go to ld2450_command_ack().
+ * 
+ * @param instance Driver instance
+ * @param data Bytes to scan
+ * @param len Number of bytes
+ */
+void ld2450_scan_ack(ld2450_state_t *instance, const uint8_t *data, size_t len)
+{
+    size_t i = 0;
+    
+    while (i < len) {
+        if (instance->ack_idx < sizeof(LD2450_CONFIG_FRAME_HEADER)) {
+            if (instance->ack_idx == 0) {
+                const uint8_t *p = memchr(data + i, LD2450_CONFIG_FRAME_HEADER[0], len - i);
+                if (!p) {
+                    break;
+                }
+                i = (size_t)(p - data);
+            }
+            
+            if (data[i] == LD2450_CONFIG_FRAME_HEADER[instance->ack_idx]) {
+                instance->ack_rx[instance->ack_idx++] = data[i++];
+            } else if (instance->ack_idx > 0) {
+                // Mismatch: retry this byte as the start of a new header
+                instance->ack_idx = 0;
             } else {
-                // Invalid footer, resync
-                ESP_LOGW(TAG, "Invalid frame footer, resyncing");
-                instance->frame_synced = false;
-                instance->frame_idx = 0;
-                
-                return ESP_ERR_INVALID_STATE;
+                i++;
             }
+            continue;
+        }
+        
+        // Length field first, then the rest of the frame in one copy
+        if (instance->ack_idx < 6) {
+            size_t n = MIN((size_t)(6 - instance->ack_idx), len - i);
+            memcpy(instance->ack_rx + instance->ack_idx, data + i, n);
+            instance->ack_idx += n;
+            i += n;
+            continue;
+        }
+        
+        size_t total = 10 + (instance->ack_rx[4] | (instance->ack_rx[5] << 8));
+        if (total > LD2450_ACK_BUFFER_SIZE) {
+            LD2450_TRACE(instance, LD2450_TRACE_ACK_INVALID, 0, (uint16_t)MIN(total, UINT16_MAX), 0);
+            instance->ack_idx = 0;
+            continue;
+        }
+        
+        size_t n = MIN(total - instance->ack_idx, len - i);
+        memcpy(instance->ack_rx + instance->ack_idx, data + i, n);
+        instance->ack_idx += n;
+        i += n;
+        
+        if (instance->ack_idx < total) {
+            continue;
+        }
+        
+        instance->ack_idx = 0;
+        if (memcmp(instance->ack_rx + total - 4, LD2450_CONFIG_FRAME_FOOTER, 4) == 0) {
+            ld2450_command_ack(instance, instance->ack_rx, total);
+        } else {
+            LD2450_TRACE(instance, LD2450_TRACE_ACK_INVALID, 0, (uint16_t)total, 0);
         }
     }
+}
+
+/**
+ * @brief Process a chunk of externally sourced radar data
+ * 
+ * Bytes are fed through the same scanner as UART data, so frames are delivered
+ * to the callback and frame ring as usual. Intended for instances created with
+ * auto_processing disabled.
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param data Data buffer
+ * @param len Length of data
+ * @return esp_err_t ESP_OK if at least one frame was processed, ESP_ERR_NOT_FINISHED if
+ *         more data is needed, error code otherwise
+ */
+esp_err_t ld2450_dev_process_data(ld2450_handle_t handle, const uint8_t *data, size_t len)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
     
-    return ESP_ERR_NOT_FINISHED;
+    if (!data) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    int64_t start_us = esp_timer_get_time() -
+        (int64_t)((uint64_t)len * instance->byte_time_ns / 1000);
+    
+    return ld2450_scan_block(instance, data, len, start_us) > 0 ? ESP_OK : ESP_ERR_NOT_FINISHED;
 }
 
 /**
- * @brief Process a chunk of UART data
+ * @brief Process a chunk of externally sourced radar data on the default instance
  * 
- * @param data UART data buffer
+ * @param data Data buffer
  * @param len Length of data
  * @return esp_err_t ESP_OK if at least one frame was processed, otherwise error code
  */
 esp_err_t ld2450_process_data(const uint8_t *data, size_t len)
 {
-    esp_err_t ret = ESP_ERR_NOT_FINISHED;
-    esp_err_t last_result = ESP_ERR_NOT_FINISHED;
-    
-    // Process each byte
-    for (size_t i = 0; i < len; i++) {
-        last_result = ld2450_process_byte(data[i]);
-        if (last_result == ESP_OK) {
-            ret = ESP_OK; // At least one frame was successfully processed
+    return ld2450_dev_process_data(NULL, data, len);
+}
+
+/**
+ * @brief Scan the bytes held by ld2450_rx_defer()
+ * 
+ * Loops until none are left: a callback may issue another command meanwhile.
+ * 
+ * @param instance Driver instance
+ */
+static void rx_drain_deferred(ld2450_state_t *instance)
+{
+    while (instance->rx_deferred_len > 0) {
+        uint8_t chunk[128];
+        size_t end = instance->rx_deferred_end[0];
+        size_t n = MIN(end, sizeof(chunk));
+        
+        // A piece ends before the rest of its read, which ended at the read's time
+        int64_t timestamp_us = instance->rx_deferred_us[0] -
+                               (int64_t)((uint64_t)(end - n) * instance->byte_time_ns / 1000);
+        
+        memcpy(chunk, instance->rx_deferred, n);
+        instance->rx_deferred_len -= n;
+        memmove(instance->rx_deferred, instance->rx_deferred + n, instance->rx_deferred_len);
+        for (uint8_t r = 0; r < instance->rx_deferred_reads; r++) {
+            instance->rx_deferred_end[r] -= n;
+        }
+        if (instance->rx_deferred_end[0] == 0) {
+            instance->rx_deferred_reads--;
+            memmove(instance->rx_deferred_end, instance->rx_deferred_end + 1,
+                    instance->rx_deferred_reads * sizeof(instance->rx_deferred_end[0]));
+            memmove(instance->rx_deferred_us, instance->rx_deferred_us + 1,
+                    instance->rx_deferred_reads * sizeof(instance->rx_deferred_us[0]));
+        }
+        
+        if (!instance->replay_running && ld2450_power_rx(instance)) {
+            ld2450_rx_feed(instance, chunk, n, timestamp_us);
         }
     }
-    
-    return ret;
 }
 
 /**
  * @brief UART event handler for batch processing of incoming data
  * 
+ * @param instance Driver instance the data was received on
  * @param data_buffer Buffer containing UART data
  * @param len Length of data in the buffer
  */
-void ld2450_uart_event_handler(uint8_t *data_buffer, size_t len)
+void ld2450_uart_event_handler(ld2450_state_t *instance, const uint8_t *data_buffer, size_t len)
 {
-    ld2450_state_t *instance = ld2450_get_instance();
-    
     if (!instance || !instance->initialized) {
         return;
     }
     
-    // Skip data processing if we're in config mode
-    if (instance->in_config_mode) {
-        ESP_LOGV(TAG, "Skipping data processing while in config mode");
+    // Bytes a command from a poll-time callback read arrived before this chunk
+    rx_drain_deferred(instance);
+    
+    // Demultiplex: ACKs go to the command engine, data frames to the frame scanner
+    if (instance->cmd_waiting) {
+        ld2450_scan_ack(instance, data_buffer, len);
+    }
+    
+    // While a replay runs, its bytes stand in for the UART's; a duty-cycled radar is ignored
+    if (!instance->replay_running && ld2450_power_rx(instance)) {
+        ld2450_rx_feed(instance, data_buffer, len, instance->chunk_timestamp_us);
+    }
+    
+    // Bytes a callback's command read while the block above was being scanned come after it
+    rx_drain_deferred(instance);
+}
+
+/**
+ * @brief Hold bytes read by a command issued from a callback for the frame scanner
+ * 
+ * @param instance Driver instance
+ * @param data Received bytes
+ * @param len Number of bytes
+ */
+void ld2450_rx_defer(ld2450_state_t *instance, const uint8_t *data, size_t len)
+{
+    size_t room = sizeof(instance->rx_deferred) - instance->rx_deferred_len;
+    
+    if (len > room) {
+        LD2450_STATS_INC(instance, uart_buffer_full);
+        LD2450_TRACE(instance, LD2450_TRACE_UART_OVERFLOW, 3, 0, (uint32_t)(len - room));
+        len = room;
+    }
+    
+    if (len == 0) {
         return;
     }
     
-    // Process multiple bytes at once using state machine approach
-    for (int i = 0; i < len; i++) {
-        if (!instance->frame_synced) {
-            // Use efficient header detection with 4 consecutive bytes
-            if (i <= len - 4) {
-                if (memcmp(&data_buffer[i], LD2450_DATA_FRAME_HEADER, 4) == 0) {
-                    instance->frame_synced = true;
-                    memcpy(instance->frame_buffer, LD2450_DATA_FRAME_HEADER, 4);
-                    instance->frame_idx = 4;
-                    i += 3; // Skip the remaining header bytes
-                }
-            }
-        } else if (instance->frame_idx < LD2450_DATA_FRAME_SIZE) {
-            instance->frame_buffer[instance->frame_idx++] = data_buffer[i];
-            
-            // Process complete frame
-            if (instance->frame_idx == LD2450_DATA_FRAME_SIZE) {
-                // Validate footer
-                if (memcmp(instance->frame_buffer + LD2450_DATA_FRAME_SIZE - 2, 
-                           LD2450_DATA_FRAME_FOOTER, 2) == 0) {
-                    ld2450_handle_data_frame(instance->frame_buffer, LD2450_DATA_FRAME_SIZE);
-                }
-                instance->frame_synced = false;
-                instance->frame_idx = 0;
-            }
-        }
+    memcpy(instance->rx_deferred + instance->rx_deferred_len, data, len);
+    instance->rx_deferred_len += len;
+    
+    // Each read keeps its own time; with every slot taken, the last read absorbs this one
+    if (instance->rx_deferred_reads < LD2450_NESTED_RX_READS) {
+        instance->rx_deferred_reads++;
     }
-}
\ No newline at end of file
+    instance->rx_deferred_end[instance->rx_deferred_reads - 1] = instance->rx_deferred_len;
+    instance->rx_deferred_us[instance->rx_deferred_reads - 1] = esp_timer_get_time();
+}
+
+/**
+ * @brief Source-independent receive path: scan a chunk for data frames
+ * 
+ * @param instance Driver instance
+ * @param data Received bytes
+ * @param len Number of bytes
+ * @param timestamp_us Time the chunk's last byte had arrived
+ */
+void ld2450_rx_feed(ld2450_state_t *instance, const uint8_t *data, size_t len, int64_t timestamp_us)
+{
+    // The chunk was stamped when its last byte had arrived; back-date to its first byte
+    int64_t start_us = timestamp_us - (int64_t)((uint64_t)len * instance->byte_time_ns / 1000);
+    
+    ld2450_scan_block(instance, data, len, start_us);
+}
+
+/**
+ * @brief Get frame synchronization counters
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param stats Pointer to store the counters
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_get_sync_stats(ld2450_handle_t handle, ld2450_sync_stats_t *stats)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized || !stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    portENTER_CRITICAL(&instance->stats_lock);
+    *stats = instance->sync_stats;
+    portEXIT_CRITICAL(&instance->stats_lock);
+    return ESP_OK;
+}
@@ -0,0 +1,441 @@
+/**
+ * @file ld2450_power.c
+ * @brief Presence-gated low-power operation
+ * 
+ * A small state machine run by the processing task. While frames stream it holds
+ * an ESP_PM_NO_LIGHT_SLEEP lock; once the UART has been silent for the idle
+ * timeout it releases the lock and relies on UART (or RX GPIO) wakeup to resume.
+ * A radar that has reported no target for absent_timeout_ms is duty-cycled: its
+ * frames are dropped unparsed and its wakeup source disabled, except for one
+ * listen window per period that decides whether to resume streaming.
+ * 
+ * @author NieRVoid
+ * @date 2025-03-12
+ * @license MIT
+ */
+
+#include <stdlib.h>
+#include "ld2450.h"
+#include "ld2450_private.h"
+#include "esp_log.h"
+#include "esp_pm.h"
+#include "esp_sleep.h"
+#include "esp_timer.h"
+#include "driver/gpio.h"
+#include "driver/uart.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = LD2450_LOG_TAG;
+
+/**
+ * @brief Low-power state of an instance, owned by its processing task
+ */
+struct ld2450_power {
+    ld2450_power_config_t config;
+    /** @brief NO_LIGHT_SLEEP lock (NULL without CONFIG_PM_ENABLE) */
+    esp_pm_lock_handle_t lock;
+    /** @brief The lock is held */
+    bool locked;
+    /** @brief The UART cannot wake the chip, the RX GPIO does instead */
+    bool gpio_wakeup;
+    /** @brief Last time UART data arrived */
+    int64_t last_rx_us;
+    /** @brief Last frame with a target */
+    int64_t present_us;
+    /** @brief End of the current listen window or duty sleep */
+    int64_t until_us;
+    /** @brief Start of the interval not yet added to stats */
+    int64_t since_us;
+    /** @brief Guards stats against ld2450_get_power_stats() */
+    portMUX_TYPE stats_lock;
+    ld2450_power_stats_t stats;
+};
+
+/** @brief UART ports whose radar may wake the chip from light sleep */
+static uint32_t s_wakeup_ports;
+
+/** @brief Guards s_wakeup_ports and the UART wakeup sources */
+static SemaphoreHandle_t s_wakeup_lock;
+
+/**
+ * @brief Enable or disable the wakeup source of one instance
+ * 
+ * ESP-IDF can only disable UART wakeup for all ports at once, so the sources
+ * are rebuilt from the set of ports that currently want it.
+ */
+static void power_set_wakeup(ld2450_state_t *instance, bool enable)
+{
+    if (instance->power->gpio_wakeup) {
+        if (enable) {
+            gpio_wakeup_enable(instance->rx_pin, GPIO_INTR_LOW_LEVEL);
+        } else {
+            gpio_wakeup_disable(instance->rx_pin);
+        }
+        return;
+    }
+    
+    xSemaphoreTake(s_wakeup_lock, portMAX_DELAY);
+    if (enable) {
+        s_wakeup_ports |= 1U << instance->uart_port;
+    } else {
+        s_wakeup_ports &= ~(1U << instance->uart_port);
+    }
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_UART);
+    for (int port = 0; port < UART_NUM_MAX; port++) {
+        if (s_wakeup_ports & (1U << port)) {
+            esp_sleep_enable_uart_wakeup(port);
+        }
+    }
+    xSemaphoreGive(s_wakeup_lock);
+}
+
+/**
+ * @brief Move to a new state, taking or releasing the PM lock as it requires
+ */
+static void power_enter(ld2450_state_t *instance, ld2450_power_state_t state, int64_t now)
+{
+    ld2450_power_t *power = instance->power;
+    ld2450_power_state_t prev = power->stats.state;
+    bool locked = state == LD2450_POWER_STREAMING || state == LD2450_POWER_DUTY_LISTEN;
+    
+    if (locked != power->locked && power->lock) {
+        if (locked) {
+            esp_pm_lock_acquire(power->lock);
+        } else {
+            esp_pm_lock_release(power->lock);
+        }
+    }
+    
+    if (prev == LD2450_POWER_DUTY_SLEEP) {
+        power_set_wakeup(instance, true);
+    } else if (state == LD2450_POWER_DUTY_SLEEP) {
+        power_set_wakeup(instance, false);
+    }
+    
+    switch (state) {
+        case LD2450_POWER_DUTY_SLEEP:
+            power->until_us = now + (int64_t)power->config.absent_period_ms * 1000 -
+                              LD2450_POWER_LISTEN_MS * 1000;
+            break;
+        case LD2450_POWER_DUTY_LISTEN:
+            power->until_us = now + LD2450_POWER_LISTEN_MS * 1000;
+            // Bytes seen while asleep were dropped, so resynchronize on a fresh header
+            instance->frame_synced = false;
+            instance->frame_idx = 0;
+            instance->header_match = 0;
+            break;
+        default:
+            break;
+    }
+    
+    // Close the interval spent in the previous state
+    uint64_t span = now > power->since_us ? (uint64_t)(now - power->since_us) : 0;
+    portENTER_CRITICAL(&power->stats_lock);
+    if (power->locked) {
+        power->stats.awake_us += span;
+    } else {
+        power->stats.lock_released_us += span;
+        if (prev == LD2450_POWER_DUTY_SLEEP) {
+            power->stats.duty_sleep_us += span;
+        }
+    }
+    if (locked && !power->locked) {
+        power->stats.wakeups++;
+    }
+    if (state == LD2450_POWER_DUTY_LISTEN) {
+        power->stats.duty_listens++;
+    }
+    power->since_us = MAX(now, power->since_us);
+    power->locked = locked;
+    power->stats.state = state;
+    portEXIT_CRITICAL(&power->stats_lock);
+    
+    ESP_LOGD(TAG, "UART%d power state %d -> %d", (int)instance->uart_port, prev, state);
+}
+
+/**
+ * @brief Note UART activity
+ * 
+ * @param instance Driver instance
+ * @return true if the bytes should be scanned for frames, false while duty-cycled
+ */
+bool ld2450_power_rx(ld2450_state_t *instance)
+{
+    ld2450_power_t *power = instance->power;
+    
+    if (!power) {
+        return true;
+    }
+    
+    power->last_rx_us = instance->chunk_timestamp_us;
+    if (power->stats.state == LD2450_POWER_IDLE) {
+        // Woken by the radar; the bytes that woke the chip are lost, the scanner resyncs
+        power_enter(instance, LD2450_POWER_STREAMING, power->last_rx_us);
+    }
+    
+    return power->stats.state != LD2450_POWER_DUTY_SLEEP;
+}
+
+/**
+ * @brief Feed a parsed frame's target count to the presence gate
+ * 
+ * @param instance Driver instance
+ * @param frame Parsed frame
+ */
+void ld2450_power_frame(ld2450_state_t *instance, const ld2450_frame_t *frame)
+{
+    ld2450_power_t *power = instance->power;
+    int64_t now = frame->timestamp_us;
+    
+    if (frame->count > 0) {
+        power->present_us = now;
+    }
+    
+    switch (power->stats.state) {
+        case LD2450_POWER_STREAMING:
+            if (frame->count == 0 && power->config.absent_timeout_ms &&
+                now - power->present_us >= (int64_t)power->config.absent_timeout_ms * 1000) {
+                ESP_LOGI(TAG, "UART%d no targets, duty-cycling", (int)instance->uart_port);
+                power_enter(instance, LD2450_POWER_DUTY_SLEEP, now);
+            }
+            break;
+        case LD2450_POWER_DUTY_LISTEN:
+            if (frame->count > 0) {
+                ESP_LOGI(TAG, "UART%d target present, streaming", (int)instance->uart_port);
+                power_enter(instance, LD2450_POWER_STREAMING, now);
+            } else {
+                power_enter(instance, LD2450_POWER_DUTY_SLEEP, now);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Run the low-power timers
+ * 
+ * @param instance Driver instance
+ */
+void ld2450_power_poll(ld2450_state_t *instance)
+{
+    ld2450_power_t *power = instance->power;
+    
+    if (!power) {
+        return;
+    }
+    
+    int64_t now = esp_timer_get_time();
+    switch (power->stats.state) {
+        case LD2450_POWER_STREAMING:
+            if (!instance->cmd_waiting &&
+                now - power->last_rx_us >= (int64_t)power->config.idle_timeout_ms * 1000) {
+                power_enter(instance, LD2450_POWER_IDLE, now);
+            }
+            break;
+        case LD2450_POWER_DUTY_SLEEP:
+            // A command needs the chip awake for its ACK
+            if (instance->cmd_waiting || now >= power->until_us) {
+                power_enter(instance, LD2450_POWER_DUTY_LISTEN, now);
+            }
+            break;
+        case LD2450_POWER_DUTY_LISTEN:
+            if (!instance->cmd_waiting && now >= power->until_us) {
+                power_enter(instance, LD2450_POWER_DUTY_SLEEP, now);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Time until the next low-power timer expires
+ * 
+ * @param instance Driver instance
+ * @return Ticks to wait (portMAX_DELAY if none is running)
+ */
+TickType_t ld2450_power_wait_ticks(ld2450_state_t *instance)
+{
+    ld2450_power_t *power = instance->power;
+    int64_t deadline;
+    
+    if (!power) {
+        return portMAX_DELAY;
+    }
+    
+    switch (power->stats.state) {
+        case LD2450_POWER_STREAMING:
+            deadline = power->last_rx_us + (int64_t)power->config.idle_timeout_ms * 1000;
+            break;
+        case LD2450_POWER_DUTY_SLEEP:
+        case LD2450_POWER_DUTY_LISTEN:
+            deadline = power->until_us;
+            break;
+        default:
+            return portMAX_DELAY;
+    }
+    
+    int64_t remaining_us = deadline - esp_timer_get_time();
+    if (remaining_us <= 0) {
+        return 0;
+    }
+    
+    return pdMS_TO_TICKS((remaining_us + 999) / 1000) + 1;
+}
+
+/**
+ * @brief Duty cycle period while the radar is duty-cycled
+ * 
+ * @param instance Driver instance
+ * @return Period in microseconds, 0 when frames are not being skipped
+ */
+int64_t ld2450_power_duty_period_us(ld2450_state_t *instance)
+{
+    ld2450_power_t *power = instance->power;
+    
+    if (!power || (power->stats.state != LD2450_POWER_DUTY_SLEEP &&
+                   power->stats.state != LD2450_POWER_DUTY_LISTEN)) {
+        return 0;
+    }
+    
+    return (int64_t)power->config.absent_period_ms * 1000;
+}
+
+/**
+ * @brief Set up low-power operation
+ * 
+ * @param instance Driver instance, with the UART configured
+ * @param config Low-power configuration
+ * @return esp_err_t ESP_OK on success (or if not enabled), error code otherwise
+ */
+esp_err_t ld2450_power_init(ld2450_state_t *instance, const ld2450_power_config_t *config)
+{
+    if (!config->enabled) {
+        return ESP_OK;
+    }
+    
+    // Instances may be created concurrently
+    if (!ld2450_mutex_once(&s_wakeup_lock)) {
+        return ESP_ERR_NO_MEM;
+    }
+    
+    ld2450_power_t *power = calloc(1, sizeof(ld2450_power_t));
+    if (!power) {
+        return ESP_ERR_NO_MEM;
+    }
+    
+    power->config = *config;
+    if (!power->config.idle_timeout_ms) {
+        power->config.idle_timeout_ms = LD2450_POWER_IDLE_TIMEOUT_MS;
+    }
+    if (!power->config.wakeup_threshold) {
+        power->config.wakeup_threshold = LD2450_POWER_WAKEUP_THRESHOLD;
+    }
+    if (!power->config.absent_period_ms) {
+        power->config.absent_period_ms = LD2450_POWER_ABSENT_PERIOD_MS;
+    }
+    if (power->config.absent_period_ms < 2 * LD2450_POWER_LISTEN_MS) {
+        power->config.absent_period_ms = 2 * LD2450_POWER_LISTEN_MS;
+    }
+    portMUX_INITIALIZE(&power->stats_lock);
+    
+    esp_err_t ret = esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "ld2450", &power->lock);
+    if (ret == ESP_ERR_NOT_SUPPORTED) {
+        ESP_LOGW(TAG, "Power management is disabled, low-power mode only duty-cycles the parser");
+        power->lock = NULL;
+    } else if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create PM lock: %s", esp_err_to_name(ret));
+        free(power);
+        return ret;
+    }
+    
+    instance->power = power;
+    
+    // Wake from light sleep on RX edges, through the RX GPIO if this UART cannot
+    uart_set_wakeup_threshold(instance->uart_port, power->config.wakeup_threshold);
+    if (esp_sleep_enable_uart_wakeup(instance->uart_port) == ESP_OK) {
+        power_set_wakeup(instance, true);
+    } else {
+        power->gpio_wakeup = true;
+        power_set_wakeup(instance, true);
+        esp_sleep_enable_gpio_wakeup();
+        ESP_LOGI(TAG, "UART%d cannot wake the chip, using GPIO%d", (int)instance->uart_port,
+                 instance->rx_pin);
+    }
+    
+    // Start streaming, with the lock held
+    int64_t now = esp_timer_get_time();
+    power->last_rx_us = now;
+    power->present_us = now;
+    power->since_us = now;
+    power->stats.state = LD2450_POWER_IDLE;
+    power_enter(instance, LD2450_POWER_STREAMING, now);
+    power->stats.wakeups = 0;
+    
+    return ESP_OK;
+}
+
+/**
+ * @brief Tear down low-power operation, releasing the PM lock
+ * 
+ * @param instance Driver instance, with its processing task stopped
+ */
+void ld2450_power_deinit(ld2450_state_t *instance)
+{
+    ld2450_power_t *power = instance->power;
+    
+    if (!power) {
+        return;
+    }
+    
+    power_set_wakeup(instance, false);
+    if (power->lock) {
+        if (power->locked) {
+            esp_pm_lock_release(power->lock);
+        }
+        esp_pm_lock_delete(power->lock);
+    }
+    instance->power = NULL;
+    free(power);
+}
+
+/**
+ * @brief Get the low-power state and time-in-sleep accounting
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param stats Pointer to store the accounting
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_STATE if low-power operation is not enabled
+ */
+esp_err_t ld2450_get_power_stats(ld2450_handle_t handle, ld2450_power_stats_t *stats)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized || !stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    ld2450_power_t *power = instance->power;
+    if (!power) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    // Include the interval still open in the current state
+    portENTER_CRITICAL(&power->stats_lock);
+    *stats = power->stats;
+    int64_t open_us = MAX(esp_timer_get_time() - power->since_us, 0);
+    bool locked = power->locked;
+    portEXIT_CRITICAL(&power->stats_lock);
+    
+    if (locked) {
+        stats->awake_us += (uint64_t)open_us;
+    } else {
+        stats->lock_released_us += (uint64_t)open_us;
+        if (stats->state == LD2450_POWER_DUTY_SLEEP) {
+            stats->duty_sleep_us += (uint64_t)open_us;
+        }
+    }
+    
+    return ESP_OK;
+}
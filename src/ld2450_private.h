@@ -15,6 +15,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdatomic.h>
 #include "esp_err.h"
 #include "ld2450.h"
 #include "freertos/FreeRTOS.h"
@@ -45,12 +46,191 @@ extern "C" {
 /** @brief Timeout for module restart in milliseconds */
 #define LD2450_RESTART_TIMEOUT_MS 3000
 
-/** @brief Size of the UART RX buffer */
+/** @brief Size of the processing task's UART read buffer */
 #define LD2450_UART_RX_BUF_SIZE 1024  // Increased from 512
 
-/** @brief Stack size for the processing task (replaces CONFIG_LD2450_TASK_STACK_SIZE) */
+/** @brief Bytes a command issued from a callback can read and hold for the frame scanner */
+#ifndef LD2450_NESTED_RX_BUF_SIZE
+#define LD2450_NESTED_RX_BUF_SIZE 512
+#endif
+
+/** @brief Reads held in the nested-command buffer that keep their own arrival time */
+#ifndef LD2450_NESTED_RX_READS
+#define LD2450_NESTED_RX_READS 8
+#endif
+
+/** @brief Default size of the UART driver RX ring buffer */
+#define LD2450_UART_RX_RING_SIZE (LD2450_UART_RX_BUF_SIZE * 2)
+
+/** @brief Default stack size for the processing task (replaces CONFIG_LD2450_TASK_STACK_SIZE) */
 #define LD2450_TASK_STACK_SIZE 4096
 
+/** @brief Default depth of the UART driver event queue, and the most a shared-task member may use */
+#define LD2450_UART_EVENT_QUEUE_SIZE 20
+
+/** @brief Time to listen for data frames at each rate during baud detection (ms) */
+#define LD2450_AUTOBAUD_LISTEN_MS 250
+
+/** @brief Interval at which baud detection checks for a frame while listening (ms) */
+#define LD2450_AUTOBAUD_POLL_MS 10
+
+/** @brief ACK timeout of the command probe at each rate during baud detection (ms) */
+#define LD2450_AUTOBAUD_CMD_TIMEOUT_MS 200
+
+/** @brief Cached firmware version is valid */
+#define LD2450_CACHE_FIRMWARE   (1U << 0)
+/** @brief Cached MAC address is valid */
+#define LD2450_CACHE_MAC        (1U << 1)
+/** @brief Cached tracking mode is valid */
+#define LD2450_CACHE_TRACKING   (1U << 2)
+/** @brief Cached Bluetooth state is valid */
+#define LD2450_CACHE_BLUETOOTH  (1U << 3)
+/** @brief Cached region filter is valid */
+#define LD2450_CACHE_REGION     (1U << 4)
+/** @brief Cached settings that a factory reset invalidates */
+#define LD2450_CACHE_SETTINGS   (LD2450_CACHE_TRACKING | LD2450_CACHE_BLUETOOTH | LD2450_CACHE_REGION)
+
+/** @brief Layout version of the NVS cache blob; bump when ld2450_cache_t changes */
+#define LD2450_CACHE_LAYOUT 1
+
+/** @brief Shortest frame interval used by the tracker's motion model (us) */
+#define LD2450_TRACKER_DT_MIN_US 10000
+
+/** @brief Longest frame interval used by the tracker's motion model (us) */
+#define LD2450_TRACKER_DT_MAX_US 1000000
+
+/** @brief Longest frame interval credited to zone dwell time (us) */
+#define LD2450_HEATMAP_DT_MAX_US 500000
+
+/** @brief Default longest wait of a frame in a partial batch (ms) */
+#define LD2450_BATCH_LATENCY_MS 500
+
+/** @brief Number of shared frame slots for QUEUE and NOTIFY subscribers */
+#ifndef LD2450_FRAME_POOL_SIZE
+#define LD2450_FRAME_POOL_SIZE 8
+#endif
+
+/** @brief Depth of the asynchronous command queue */
+#define LD2450_CMD_QUEUE_SIZE 8
+
+/** @brief Extra time a synchronous caller waits beyond the ACK timeout (ms) */
+#define LD2450_CMD_SYNC_MARGIN_MS 100
+
+/**
+ * @brief Driver-private UART event type used to wake the processing task
+ * 
+ * Posted to the UART event queue so a task blocked in xQueueReceive() re-evaluates
+ * the driver state (config mode, shutdown) without waiting for radar data.
+ */
+#define LD2450_UART_EVENT_WAKE ((uart_event_type_t)(UART_EVENT_MAX + 1))
+
+/** @brief Chunks fed per processing task wake-up by a max-speed replay */
+#ifndef LD2450_REPLAY_BATCH
+#define LD2450_REPLAY_BATCH 32
+#endif
+
+/** @brief Gap inserted into the replay timeline each time a looping replay starts over (us) */
+#define LD2450_REPLAY_LOOP_GAP_US 100000
+
+/**
+ * @brief Build the UHCI/GDMA receive backend behind ld2450_config_t::uart_rx_dma
+ * 
+ * Needs a chip with UHCI (SOC_UHCI_SUPPORTED) and an ESP-IDF that ships driver/uhci.h.
+ */
+#ifndef LD2450_ENABLE_UHCI
+#define LD2450_ENABLE_UHCI 0
+#endif
+
+/** @brief Size of each of the two UHCI receive buffers */
+#ifndef LD2450_UHCI_BUF_SIZE
+#define LD2450_UHCI_BUF_SIZE 1024
+#endif
+
+/** @brief Received DMA chunks the ISR can queue ahead of the processing task */
+#define LD2450_UHCI_CHUNK_QUEUE 8
+
+/**
+ * @brief Driver-private UART event type posted when the UHCI backend has received data
+ */
+#define LD2450_UART_EVENT_DMA ((uart_event_type_t)(UART_EVENT_MAX + 2))
+
+/** @brief Default time without UART data before the PM lock is released (ms) */
+#define LD2450_POWER_IDLE_TIMEOUT_MS 200
+
+/** @brief Default RX edge count that wakes the chip from light sleep */
+#define LD2450_POWER_WAKEUP_THRESHOLD 3
+
+/** @brief Default duty cycle period of an absent radar (ms) */
+#define LD2450_POWER_ABSENT_PERIOD_MS 1000
+
+/** @brief Listen window per duty cycle period, about three frames (ms) */
+#define LD2450_POWER_LISTEN_MS 300
+
+/** @brief Frame intervals without a frame that make a stall */
+#define LD2450_HEALTH_MISSED_FRAMES 10
+
+/** @brief Shortest default stall timeout (ms) */
+#define LD2450_HEALTH_MIN_TIMEOUT_MS 500
+
+/** @brief Default stall timeout before the frame interval is known (ms) */
+#define LD2450_HEALTH_TIMEOUT_MS 1000
+
+/** @brief Default pause before recovery starts over (ms) */
+#define LD2450_HEALTH_RETRY_MS 10000
+
+/** @brief Maximum number of driver instances serviced by the shared processing task */
+#define LD2450_MAX_INSTANCES 3
+
+/**
+ * @brief Maintain the counters and timing histograms behind ld2450_get_stats()
+ * 
+ * Costs two esp_timer reads per frame; define as 0 to compile the instrumentation out.
+ */
+#ifndef LD2450_ENABLE_STATS
+#define LD2450_ENABLE_STATS 1
+#endif
+
+#if LD2450_ENABLE_STATS
+/** @brief Count a statistics event on an instance */
+#define LD2450_STATS_INC(instance, field) do { \
+        portENTER_CRITICAL(&(instance)->stats_lock); \
+        (instance)->stats.field++; \
+        portEXIT_CRITICAL(&(instance)->stats_lock); \
+    } while (0)
+#else
+#define LD2450_STATS_INC(instance, field) ((void)0)
+#endif
+
+/** @brief Add to a frame synchronization counter of an instance */
+#define LD2450_SYNC_ADD(instance, field, n) do { \
+        portENTER_CRITICAL(&(instance)->stats_lock); \
+        (instance)->sync_stats.field += (n); \
+        portEXIT_CRITICAL(&(instance)->stats_lock); \
+    } while (0)
+
+/**
+ * @brief Record hot-path events in a binary trace instead of logging them
+ * 
+ * Costs one esp_timer read and a 12-byte store per event; define as 0 to compile
+ * the trace out.
+ */
+#ifndef LD2450_ENABLE_TRACE
+#define LD2450_ENABLE_TRACE 1
+#endif
+
+/** @brief Records kept by the trace ring (power of two) */
+#ifndef LD2450_TRACE_DEPTH
+#define LD2450_TRACE_DEPTH 64
+#endif
+
+#if LD2450_ENABLE_TRACE
+/** @brief Record a trace event on an instance */
+#define LD2450_TRACE(instance, event, arg8, arg16, arg32) \
+    ld2450_trace_record((instance), (event), (arg8), (arg16), (arg32))
+#else
+#define LD2450_TRACE(instance, event, arg8, arg16, arg32) ((void)0)
+#endif
+
 /** @brief Error debug data buffer size */
 #define LD2450_ERROR_BUFFER_SIZE 256
 
@@ -59,6 +239,11 @@ extern "C" {
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 #endif
 
+/** @brief MAX macro for getting maximum of two values */
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
 /**
  * @brief Frame headers and footers
  */
@@ -112,9 +297,252 @@ typedef enum {
 } ld2450_cmd_t;
 
 /**
- * @brief Driver state structure
+ * @brief Running timing distribution (reported as ld2450_latency_stats_t)
+ */
+typedef struct {
+    uint32_t samples;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t total_us;
+    uint32_t histogram[LD2450_STATS_HISTOGRAM_BINS];
+} ld2450_timing_acc_t;
+
+/**
+ * @brief Driver statistics accumulated by the processing task
+ */
+typedef struct {
+    uint32_t frames_delivered;
+    uint32_t frames_suppressed;
+    uint32_t batches_delivered;
+    uint32_t uart_fifo_overflows;
+    uint32_t uart_buffer_full;
+    uint32_t uart_queue_peak;
+    uint32_t subscriber_drops;
+    uint32_t events_dropped;
+    uint32_t capture_drops;
+    int64_t since_us;
+    ld2450_timing_acc_t latency;
+    ld2450_timing_acc_t callback_time;
+} ld2450_stats_acc_t;
+
+/**
+ * @brief Region filter as held in the cache
+ */
+typedef struct {
+    uint16_t type;
+    ld2450_region_t regions[3];
+} ld2450_cache_region_t;
+
+/**
+ * @brief Module identity and last-applied settings, persisted in NVS
+ */
+typedef struct {
+    uint8_t layout;
+    uint8_t valid;
+    uint8_t tracking_mode;
+    uint8_t bluetooth;
+    ld2450_firmware_version_t firmware;
+    uint8_t mac[6];
+    ld2450_cache_region_t region;
+} ld2450_cache_t;
+
+/**
+ * @brief Non-horizontal polygon edge prepared for crossing tests
+ * 
+ * Endpoints are ordered so that dy > 0; the edge covers y0 <= y < y1.
+ */
+typedef struct {
+    int16_t x0;
+    int16_t y0;
+    int16_t y1;
+    int16_t dx;
+    int16_t dy;
+} ld2450_zone_edge_t;
+
+/**
+ * @brief Software zone compiled into a bounding box and edge table
+ */
+typedef struct {
+    int16_t min_x;
+    int16_t min_y;
+    int16_t max_x;
+    int16_t max_y;
+    uint8_t edge_count;
+    ld2450_zone_edge_t edges[LD2450_ZONE_MAX_VERTICES];
+} ld2450_zone_shape_t;
+
+/**
+ * @brief Set of compiled zones
+ */
+typedef struct {
+    uint16_t active;
+    ld2450_zone_shape_t shapes[LD2450_ZONE_MAX];
+} ld2450_zone_table_t;
+
+/**
+ * @brief Software zone engine, allocated by the first ld2450_set_zone()
+ */
+typedef struct {
+    /** @brief Zones evaluated by the processing task */
+    ld2450_zone_table_t table;
+    /** @brief Zones written by ld2450_set_zone(), adopted by the next frame */
+    ld2450_zone_table_t pending;
+    /** @brief pending differs from table; guarded by lock */
+    bool dirty;
+    /** @brief Guards pending and dirty */
+    portMUX_TYPE lock;
+    /** @brief Zones each target slot was in after the last frame */
+    uint16_t target_zones[3];
+    /** @brief Targets per zone after the last frame */
+    uint8_t occupancy[LD2450_ZONE_MAX];
+    /** @brief Enter/exit event callback */
+    ld2450_zone_cb_t callback;
+    /** @brief User context for callback */
+    void *user_ctx;
+} ld2450_zone_engine_t;
+
+/**
+ * @brief Alpha-beta filter state of one track
+ */
+typedef struct {
+    bool active;
+    uint8_t slot;
+    uint8_t missed;
+    uint16_t id;
+    uint16_t hits;
+    /** @brief Position in 1/16 mm */
+    int32_t x;
+    int32_t y;
+    /** @brief Velocity in mm/s */
+    int32_t vx;
+    int32_t vy;
+    int64_t first_seen_us;
+} ld2450_track_state_t;
+
+/**
+ * @brief Multi-frame target tracker
+ */
+typedef struct {
+    /** @brief Configuration with defaults resolved */
+    ld2450_tracker_config_t config;
+    /** @brief Configuration written by ld2450_set_tracker_config(), adopted by the next frame */
+    ld2450_tracker_config_t pending;
+    /** @brief pending differs from config; guarded by lock */
+    bool dirty;
+    /** @brief Guards pending, dirty and published */
+    portMUX_TYPE lock;
+    /** @brief Track table, owned by the processing task */
+    ld2450_track_state_t tracks[LD2450_TRACK_MAX];
+    /** @brief ID of the next new track */
+    uint16_t next_id;
+    /** @brief Timestamp of the previous frame (0 = none) */
+    int64_t last_us;
+    /** @brief Output of the most recent frame */
+    ld2450_track_set_t published;
+    /** @brief Track callback */
+    ld2450_track_cb_t callback;
+    /** @brief User context for callback */
+    void *user_ctx;
+} ld2450_tracker_t;
+
+/**
+ * @brief Reference-counted frame slot shared by subscribers
+ */
+typedef struct {
+    /** @brief Frame; first member, so subscribers' frame pointers map back to the slot */
+    ld2450_frame_t frame;
+    /** @brief Outstanding references; only the processing task takes a free slot */
+    atomic_uint refs;
+} ld2450_frame_ref_t;
+
+/**
+ * @brief Subscriber table entry
+ */
+typedef struct {
+    /** @brief Entry is owned by a subscriber or still being torn down; guarded by the instance mutex */
+    bool reserved;
+    /** @brief Processing task may deliver to this entry; written under the instance mutex */
+    atomic_bool active;
+    ld2450_subscriber_config_t config;
+    /** @brief Latest undelivered frame of a NOTIFY subscriber */
+    _Atomic(ld2450_frame_ref_t *) latest;
+} ld2450_subscriber_t;
+
+/** @brief UHCI receive backend state (defined in ld2450_uhci.c) */
+typedef struct ld2450_uhci ld2450_uhci_t;
+
+/** @brief Low-power state (defined in ld2450_power.c) */
+typedef struct ld2450_power ld2450_power_t;
+
+/** @brief Occupancy heatmap (defined in ld2450_heatmap.c) */
+typedef struct ld2450_heatmap ld2450_heatmap_t;
+
+/** @brief Batched delivery state (defined in ld2450_batch.c) */
+typedef struct ld2450_batch ld2450_batch_t;
+
+/** @brief Stream health watchdog state (defined in ld2450_health.c) */
+typedef struct ld2450_health ld2450_health_t;
+
+/** @brief Capture record length marking the rest of the ring as unused */
+#define LD2450_CAPTURE_WRAP 0xFFFF
+
+/**
+ * @brief Raw capture ring
+ * 
+ * Single producer (the processing task) and single consumer (ld2450_capture_read()).
+ * Records never straddle the end of the ring: the producer leaves a wrap marker
+ * (a header with length LD2450_CAPTURE_WRAP), or no header at all if fewer bytes
+ * than a header remain, and continues at offset 0.
  */
 typedef struct {
+    /** @brief Ring storage */
+    uint8_t *buffer;
+    /** @brief Ring size in bytes */
+    size_t size;
+    /** @brief buffer was allocated by the driver */
+    bool owned;
+    /** @brief The processing task records UART chunks */
+    atomic_bool recording;
+    /** @brief Offset of the next record (producer) */
+    atomic_size_t write;
+    /** @brief Offset of the oldest unread record (consumer) */
+    atomic_size_t read;
+    /** @brief Offset of the record reserved by ld2450_capture_reserve() */
+    size_t reserved;
+} ld2450_capture_t;
+
+/**
+ * @brief Replay of a capture, owned by the processing task
+ */
+typedef struct {
+    /** @brief Capture being fed (data NULL when idle) */
+    ld2450_replay_config_t config;
+    /** @brief Offset of the next record */
+    size_t pos;
+    /** @brief Recorded timestamp of the first record */
+    int64_t first_us;
+    /** @brief Local time the first record maps to */
+    int64_t base_us;
+} ld2450_replay_t;
+
+/**
+ * @brief Command queued to the processing task
+ */
+typedef struct {
+    /** @brief Command as submitted */
+    ld2450_command_t command;
+    /** @brief Enter configuration mode first if the module is not already in it */
+    bool auto_config;
+    /** @brief Complete to the ld2450_send_command() caller blocked on cmd_done */
+    bool sync;
+    /** @brief Tag of the synchronous caller, echoed in cmd_sync_done_seq on completion */
+    uint32_t sync_seq;
+} ld2450_cmd_request_t;
+
+/**
+ * @brief Driver state structure (one per radar, referenced by ld2450_handle_t)
+ */
+struct ld2450_state {
     /** @brief UART port number being used */
     uart_port_t uart_port;
     /** @brief RX pin number */
@@ -127,18 +555,82 @@ typedef struct {
     bool initialized;
     /** @brief Auto-processing enabled flag */
     bool auto_processing;
+    /** @brief How the parser fills derived target fields */
+    ld2450_derived_mode_t derived_mode;
+    /** @brief Serviced by the shared processing task instead of a private one */
+    bool shared_task;
     /** @brief Target data callback function */
     ld2450_target_cb_t target_callback;
     /** @brief User context for callback */
     void *user_ctx;
     /** @brief Processing task handle */
     TaskHandle_t task_handle;
+    /** @brief Given by the private processing task as it exits */
+    SemaphoreHandle_t task_exited;
     /** @brief UART event queue */
     QueueHandle_t uart_queue;
     /** @brief Mutex for thread safety */
     SemaphoreHandle_t mutex;
     /** @brief Protocol state */
     volatile bool in_config_mode;
+    /** @brief A ld2450_config_begin() session is open */
+    bool config_session;
+    /** @brief First error reported by an operation inside the open session */
+    esp_err_t config_session_err;
+    /** @brief Commands waiting for the processing task */
+    QueueHandle_t cmd_queue;
+    /** @brief Request being executed by the processing task */
+    ld2450_cmd_request_t cmd_active;
+    /** @brief cmd_active holds a request that has not completed yet */
+    bool cmd_pending;
+    /** @brief A command frame is on the wire and its ACK has not arrived */
+    bool cmd_waiting;
+    /** @brief Command word on the wire (the active request or an implicit enable/end) */
+    uint16_t cmd_wire;
+    /** @brief Outcome of the last command taken off the wire */
+    esp_err_t cmd_wire_result;
+    /** @brief Length of that command's ACK (left in ack_rx) */
+    size_t cmd_wire_ack_len;
+    /** @brief ACK deadline of the command on the wire */
+    int64_t cmd_deadline_us;
+    /** @brief No command may be sent before this time (module restarting) */
+    int64_t cmd_hold_until_us;
+    /** @brief The active request restarted the module and completes when the hold expires */
+    bool cmd_restarting;
+    /** @brief Configuration mode was entered implicitly for queued commands */
+    bool cmd_auto_opened;
+    /** @brief Given when a synchronous request completes */
+    SemaphoreHandle_t cmd_done;
+    /** @brief Storage of cmd_queue, cmd_done, mutex and task_exited, so they need no heap */
+    StaticQueue_t cmd_queue_buffer;
+    uint8_t cmd_queue_storage[LD2450_CMD_QUEUE_SIZE * sizeof(ld2450_cmd_request_t)];
+    StaticSemaphore_t cmd_done_buffer;
+    StaticSemaphore_t mutex_buffer;
+    StaticSemaphore_t task_exited_buffer;
+    /** @brief Result of the last synchronous request */
+    esp_err_t cmd_sync_result;
+    /** @brief ACK length of the last synchronous request (ACK copied to ack_buffer) */
+    size_t cmd_sync_ack_len;
+    /** @brief Tag given to the last synchronous request (guarded by mutex) */
+    uint32_t cmd_sync_seq;
+    /** @brief Tag of the synchronous request cmd_sync_result belongs to */
+    uint32_t cmd_sync_done_seq;
+    /** @brief ACK frame being assembled by the receive path */
+    uint8_t ack_rx[LD2450_ACK_BUFFER_SIZE];
+    /** @brief Bytes of ack_rx filled so far */
+    uint16_t ack_idx;
+    /** @brief UART read buffer used by the private processing task */
+    uint8_t rx_buffer[LD2450_UART_RX_BUF_SIZE];
+    /** @brief Bytes read by a command issued from a callback, for the frame scanner to take next */
+    uint8_t rx_deferred[LD2450_NESTED_RX_BUF_SIZE];
+    /** @brief Bytes of rx_deferred filled */
+    size_t rx_deferred_len;
+    /** @brief End offset in rx_deferred of each read held */
+    size_t rx_deferred_end[LD2450_NESTED_RX_READS];
+    /** @brief Time the last byte of each read held had arrived */
+    int64_t rx_deferred_us[LD2450_NESTED_RX_READS];
+    /** @brief Reads held in rx_deferred */
+    uint8_t rx_deferred_reads;
     /** @brief Command buffer for sending commands */
     uint8_t cmd_buffer[LD2450_CMD_BUFFER_SIZE];
     /** @brief ACK buffer for receiving responses */
@@ -149,11 +641,145 @@ typedef struct {
     uint16_t frame_idx;
     /** @brief Frame synchronization state */
     bool frame_synced;
-    uint32_t idle_count;  // Counter for adaptive task delay
+    /** @brief Number of header bytes matched so far while hunting for sync */
+    uint8_t header_match;
+    /** @brief Current sync was found by rescanning bytes of a rejected frame */
+    bool resync_pending;
+    /** @brief Guards sync_stats and stats against ld2450_get_stats() and ld2450_get_sync_stats() */
+    portMUX_TYPE stats_lock;
+    /** @brief ld2450_reset_stats() was called; applied by the processing task */
+    atomic_bool stats_reset_pending;
+    /** @brief Frame synchronization counters */
+    ld2450_sync_stats_t sync_stats;
+#if LD2450_ENABLE_STATS
+    /** @brief Counters and timing histograms for ld2450_get_stats() */
+    ld2450_stats_acc_t stats;
+#endif
+#if LD2450_ENABLE_TRACE
+    /** @brief Trace ring, written by the processing task only */
+    ld2450_trace_record_t trace[LD2450_TRACE_DEPTH];
+    /** @brief Total records written */
+    atomic_uint_fast32_t trace_head;
+    /** @brief Records consumed by ld2450_trace_read() */
+    uint32_t trace_tail;
+    /** @brief Events traced per type */
+    uint32_t trace_counts[LD2450_TRACE_EVENT_MAX];
+    /** @brief trace_counts at the last ld2450_trace_log() summary */
+    uint32_t trace_logged[LD2450_TRACE_EVENT_MAX];
+    /** @brief Time of the last ld2450_trace_log() summary */
+    int64_t trace_logged_us;
+#endif
+    /** @brief Wire time of one UART byte in nanoseconds (10 bits per byte) */
+    uint32_t byte_time_ns;
+    /** @brief esp_timer time the chunk being parsed was taken off the UART event queue */
+    int64_t chunk_timestamp_us;
+    /** @brief Estimated arrival time of the header of the frame being collected */
+    int64_t frame_timestamp_us;
+    /** @brief Sequence number assigned to the next delivered frame */
+    uint32_t frame_sequence;
+    /** @brief NVS cache is in use */
+    bool cache_enabled;
+    /** @brief Identity queries are waiting for the data stream to go live */
+    bool cache_refresh_pending;
+    /** @brief NVS namespace of the cache */
+    char cache_namespace[16];
+    /** @brief NVS key of this instance's cache blob */
+    char cache_key[16];
+    /** @brief Guards cache against the processing task's identity refresh */
+    portMUX_TYPE cache_lock;
+    /** @brief Cached identity and settings */
+    ld2450_cache_t cache;
+    /** @brief Software zone engine (NULL until the first zone is set) */
+    ld2450_zone_engine_t *zones;
+    /** @brief Target tracker */
+    ld2450_tracker_t tracker;
+    /** @brief Occupancy heatmap (NULL when disabled) */
+    ld2450_heatmap_t *heatmap;
+    /** @brief Batched frame delivery (NULL when disabled) */
+    ld2450_batch_t *batch;
+    /** @brief Frames are fed to the fusion stage */
+    volatile bool fusion_source;
+    /** @brief Frame subscribers */
+    ld2450_subscriber_t subscribers[LD2450_SUBSCRIBER_MAX];
+    /** @brief Number of active subscribers */
+    atomic_int subscriber_count;
+    /** @brief Processing task is dispatching to subscribers */
+    atomic_bool subscriber_dispatching;
+    /** @brief Shared frame slots (NULL until a QUEUE or NOTIFY subscriber is added) */
+    ld2450_frame_ref_t *frame_pool;
+    /** @brief Loop events are posted to (NULL = events disabled) */
+    esp_event_loop_handle_t event_loop;
+    /** @brief event_loop was created by the driver */
+    bool event_loop_owned;
+    /** @brief Frames referenced by LD2450_EVENT_FRAME */
+    ld2450_frame_t *event_frames;
+    /** @brief Next event_frames slot */
+    uint32_t event_frame_head;
+    /** @brief Last reported presence state */
+    bool event_present;
+    /** @brief A valid frame arrived since the last LD2450_EVENT_SYNC_LOST */
+    bool event_synced;
+    /** @brief Raw capture ring (NULL until ld2450_capture_start()) */
+    ld2450_capture_t *capture;
+    /** @brief Processing task is writing to the capture ring */
+    atomic_bool capture_busy;
+    /** @brief Replay being fed by the processing task */
+    ld2450_replay_t replay;
+    /** @brief Replay staged by ld2450_replay_start()/ld2450_replay_stop() */
+    ld2450_replay_config_t replay_pending;
+    /** @brief replay_pending has not been adopted yet */
+    volatile bool replay_dirty;
+    /** @brief Guards replay_pending */
+    portMUX_TYPE replay_lock;
+    /** @brief A replay is being fed (replay.config.data != NULL) */
+    volatile bool replay_running;
+    /** @brief UHCI/GDMA receive backend (NULL when bytes come from the UART driver) */
+    ld2450_uhci_t *uhci;
+    /** @brief Low-power state (NULL when disabled) */
+    ld2450_power_t *power;
+    /** @brief Stream health watchdog (NULL when disabled) */
+    ld2450_health_t *health;
+    /** @brief Frame delivery policy */
+    ld2450_delivery_policy_t delivery;
+    /** @brief Guards delivery against concurrent ld2450_set_delivery_policy() */
+    portMUX_TYPE delivery_lock;
+    /** @brief Frames received since the last one considered for delivery */
+    uint8_t delivery_skip;
+    /** @brief A reference frame has been delivered under the current policy */
+    bool delivery_primed;
+    /** @brief Timestamp of the last delivered frame */
+    int64_t delivery_last_us;
+    /** @brief Raw fields of the last delivered frame (change filter reference) */
+    ld2450_compact_frame_t delivery_last;
+    /** @brief Scratch frame the parser fills when no ring slot is available */
+    ld2450_frame_t frame;
+    /** @brief Parsed-frame ring slots (NULL when the pull API is disabled) */
+    void *ring;
+    /** @brief Number of ring slots */
+    uint32_t ring_depth;
+    /** @brief Ring slots hold ld2450_compact_frame_t instead of ld2450_frame_t */
+    bool ring_compact;
+    /** @brief Base time of the compact ring's timestamp chain */
+    int64_t ring_epoch_us;
+    /** @brief Timestamp of the last frame published to the compact ring */
+    int64_t ring_last_timestamp_us;
+    /** @brief Total frames published (written by the driver task only) */
+    atomic_uint_fast32_t ring_head;
+    /** @brief Total frames released (written by the consumer only) */
+    atomic_uint_fast32_t ring_tail;
+    /** @brief Counts published frames not yet acquired */
+    SemaphoreHandle_t ring_sem;
+    /** @brief A frame is currently claimed by the consumer */
+    bool ring_claimed;
+    /** @brief Frames dropped because the ring was full */
+    uint32_t ring_overruns;
     /** @brief Error debug data */
     uint8_t error_buffer[LD2450_ERROR_BUFFER_SIZE];
     size_t error_buffer_len;
-} ld2450_state_t;
+};
+
+/** @brief Driver state type */
+typedef struct ld2450_state ld2450_state_t;
 
 /**
  * @brief Configuration functions
@@ -162,20 +788,23 @@ typedef struct {
 /**
  * @brief Enter configuration mode
  * 
+ * @param instance Driver instance
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
-esp_err_t ld2450_enter_config_mode(void);
+esp_err_t ld2450_enter_config_mode(ld2450_state_t *instance);
 
 /**
  * @brief Exit configuration mode
  * 
+ * @param instance Driver instance
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
-esp_err_t ld2450_exit_config_mode(void);
+esp_err_t ld2450_exit_config_mode(ld2450_state_t *instance);
 
 /**
  * @brief Send a command to the LD2450 radar
  * 
+ * @param instance Driver instance
  * @param cmd Command word
  * @param value Command value buffer
  * @param value_len Length of the command value
@@ -184,7 +813,8 @@ esp_err_t ld2450_exit_config_mode(void);
  * @param timeout_ms Timeout in milliseconds
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
-esp_err_t ld2450_send_command(ld2450_cmd_t cmd, const void *value, size_t value_len, 
+esp_err_t ld2450_send_command(ld2450_state_t *instance, ld2450_cmd_t cmd,
+                             const void *value, size_t value_len,
                              uint8_t *ack_buffer, size_t *ack_len, uint32_t timeout_ms);
 
 /**
@@ -192,41 +822,706 @@ esp_err_t ld2450_send_command(ld2450_cmd_t cmd, const void *value, size_t value_
  * 
  * @param data Raw frame data
  * @param len Length of the data
+ * @param mode How derived distance/angle fields are computed
  * @param frame Frame structure to fill
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
-esp_err_t ld2450_parse_frame(const uint8_t *data, size_t len, ld2450_frame_t *frame);
+esp_err_t ld2450_parse_frame(const uint8_t *data, size_t len, ld2450_derived_mode_t mode,
+                             ld2450_frame_t *frame);
+
+/**
+ * @brief Integer square root
+ * 
+ * @param value Input value
+ * @return floor(sqrt(value))
+ */
+uint32_t ld2450_isqrt32(uint32_t value);
+
+/**
+ * @brief Table-based atan2 in hundredths of a degree (error < 0.01 degrees)
+ * 
+ * @param y Y component
+ * @param x X component
+ * @return atan2(y, x) in the range -18000..18000
+ */
+int32_t ld2450_atan2_cdeg(int32_t y, int32_t x);
+
+/**
+ * @brief Fill a target's distance and angle according to a derived-field mode
+ * 
+ * @param target Target with x/y populated
+ * @param mode Derived-field mode
+ */
+void ld2450_compute_derived(ld2450_target_t *target, ld2450_derived_mode_t mode);
 
 /**
  * @brief Task for processing radar data
  * 
- * @param arg Task argument (not used)
+ * @param arg Driver instance serviced by this task
  */
 void ld2450_processing_task(void *arg);
 
 /**
  * @brief UART event handler
  * 
+ * @param instance Driver instance the data was received on
  * @param data_buffer Buffer containing UART data
  * @param len Length of data in the buffer
  */
-void ld2450_uart_event_handler(uint8_t *data_buffer, size_t len);
+void ld2450_uart_event_handler(ld2450_state_t *instance, const uint8_t *data_buffer, size_t len);
+
+/**
+ * @brief Set up event posting for an instance
+ * 
+ * @param instance Driver instance
+ * @param config Event configuration
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_event_init(ld2450_state_t *instance, const ld2450_event_config_t *config);
+
+/**
+ * @brief Stop event posting and delete the driver-owned loop
+ * 
+ * @param instance Driver instance
+ */
+void ld2450_event_deinit(ld2450_state_t *instance);
+
+/**
+ * @brief Post an event without blocking
+ * 
+ * @param instance Driver instance with events enabled
+ * @param id Event ID
+ * @param data Event data (copied by the loop)
+ * @param size Size of the event data
+ */
+void ld2450_event_post(ld2450_state_t *instance, ld2450_event_id_t id, const void *data, size_t size);
+
+/**
+ * @brief Post LD2450_EVENT_PRESENCE_CHANGED on presence edges
+ * 
+ * Called for every parsed frame, before the delivery policy.
+ * 
+ * @param instance Driver instance with events enabled
+ * @param frame Parsed frame
+ */
+void ld2450_event_presence(ld2450_state_t *instance, const ld2450_frame_t *frame);
+
+/**
+ * @brief Post LD2450_EVENT_FRAME for a delivered frame
+ * 
+ * @param instance Driver instance with events enabled
+ * @param frame Delivered frame
+ */
+void ld2450_event_frame(ld2450_state_t *instance, const ld2450_frame_t *frame);
+
+/**
+ * @brief Post LD2450_EVENT_SYNC_LOST unless a loss was already reported
+ * 
+ * @param instance Driver instance with events enabled
+ * @param reason Cause
+ */
+void ld2450_event_sync_lost(ld2450_state_t *instance, ld2450_sync_lost_reason_t reason);
+
+/**
+ * @brief Hand a delivered frame to the subscribers
+ * 
+ * @param instance Driver instance
+ * @param frame Delivered frame
+ */
+void ld2450_subscriber_dispatch(ld2450_state_t *instance, const ld2450_frame_t *frame);
+
+/**
+ * @brief Drop all subscribers and free the frame pool
+ * 
+ * @param instance Driver instance, with its processing task stopped
+ */
+void ld2450_subscriber_deinit(ld2450_state_t *instance);
+
+/**
+ * @brief Reserve room for a UART chunk in the capture ring
+ * 
+ * @param instance Driver instance
+ * @param len Largest chunk that will be committed
+ * @return Where to read the chunk to, NULL if not recording or the ring is full
+ */
+uint8_t *ld2450_capture_reserve(ld2450_state_t *instance, size_t len);
+
+/**
+ * @brief Publish the chunk read into the reserved space
+ * 
+ * @param instance Driver instance
+ * @param timestamp_us Time the chunk was taken off the UART
+ * @param len Chunk length (at most the reserved length)
+ */
+void ld2450_capture_commit(ld2450_state_t *instance, int64_t timestamp_us, size_t len);
+
+/**
+ * @brief Release the capture ring
+ * 
+ * @param instance Driver instance, with its processing task stopped
+ */
+void ld2450_capture_deinit(ld2450_state_t *instance);
+
+/**
+ * @brief Feed due replay chunks into the receive path
+ * 
+ * @param instance Driver instance
+ */
+void ld2450_replay_poll(ld2450_state_t *instance);
+
+/**
+ * @brief Time until the next replay chunk is due
+ * 
+ * @param instance Driver instance
+ * @return Ticks to wait (portMAX_DELAY if no replay runs)
+ */
+TickType_t ld2450_replay_wait_ticks(ld2450_state_t *instance);
+
+/**
+ * @brief Source-independent receive path: scan a chunk for data frames
+ * 
+ * Bytes from the UART and from a replay both enter the parser here.
+ * 
+ * @param instance Driver instance
+ * @param data Received bytes
+ * @param len Number of bytes
+ * @param timestamp_us Time the chunk's last byte had arrived
+ */
+void ld2450_rx_feed(ld2450_state_t *instance, const uint8_t *data, size_t len, int64_t timestamp_us);
+
+/**
+ * @brief Append an event to the trace ring (use LD2450_TRACE())
+ * 
+ * @param instance Driver instance
+ * @param event Event
+ * @param arg8 Event-specific argument
+ * @param arg16 Event-specific argument
+ * @param arg32 Event-specific argument
+ */
+void ld2450_trace_record(ld2450_state_t *instance, ld2450_trace_event_t event, uint8_t arg8,
+                         uint16_t arg16, uint32_t arg32);
+
+/**
+ * @brief Switch an instance's reception to the UHCI/GDMA backend
+ * 
+ * @param instance Driver instance, with the UART driver installed and configured
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_SUPPORTED if built without
+ *         LD2450_ENABLE_UHCI, error code otherwise
+ */
+esp_err_t ld2450_uhci_init(ld2450_state_t *instance);
+
+/**
+ * @brief Stop the UHCI backend and release its buffers
+ * 
+ * @param instance Driver instance, with its processing task stopped
+ */
+void ld2450_uhci_deinit(ld2450_state_t *instance);
+
+/**
+ * @brief Parse the chunks the UHCI backend has received so far
+ * 
+ * @param instance Driver instance
+ * @param ack_only Only scan for command ACKs (nested call from the processing task)
+ */
+void ld2450_uhci_service(ld2450_state_t *instance, bool ack_only);
+
+/**
+ * @brief Set up low-power operation
+ * 
+ * @param instance Driver instance, with the UART configured
+ * @param config Low-power configuration
+ * @return esp_err_t ESP_OK on success (or if not enabled), error code otherwise
+ */
+esp_err_t ld2450_power_init(ld2450_state_t *instance, const ld2450_power_config_t *config);
 
 /**
- * @brief Get driver instance (singleton)
+ * @brief Tear down low-power operation, releasing the PM lock
  * 
- * @return Pointer to driver state structure
+ * @param instance Driver instance, with its processing task stopped
+ */
+void ld2450_power_deinit(ld2450_state_t *instance);
+
+/**
+ * @brief Note UART activity
+ * 
+ * @param instance Driver instance
+ * @return true if the bytes should be scanned for frames, false while duty-cycled
+ */
+bool ld2450_power_rx(ld2450_state_t *instance);
+
+/**
+ * @brief Feed a parsed frame's target count to the presence gate
+ * 
+ * @param instance Driver instance
+ * @param frame Parsed frame
+ */
+void ld2450_power_frame(ld2450_state_t *instance, const ld2450_frame_t *frame);
+
+/**
+ * @brief Run the low-power timers
+ * 
+ * @param instance Driver instance
+ */
+void ld2450_power_poll(ld2450_state_t *instance);
+
+/**
+ * @brief Time until the next low-power timer expires
+ * 
+ * @param instance Driver instance
+ * @return Ticks to wait (portMAX_DELAY if none is running)
+ */
+TickType_t ld2450_power_wait_ticks(ld2450_state_t *instance);
+
+/**
+ * @brief Duty cycle period while the radar is duty-cycled
+ * 
+ * @param instance Driver instance
+ * @return Period in microseconds, 0 when frames are not being skipped
+ */
+int64_t ld2450_power_duty_period_us(ld2450_state_t *instance);
+
+/**
+ * @brief Set up the stream health watchdog
+ * 
+ * @param instance Driver instance
+ * @param config Watchdog configuration
+ * @return esp_err_t ESP_OK on success (or if not enabled), error code otherwise
+ */
+esp_err_t ld2450_health_init(ld2450_state_t *instance, const ld2450_health_config_t *config);
+
+/**
+ * @brief Release the stream health watchdog
+ * 
+ * @param instance Driver instance, with its processing task stopped
+ */
+void ld2450_health_deinit(ld2450_state_t *instance);
+
+/**
+ * @brief Note a parsed frame, ending a stall in progress
+ * 
+ * @param instance Driver instance
+ * @param frame Parsed frame
+ */
+void ld2450_health_frame(ld2450_state_t *instance, const ld2450_frame_t *frame);
+
+/**
+ * @brief Detect stalls and advance the recovery steps
+ * 
+ * @param instance Driver instance
+ */
+void ld2450_health_poll(ld2450_state_t *instance);
+
+/**
+ * @brief Time until the watchdog's next deadline
+ * 
+ * @param instance Driver instance
+ * @return Ticks to wait (portMAX_DELAY if the watchdog is not enabled)
+ */
+TickType_t ld2450_health_wait_ticks(ld2450_state_t *instance);
+
+/**
+ * @brief Set up the tracker of an instance
+ * 
+ * @param instance Driver instance
+ * @param config Initial tracker configuration
+ */
+void ld2450_tracker_init(ld2450_state_t *instance, const ld2450_tracker_config_t *config);
+
+/**
+ * @brief Run the tracker on a parsed frame
+ * 
+ * @param instance Driver instance
+ * @param frame Parsed and timestamped frame
+ */
+void ld2450_tracker_update(ld2450_state_t *instance, const ld2450_frame_t *frame);
+
+/**
+ * @brief Allocate the batch buffer
+ * 
+ * @param instance Driver instance
+ * @param config Batch configuration
+ * @return esp_err_t ESP_OK on success (or if not enabled), error code otherwise
+ */
+esp_err_t ld2450_batch_init(ld2450_state_t *instance, const ld2450_batch_config_t *config);
+
+/**
+ * @brief Release the batch buffer, discarding frames not delivered yet
+ * 
+ * @param instance Driver instance
+ */
+void ld2450_batch_deinit(ld2450_state_t *instance);
+
+/**
+ * @brief Add a delivered frame to the batch, delivering the batch once full
+ * 
+ * @param instance Driver instance
+ * @param frame Frame that passed the delivery policy
+ */
+void ld2450_batch_frame(ld2450_state_t *instance, const ld2450_frame_t *frame);
+
+/**
+ * @brief Deliver a partial batch whose oldest frame has waited max_latency_ms
+ * 
+ * @param instance Driver instance
+ */
+void ld2450_batch_poll(ld2450_state_t *instance);
+
+/**
+ * @brief Ticks until a partial batch is due
+ * 
+ * @param instance Driver instance
+ * @return Ticks to wait (portMAX_DELAY if batching is not enabled or the batch is empty)
+ */
+TickType_t ld2450_batch_wait_ticks(ld2450_state_t *instance);
+
+/**
+ * @brief Allocate the occupancy heatmap
+ * 
+ * @param instance Driver instance
+ * @param config Heatmap configuration
+ * @return esp_err_t ESP_OK on success (or if not enabled), error code otherwise
+ */
+esp_err_t ld2450_heatmap_init(ld2450_state_t *instance, const ld2450_heatmap_config_t *config);
+
+/**
+ * @brief Release the occupancy heatmap
+ * 
+ * @param instance Driver instance
+ */
+void ld2450_heatmap_deinit(ld2450_state_t *instance);
+
+/**
+ * @brief Count a parsed frame into the heatmap and zone dwell times
+ * 
+ * @param instance Driver instance
+ * @param frame Parsed frame, after zone evaluation
+ */
+void ld2450_heatmap_update(ld2450_state_t *instance, const ld2450_frame_t *frame);
+
+/**
+ * @brief Feed a parsed frame of a fusion source to the fusion stage
+ * 
+ * @param instance Driver instance
+ * @param frame Parsed and timestamped frame
+ */
+void ld2450_fusion_frame(ld2450_state_t *instance, const ld2450_frame_t *frame);
+
+/**
+ * @brief Evaluate the software zones for a parsed frame and raise enter/exit events
+ * 
+ * @param instance Driver instance
+ * @param frame Parsed frame
+ */
+void ld2450_zone_evaluate(ld2450_state_t *instance, const ld2450_frame_t *frame);
+
+/**
+ * @brief Load the NVS cache of an instance
+ * 
+ * @param instance Driver instance
+ * @param nvs_namespace NVS namespace (NULL disables the cache)
+ */
+void ld2450_cache_init(ld2450_state_t *instance, const char *nvs_namespace);
+
+/**
+ * @brief Check whether a cached value is available
+ * 
+ * @param instance Driver instance
+ * @param field LD2450_CACHE_* bit
+ * @return true if the cache is enabled and holds the field
+ */
+bool ld2450_cache_has(ld2450_state_t *instance, uint8_t field);
+
+/**
+ * @brief Store a value into the cache and persist it
+ * 
+ * @param instance Driver instance
+ * @param field LD2450_CACHE_* bit of the value
+ * @param value Value to copy into its ld2450_cache_t member
+ * @param len Size of the value
+ */
+void ld2450_cache_store(ld2450_state_t *instance, uint8_t field, const void *value, size_t len);
+
+/**
+ * @brief Compare a value with the cache
+ * 
+ * @param instance Driver instance
+ * @param field LD2450_CACHE_* bit of the value
+ * @param value Value to compare with its ld2450_cache_t member
+ * @param len Size of the value
+ * @return true if the cache holds the field and it equals value
+ */
+bool ld2450_cache_matches(ld2450_state_t *instance, uint8_t field, const void *value, size_t len);
+
+/**
+ * @brief Copy a cached value out
+ * 
+ * @param instance Driver instance
+ * @param field LD2450_CACHE_* bit of the value
+ * @param value Destination
+ * @param len Size of the value
+ * @return true if the cache held the field
+ */
+bool ld2450_cache_load(ld2450_state_t *instance, uint8_t field, void *value, size_t len);
+
+/**
+ * @brief Drop cached values and persist the change
+ * 
+ * @param instance Driver instance
+ * @param fields LD2450_CACHE_* bits to drop
+ */
+void ld2450_cache_invalidate(ld2450_state_t *instance, uint8_t fields);
+
+/**
+ * @brief Queue the deferred identity queries once the data stream is live
+ * 
+ * Called by the processing task for every delivered frame; does nothing unless a
+ * refresh is pending.
+ * 
+ * @param instance Driver instance
+ */
+void ld2450_cache_refresh_identity(ld2450_state_t *instance);
+
+/**
+ * @brief Decode a firmware version ACK
+ * 
+ * @param ack ACK frame
+ * @param len ACK frame length
+ * @param version Decoded version
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_RESPONSE if the ACK is too short
+ */
+esp_err_t ld2450_parse_firmware_ack(const uint8_t *ack, size_t len, ld2450_firmware_version_t *version);
+
+/**
+ * @brief Decode a MAC address ACK
+ * 
+ * @param ack ACK frame
+ * @param len ACK frame length
+ * @param mac Decoded MAC address
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_RESPONSE if the ACK is too short
+ */
+esp_err_t ld2450_parse_mac_ack(const uint8_t *ack, size_t len, uint8_t mac[6]);
+
+/**
+ * @brief Reconfigure the host UART of an instance to a new baud rate
+ * 
+ * @param instance Driver instance
+ * @param bps Bits per second
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_set_host_baud(ld2450_state_t *instance, uint32_t bps);
+
+/**
+ * @brief Build a command packet in the instance command buffer
+ * 
+ * @param instance Driver instance
+ * @param cmd Command word
+ * @param value Command value buffer
+ * @param value_len Length of the command value in bytes
+ * @return Size of the command packet
+ */
+size_t ld2450_build_command(ld2450_state_t *instance, uint16_t cmd, const void *value, size_t value_len);
+
+/**
+ * @brief Put a command frame on the wire and arm its ACK deadline
+ * 
+ * @param instance Driver instance
+ * @param cmd Command word
+ * @param value Command value buffer
+ * @param value_len Length of the command value in bytes
+ * @param timeout_ms ACK timeout in milliseconds
+ */
+void ld2450_command_send(ld2450_state_t *instance, uint16_t cmd, const void *value,
+                         size_t value_len, uint32_t timeout_ms);
+
+/**
+ * @brief Scan a block of received bytes for the ACK of the command on the wire
+ * 
+ * @param instance Driver instance
+ * @param data Bytes to scan
+ * @param len Number of bytes
+ */
+void ld2450_scan_ack(ld2450_state_t *instance, const uint8_t *data, size_t len);
+
+/**
+ * @brief Hold bytes read by a command issued from a callback for the frame scanner
+ * 
+ * The scanner is busy further up the processing task's stack, so the bytes are
+ * scanned once the block it is working on has been finished.
+ * 
+ * @param instance Driver instance
+ * @param data Received bytes
+ * @param len Number of bytes
+ */
+void ld2450_rx_defer(ld2450_state_t *instance, const uint8_t *data, size_t len);
+
+/**
+ * @brief Create the command engine resources of an instance
+ * 
+ * @param instance Driver instance
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_command_init(ld2450_state_t *instance);
+
+/**
+ * @brief Release the command engine resources of an instance
+ * 
+ * Requests still queued are discarded without completion.
+ * 
+ * @param instance Driver instance
+ */
+void ld2450_command_deinit(ld2450_state_t *instance);
+
+/**
+ * @brief Check whether commands for an instance go through its processing task
+ * 
+ * False without a processing task, or when called from that task itself, in which
+ * case ld2450_send_command() reads the UART directly.
+ * 
+ * @param instance Driver instance
+ * @return true if commands must be queued to the processing task
+ */
+bool ld2450_command_via_task(const ld2450_state_t *instance);
+
+/**
+ * @brief Queue a request and wake the processing task
+ * 
+ * @param instance Driver instance
+ * @param request Request to queue (copied)
+ * @return esp_err_t ESP_OK if queued, ESP_ERR_NO_MEM if the queue is full
+ */
+esp_err_t ld2450_command_enqueue(ld2450_state_t *instance, const ld2450_cmd_request_t *request);
+
+/**
+ * @brief Advance the command engine (processing task only)
+ * 
+ * Times out a command whose ACK is overdue and puts the next queued command on the wire.
+ * 
+ * @param instance Driver instance
+ */
+void ld2450_command_poll(ld2450_state_t *instance);
+
+/**
+ * @brief Time the processing task may block before the engine needs attention
+ * 
+ * @param instance Driver instance
+ * @return Ticks until the next engine deadline, portMAX_DELAY if none
+ */
+TickType_t ld2450_command_wait_ticks(const ld2450_state_t *instance);
+
+/**
+ * @brief Deliver a complete ACK frame from the receive path to the command engine
+ * 
+ * ACKs whose command echo does not match the command on the wire are ignored.
+ * 
+ * @param instance Driver instance
+ * @param ack ACK frame
+ * @param len ACK frame length
+ */
+void ld2450_command_ack(ld2450_state_t *instance, const uint8_t *ack, size_t len);
+
+/**
+ * @brief Get the default driver instance (created by ld2450_init)
+ * 
+ * @return Pointer to driver state structure, NULL if not initialized
  */
 ld2450_state_t *ld2450_get_instance(void);
 
+/**
+ * @brief Resolve a public handle to a driver instance
+ * 
+ * @param handle Driver handle, or NULL for the default instance
+ * @return Pointer to driver state structure, NULL if not available
+ */
+ld2450_state_t *ld2450_resolve_handle(ld2450_handle_t handle);
+
+/**
+ * @brief Create a module-wide mutex on first use, once even under concurrent callers
+ * 
+ * @param slot Where the mutex is published
+ * @return SemaphoreHandle_t The mutex, NULL if it could not be created
+ */
+SemaphoreHandle_t ld2450_mutex_once(SemaphoreHandle_t *slot);
+
 /**
  * @brief Handle a complete data frame
  * 
+ * @param instance Driver instance the frame was received on
  * @param data Frame data
  * @param len Frame length
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
-esp_err_t ld2450_handle_data_frame(const uint8_t *data, size_t len);
+esp_err_t ld2450_handle_data_frame(ld2450_state_t *instance, const uint8_t *data, size_t len);
+
+/**
+ * @brief Apply the delivery policy to a parsed frame
+ * 
+ * Updates the policy state as if the frame were delivered when it passes.
+ * 
+ * @param instance Driver instance
+ * @param frame Parsed and timestamped frame
+ * @return true if the frame should be delivered
+ */
+bool ld2450_delivery_filter(ld2450_state_t *instance, const ld2450_frame_t *frame);
+
+/**
+ * @brief Add a sample to a timing distribution
+ * 
+ * Call with the instance's stats_lock held.
+ * 
+ * @param acc Distribution to update
+ * @param us Sample in microseconds (clamped to 0..UINT32_MAX)
+ */
+void ld2450_stats_sample(ld2450_timing_acc_t *acc, int64_t us);
+
+/**
+ * @brief Apply a pending ld2450_reset_stats()
+ * 
+ * Called by the processing task after every wakeup.
+ * 
+ * @param instance Driver instance
+ */
+void ld2450_stats_poll(ld2450_state_t *instance);
+
+/**
+ * @brief Allocate the parsed-frame ring
+ * 
+ * @param instance Driver instance
+ * @param depth Number of slots (0 leaves the ring disabled)
+ * @param compact Store compact frames instead of full frames
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_ring_init(ld2450_state_t *instance, uint32_t depth, bool compact);
+
+/**
+ * @brief Release the parsed-frame ring
+ * 
+ * @param instance Driver instance
+ */
+void ld2450_ring_deinit(ld2450_state_t *instance);
+
+/**
+ * @brief Get the frame the parser should write into
+ * 
+ * Returns the next free ring slot, or the instance scratch frame when the ring
+ * is disabled, full (counting an overrun) or stores compact frames.
+ * 
+ * @param instance Driver instance
+ * @param in_ring Set to true if the returned frame is a ring slot
+ * @return Frame to parse into
+ */
+ld2450_frame_t *ld2450_ring_write_slot(ld2450_state_t *instance, bool *in_ring);
+
+/**
+ * @brief Publish a parsed frame to the consumer
+ * 
+ * Advances the ring when the frame was parsed into a slot, or converts it into
+ * the next slot of a compact ring.
+ * 
+ * @param instance Driver instance
+ * @param frame Frame returned by ld2450_ring_write_slot() and parsed successfully
+ * @param in_ring Value reported by ld2450_ring_write_slot()
+ */
+void ld2450_ring_publish(ld2450_state_t *instance, const ld2450_frame_t *frame, bool in_ring);
 
 /**
  * @brief Validate ACK response
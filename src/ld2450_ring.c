@@ -0,0 +1,280 @@
+/**
+ * @file ld2450_ring.c
+ * @brief Lock-free single-producer/single-consumer ring of parsed frames
+ * 
+ * The driver task parses frames directly into ring slots and a consumer task
+ * claims them with ld2450_frame_acquire()/ld2450_frame_release(), decoupling
+ * UART draining from application work without copying frames.
+ * 
+ * @author NieRVoid
+ * @date 2025-03-12
+ * @license MIT
+ */
+
+#include <stdlib.h>
+#include <inttypes.h>
+#include "ld2450.h"
+#include "ld2450_private.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = LD2450_LOG_TAG;
+
+/**
+ * @brief Allocate the parsed-frame ring
+ * 
+ * @param instance Driver instance
+ * @param depth Number of slots (0 leaves the ring disabled)
+ * @param compact Store compact frames instead of full frames
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_ring_init(ld2450_state_t *instance, uint32_t depth, bool compact)
+{
+    atomic_init(&instance->ring_head, 0);
+    atomic_init(&instance->ring_tail, 0);
+    instance->ring_overruns = 0;
+    instance->ring_claimed = false;
+    
+    if (depth == 0) {
+        return ESP_OK;
+    }
+    
+    instance->ring_compact = compact;
+    instance->ring_epoch_us = esp_timer_get_time();
+    instance->ring_last_timestamp_us = instance->ring_epoch_us;
+    instance->ring = calloc(depth, compact ? sizeof(ld2450_compact_frame_t) : sizeof(ld2450_frame_t));
+    instance->ring_sem = xSemaphoreCreateCounting(depth, 0);
+    if (!instance->ring || !instance->ring_sem) {
+        ESP_LOGE(TAG, "Failed to allocate frame ring (%" PRIu32 " slots)", depth);
+        ld2450_ring_deinit(instance);
+        return ESP_ERR_NO_MEM;
+    }
+    
+    instance->ring_depth = depth;
+    return ESP_OK;
+}
+
+/**
+ * @brief Release the parsed-frame ring
+ * 
+ * @param instance Driver instance
+ */
+void ld2450_ring_deinit(ld2450_state_t *instance)
+{
+    if (instance->ring_sem) {
+        vSemaphoreDelete(instance->ring_sem);
+        instance->ring_sem = NULL;
+    }
+    free(instance->ring);
+    instance->ring = NULL;
+    instance->ring_depth = 0;
+}
+
+/**
+ * @brief Get the frame the parser should write into
+ * 
+ * @param instance Driver instance
+ * @param in_ring Set to true if the returned frame is a ring slot
+ * @return Frame to parse into
+ */
+ld2450_frame_t *ld2450_ring_write_slot(ld2450_state_t *instance, bool *in_ring)
+{
+    *in_ring = false;
+    
+    // Compact rings are filled by conversion in ld2450_ring_publish()
+    if (!instance->ring || instance->ring_compact) {
+        return &instance->frame;
+    }
+    
+    uint32_t head = atomic_load_explicit(&instance->ring_head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&instance->ring_tail, memory_order_acquire);
+    
+    // Never overwrite a slot the consumer may still be reading
+    if (head - tail >= instance->ring_depth) {
+        instance->ring_overruns++;
+        return &instance->frame;
+    }
+    
+    *in_ring = true;
+    return &((ld2450_frame_t *)instance->ring)[head % instance->ring_depth];
+}
+
+/**
+ * @brief Publish a parsed frame to the consumer
+ * 
+ * @param instance Driver instance
+ * @param frame Frame returned by ld2450_ring_write_slot() and parsed successfully
+ * @param in_ring Value reported by ld2450_ring_write_slot()
+ */
+void ld2450_ring_publish(ld2450_state_t *instance, const ld2450_frame_t *frame, bool in_ring)
+{
+    if (!instance->ring) {
+        return;
+    }
+    
+    if (instance->ring_compact) {
+        uint32_t head = atomic_load_explicit(&instance->ring_head, memory_order_relaxed);
+        uint32_t tail = atomic_load_explicit(&instance->ring_tail, memory_order_acquire);
+        
+        if (head - tail >= instance->ring_depth) {
+            instance->ring_overruns++;
+            return;
+        }
+        
+        // Chain from the last published frame so the consumer can decode in order
+        ld2450_compact_frame_t *slot = &((ld2450_compact_frame_t *)instance->ring)[head % instance->ring_depth];
+        ld2450_frame_to_compact(frame, instance->ring_last_timestamp_us, slot);
+        instance->ring_last_timestamp_us = frame->timestamp_us;
+    } else if (!in_ring) {
+        // Full ring: the overrun was counted when the scratch frame was handed out
+        return;
+    }
+    
+    atomic_fetch_add_explicit(&instance->ring_head, 1, memory_order_release);
+    xSemaphoreGive(instance->ring_sem);
+}
+
+/**
+ * @brief Claim the oldest published ring slot
+ * 
+ * @param instance Driver instance
+ * @param compact Ring format expected by the caller
+ * @param slot Pointer to store the claimed slot
+ * @param timeout_ms Maximum time to wait in milliseconds
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+static esp_err_t ring_acquire(ld2450_state_t *instance, bool compact, const void **slot,
+                              uint32_t timeout_ms)
+{
+    if (!instance->ring || instance->ring_compact != compact) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    
+    if (instance->ring_claimed) {
+        ESP_LOGW(TAG, "Previous frame not released");
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    if (xSemaphoreTake(instance->ring_sem, pdMS_TO_TICKS(timeout_ms)) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+    
+    uint32_t tail = atomic_load_explicit(&instance->ring_tail, memory_order_relaxed);
+    
+    // Pairs with the release in ld2450_ring_publish()
+    atomic_load_explicit(&instance->ring_head, memory_order_acquire);
+    
+    uint32_t index = tail % instance->ring_depth;
+    if (compact) {
+        *slot = &((const ld2450_compact_frame_t *)instance->ring)[index];
+    } else {
+        *slot = &((const ld2450_frame_t *)instance->ring)[index];
+    }
+    instance->ring_claimed = true;
+    
+    return ESP_OK;
+}
+
+/**
+ * @brief Claim the oldest parsed frame from an instance's frame ring
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param frame Pointer to store the claimed frame
+ * @param timeout_ms Maximum time to wait in milliseconds
+ * @return esp_err_t ESP_OK on success, ESP_ERR_TIMEOUT if no frame arrived, error code otherwise
+ */
+esp_err_t ld2450_frame_acquire(ld2450_handle_t handle, const ld2450_frame_t **frame,
+                               uint32_t timeout_ms)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized || !frame) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    return ring_acquire(instance, false, (const void **)frame, timeout_ms);
+}
+
+/**
+ * @brief Claim the oldest frame from a compact frame ring
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param frame Pointer to store the claimed frame
+ * @param timeout_ms Maximum time to wait in milliseconds
+ * @return esp_err_t ESP_OK on success, ESP_ERR_TIMEOUT if no frame arrived, error code otherwise
+ */
+esp_err_t ld2450_compact_frame_acquire(ld2450_handle_t handle, const ld2450_compact_frame_t **frame,
+                                       uint32_t timeout_ms)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized || !frame) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    return ring_acquire(instance, true, (const void **)frame, timeout_ms);
+}
+
+/**
+ * @brief Get the base time of the compact frame ring's timestamp chain
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param epoch_us Pointer to store the base time (esp_timer time, us)
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_get_compact_epoch(ld2450_handle_t handle, int64_t *epoch_us)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized || !epoch_us) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    *epoch_us = instance->ring_epoch_us;
+    return ESP_OK;
+}
+
+/**
+ * @brief Return the frame claimed with ld2450_frame_acquire() to the driver
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_STATE if no frame is claimed
+ */
+esp_err_t ld2450_frame_release(ld2450_handle_t handle)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    if (!instance->ring_claimed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    instance->ring_claimed = false;
+    atomic_fetch_add_explicit(&instance->ring_tail, 1, memory_order_release);
+    
+    return ESP_OK;
+}
+
+/**
+ * @brief Get the number of frames dropped because the frame ring was full
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param overruns Pointer to store the overrun count
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_get_frame_overruns(ld2450_handle_t handle, uint32_t *overruns)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized || !overruns) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    *overruns = instance->ring_overruns;
+    return ESP_OK;
+}
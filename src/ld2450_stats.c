@@ -0,0 +1,186 @@
+/**
+ * @file ld2450_stats.c
+ * @brief Driver statistics and timing instrumentation
+ * 
+ * The processing task updates plain counters and fixed-size histograms per
+ * frame, each under a short spinlock so that ld2450_get_stats() reads a
+ * consistent snapshot; there is no allocation, so the instrumentation can stay
+ * enabled in production builds. A reset is applied by the processing task,
+ * so it never races with an update.
+ * 
+ * @author NieRVoid
+ * @date 2025-03-12
+ * @license MIT
+ */
+
+#include <string.h>
+#include <stdatomic.h>
+#include "ld2450.h"
+#include "ld2450_private.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+#if LD2450_ENABLE_STATS
+/**
+ * @brief Add a sample to a timing distribution
+ * 
+ * @param acc Distribution to update
+ * @param us Sample in microseconds (clamped to 0..UINT32_MAX)
+ */
+void ld2450_stats_sample(ld2450_timing_acc_t *acc, int64_t us)
+{
+    uint32_t value = us < 0 ? 0 : (us > UINT32_MAX ? UINT32_MAX : (uint32_t)us);
+    
+    if (acc->samples == 0 || value < acc->min_us) {
+        acc->min_us = value;
+    }
+    if (value > acc->max_us) {
+        acc->max_us = value;
+    }
+    acc->samples++;
+    acc->total_us += value;
+    
+    // Bin by the position of the highest set bit: <128, [128, 256), ..., >= 8192
+    int bin = 0;
+    if (value >= 128) {
+        bin = (31 - __builtin_clz(value)) - 6;
+        if (bin >= LD2450_STATS_HISTOGRAM_BINS) {
+            bin = LD2450_STATS_HISTOGRAM_BINS - 1;
+        }
+    }
+    acc->histogram[bin]++;
+}
+
+/**
+ * @brief Convert a running distribution to its public form
+ * 
+ * @param acc Running distribution
+ * @param out Public distribution
+ */
+static void timing_report(const ld2450_timing_acc_t *acc, ld2450_latency_stats_t *out)
+{
+    out->samples = acc->samples;
+    out->min_us = acc->min_us;
+    out->max_us = acc->max_us;
+    out->avg_us = acc->samples ? (uint32_t)(acc->total_us / acc->samples) : 0;
+    memcpy(out->histogram, acc->histogram, sizeof(out->histogram));
+}
+#endif
+
+/**
+ * @brief Get driver statistics
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param stats Pointer to store the statistics
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_SUPPORTED if built with LD2450_ENABLE_STATS=0
+ */
+esp_err_t ld2450_get_stats(ld2450_handle_t handle, ld2450_stats_t *stats)
+{
+#if LD2450_ENABLE_STATS
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized || !stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    // Copy under the lock, convert outside it
+    ld2450_stats_acc_t snapshot;
+    const ld2450_stats_acc_t *acc = &snapshot;
+    
+    portENTER_CRITICAL(&instance->stats_lock);
+    snapshot = instance->stats;
+    stats->sync = instance->sync_stats;
+    portEXIT_CRITICAL(&instance->stats_lock);
+    
+    stats->frames_delivered = acc->frames_delivered;
+    stats->frames_suppressed = acc->frames_suppressed;
+    stats->batches_delivered = acc->batches_delivered;
+    stats->frame_ring_overruns = instance->ring_overruns;
+    stats->uart_fifo_overflows = acc->uart_fifo_overflows;
+    stats->uart_buffer_full = acc->uart_buffer_full;
+    stats->uart_queue_peak = acc->uart_queue_peak;
+    stats->subscriber_drops = acc->subscriber_drops;
+    stats->events_dropped = acc->events_dropped;
+    stats->capture_drops = acc->capture_drops;
+    stats->elapsed_us = esp_timer_get_time() - acc->since_us;
+    timing_report(&acc->latency, &stats->latency);
+    timing_report(&acc->callback_time, &stats->callback_time);
+    
+    return ESP_OK;
+#else
+    (void)handle;
+    (void)stats;
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+#if LD2450_ENABLE_STATS
+/**
+ * @brief Clear the counters reported by ld2450_get_stats()
+ * 
+ * @param instance Driver instance
+ */
+static void stats_clear(ld2450_state_t *instance)
+{
+    portENTER_CRITICAL(&instance->stats_lock);
+    memset(&instance->stats, 0, sizeof(instance->stats));
+    memset(&instance->sync_stats, 0, sizeof(instance->sync_stats));
+    instance->stats.since_us = esp_timer_get_time();
+    portEXIT_CRITICAL(&instance->stats_lock);
+    instance->ring_overruns = 0;
+}
+#endif
+
+/**
+ * @brief Apply a pending ld2450_reset_stats()
+ * 
+ * Called by the processing task after every wakeup.
+ * 
+ * @param instance Driver instance
+ */
+void ld2450_stats_poll(ld2450_state_t *instance)
+{
+#if LD2450_ENABLE_STATS
+    if (atomic_exchange(&instance->stats_reset_pending, false)) {
+        stats_clear(instance);
+    }
+#else
+    (void)instance;
+#endif
+}
+
+/**
+ * @brief Reset all counters reported by ld2450_get_stats()
+ * 
+ * With a processing task the reset is applied by the task, which is woken for
+ * it, so it takes effect shortly after the call returns.
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_SUPPORTED if built with LD2450_ENABLE_STATS=0
+ */
+esp_err_t ld2450_reset_stats(ld2450_handle_t handle)
+{
+#if LD2450_ENABLE_STATS
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    if (instance->auto_processing) {
+        atomic_store(&instance->stats_reset_pending, true);
+        
+        // A silent or idle radar would not wake the task for a long time
+        uart_event_t wake = { .type = LD2450_UART_EVENT_WAKE };
+        xQueueSend(instance->uart_queue, &wake, 0);
+    } else {
+        stats_clear(instance);
+    }
+    
+    return ESP_OK;
+#else
+    (void)handle;
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
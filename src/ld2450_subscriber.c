@@ -0,0 +1,322 @@
+/**
+ * @file ld2450_subscriber.c
+ * @brief Frame fan-out to multiple subscribers
+ * 
+ * Callback subscribers run inline on the processing task. Queue and notify
+ * subscribers share one reference-counted copy of each frame from a small pool,
+ * so every consumer works at its own pace: a full queue or an exhausted pool
+ * costs that subscriber the frame, never the UART.
+ * 
+ * @author NieRVoid
+ * @date 2025-03-12
+ * @license MIT
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "ld2450.h"
+#include "ld2450_private.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = LD2450_LOG_TAG;
+
+/**
+ * @brief Copy a frame into a free pool slot
+ * 
+ * @param instance Driver instance
+ * @param frame Frame to copy
+ * @return Slot holding one reference for the caller, NULL if the pool is exhausted
+ */
+static ld2450_frame_ref_t *pool_acquire(ld2450_state_t *instance, const ld2450_frame_t *frame)
+{
+    for (int i = 0; i < LD2450_FRAME_POOL_SIZE; i++) {
+        ld2450_frame_ref_t *slot = &instance->frame_pool[i];
+        
+        // Only this task revives a slot, so a zero count cannot change under us
+        if (atomic_load_explicit(&slot->refs, memory_order_acquire) == 0) {
+            slot->frame = *frame;
+            atomic_store_explicit(&slot->refs, 1, memory_order_release);
+            return slot;
+        }
+    }
+    
+    return NULL;
+}
+
+/**
+ * @brief Drop one reference to a pool slot
+ */
+static inline void pool_put(ld2450_frame_ref_t *slot)
+{
+    atomic_fetch_sub_explicit(&slot->refs, 1, memory_order_release);
+}
+
+/**
+ * @brief Look up an active subscriber
+ * 
+ * @param instance Driver instance
+ * @param subscriber_id Subscriber ID
+ * @return Subscriber, NULL for an unknown ID
+ */
+static ld2450_subscriber_t *subscriber_get(ld2450_state_t *instance, int subscriber_id)
+{
+    if (subscriber_id < 0 || subscriber_id >= LD2450_SUBSCRIBER_MAX ||
+        !atomic_load(&instance->subscribers[subscriber_id].active)) {
+        return NULL;
+    }
+    
+    return &instance->subscribers[subscriber_id];
+}
+
+/**
+ * @brief Hand a delivered frame to the subscribers
+ * 
+ * @param instance Driver instance
+ * @param frame Delivered frame
+ */
+void ld2450_subscriber_dispatch(ld2450_state_t *instance, const ld2450_frame_t *frame)
+{
+    ld2450_frame_ref_t *slot = NULL;
+    bool slot_tried = false;
+    
+    atomic_store(&instance->subscriber_dispatching, true);
+    
+    for (int i = 0; i < LD2450_SUBSCRIBER_MAX; i++) {
+        ld2450_subscriber_t *sub = &instance->subscribers[i];
+        const ld2450_subscriber_config_t *config = &sub->config;
+        
+        if (!atomic_load(&sub->active)) {
+            continue;
+        }
+        
+        if (config->mode == LD2450_SUBSCRIBER_CALLBACK) {
+            config->callback(frame, config->user_ctx);
+            continue;
+        }
+        
+        // One copy per frame, shared by every reference-taking subscriber
+        if (!slot_tried) {
+            slot_tried = true;
+            slot = pool_acquire(instance, frame);
+        }
+        if (!slot) {
+            LD2450_STATS_INC(instance, subscriber_drops);
+            continue;
+        }
+        
+        atomic_fetch_add_explicit(&slot->refs, 1, memory_order_relaxed);
+        
+        if (config->mode == LD2450_SUBSCRIBER_QUEUE) {
+            const ld2450_frame_t *ref = &slot->frame;
+            if (xQueueSend(config->queue, &ref, 0) != pdTRUE) {
+                pool_put(slot);
+                LD2450_STATS_INC(instance, subscriber_drops);
+            }
+        } else {
+            ld2450_frame_ref_t *old = atomic_exchange(&sub->latest, slot);
+            if (old) {
+                pool_put(old);
+            }
+            xTaskNotify(config->task, config->notify_bits ? config->notify_bits : 1, eSetBits);
+        }
+    }
+    
+    // Drop the dispatcher's own reference
+    if (slot) {
+        pool_put(slot);
+    }
+    
+    atomic_store(&instance->subscriber_dispatching, false);
+}
+
+/**
+ * @brief Drop all subscribers and free the frame pool
+ * 
+ * @param instance Driver instance, with its processing task stopped
+ */
+void ld2450_subscriber_deinit(ld2450_state_t *instance)
+{
+    for (int i = 0; i < LD2450_SUBSCRIBER_MAX; i++) {
+        atomic_store(&instance->subscribers[i].active, false);
+        instance->subscribers[i].reserved = false;
+    }
+    atomic_store(&instance->subscriber_count, 0);
+    free(instance->frame_pool);
+    instance->frame_pool = NULL;
+}
+
+/**
+ * @brief Add a frame subscriber
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param config Subscriber (copied)
+ * @param subscriber_id Pointer to store the subscriber ID
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NO_MEM if the table is full, error code otherwise
+ */
+esp_err_t ld2450_subscribe(ld2450_handle_t handle, const ld2450_subscriber_config_t *config,
+                           int *subscriber_id)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    esp_err_t ret = ESP_ERR_NO_MEM;
+    
+    if (!instance || !instance->initialized || !config || !subscriber_id) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    if ((config->mode == LD2450_SUBSCRIBER_CALLBACK && !config->callback) ||
+        (config->mode == LD2450_SUBSCRIBER_QUEUE && !config->queue) ||
+        (config->mode == LD2450_SUBSCRIBER_NOTIFY && !config->task) ||
+        config->mode > LD2450_SUBSCRIBER_NOTIFY) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    if (xSemaphoreTake(instance->mutex, portMAX_DELAY) != pdTRUE) {
+        return ESP_FAIL;
+    }
+    
+    if (config->mode != LD2450_SUBSCRIBER_CALLBACK && !instance->frame_pool) {
+        instance->frame_pool = calloc(LD2450_FRAME_POOL_SIZE, sizeof(ld2450_frame_ref_t));
+        if (!instance->frame_pool) {
+            ESP_LOGE(TAG, "Failed to allocate frame pool");
+            xSemaphoreGive(instance->mutex);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    
+    for (int i = 0; i < LD2450_SUBSCRIBER_MAX; i++) {
+        ld2450_subscriber_t *sub = &instance->subscribers[i];
+        if (sub->reserved) {
+            continue;
+        }
+        
+        sub->reserved = true;
+        sub->config = *config;
+        atomic_store(&sub->latest, NULL);
+        atomic_store(&sub->active, true);
+        atomic_fetch_add(&instance->subscriber_count, 1);
+        
+        *subscriber_id = i;
+        ret = ESP_OK;
+        break;
+    }
+    
+    xSemaphoreGive(instance->mutex);
+    
+    if (ret == ESP_OK) {
+        ESP_LOGI(TAG, "Subscriber %d added (mode %d)", *subscriber_id, config->mode);
+    } else {
+        ESP_LOGW(TAG, "Subscriber table full");
+    }
+    return ret;
+}
+
+/**
+ * @brief Remove a frame subscriber
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param subscriber_id ID returned by ld2450_subscribe()
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_FOUND for an unknown ID
+ */
+esp_err_t ld2450_unsubscribe(ld2450_handle_t handle, int subscriber_id)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    if (xSemaphoreTake(instance->mutex, portMAX_DELAY) != pdTRUE) {
+        return ESP_FAIL;
+    }
+    
+    ld2450_subscriber_t *sub = subscriber_get(instance, subscriber_id);
+    if (!sub) {
+        xSemaphoreGive(instance->mutex);
+        return ESP_ERR_NOT_FOUND;
+    }
+    
+    atomic_store(&sub->active, false);
+    atomic_fetch_sub(&instance->subscriber_count, 1);
+    xSemaphoreGive(instance->mutex);
+    
+    // Let a dispatch that may still see the entry finish (unless we are that dispatch).
+    // The mutex is not held here, since a subscriber callback may be waiting for it.
+    if (ld2450_command_via_task(instance)) {
+        while (atomic_load(&instance->subscriber_dispatching)) {
+            vTaskDelay(1);
+        }
+    }
+    
+    ld2450_frame_ref_t *old = atomic_exchange(&sub->latest, NULL);
+    if (old) {
+        pool_put(old);
+    }
+    
+    // Only now may ld2450_subscribe() reuse the entry
+    if (xSemaphoreTake(instance->mutex, portMAX_DELAY) == pdTRUE) {
+        sub->reserved = false;
+        xSemaphoreGive(instance->mutex);
+    }
+    
+    ESP_LOGI(TAG, "Subscriber %d removed", subscriber_id);
+    return ESP_OK;
+}
+
+/**
+ * @brief Take the latest frame of a NOTIFY subscriber
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param subscriber_id ID returned by ld2450_subscribe()
+ * @param frame Pointer to store the frame reference
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_FOUND if no frame arrived since the last take
+ */
+esp_err_t ld2450_subscriber_take(ld2450_handle_t handle, int subscriber_id, const ld2450_frame_t **frame)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized || !frame) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    ld2450_subscriber_t *sub = subscriber_get(instance, subscriber_id);
+    if (!sub || sub->config.mode != LD2450_SUBSCRIBER_NOTIFY) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    // The subscriber's reference moves to the caller
+    ld2450_frame_ref_t *slot = atomic_exchange(&sub->latest, NULL);
+    if (!slot) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    
+    *frame = &slot->frame;
+    return ESP_OK;
+}
+
+/**
+ * @brief Return a frame reference received by a QUEUE or NOTIFY subscriber
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param frame Frame reference
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG if frame is not a pool slot
+ */
+esp_err_t ld2450_subscriber_release(ld2450_handle_t handle, const ld2450_frame_t *frame)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized || !frame || !instance->frame_pool) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    ld2450_frame_ref_t *slot = (ld2450_frame_ref_t *)frame;
+    if (slot < instance->frame_pool || slot >= instance->frame_pool + LD2450_FRAME_POOL_SIZE) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    pool_put(slot);
+    return ESP_OK;
+}
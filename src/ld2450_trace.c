@@ -0,0 +1,172 @@
+/**
+ * @file ld2450_trace.c
+ * @brief Binary event trace
+ * 
+ * The processing task records sync loss, dropped input, command traffic and
+ * callback run times as fixed-size records in a per-instance ring, which costs a
+ * timestamp and a store instead of a formatted log line that can block the task
+ * on a slow console. Applications read the records for a timeline, or let a
+ * low-priority task log rate-limited summaries with ld2450_trace_log().
+ * 
+ * @author NieRVoid
+ * @date 2025-03-12
+ * @license MIT
+ */
+
+#include <inttypes.h>
+#include <string.h>
+#include "ld2450.h"
+#include "ld2450_private.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#if LD2450_ENABLE_TRACE
+
+static const char *TAG = LD2450_LOG_TAG;
+
+_Static_assert((LD2450_TRACE_DEPTH & (LD2450_TRACE_DEPTH - 1)) == 0, "LD2450_TRACE_DEPTH must be a power of two");
+
+/**
+ * @brief Append an event to the trace ring (use LD2450_TRACE())
+ * 
+ * @param instance Driver instance
+ * @param event Event
+ * @param arg8 Event-specific argument
+ * @param arg16 Event-specific argument
+ * @param arg32 Event-specific argument
+ */
+void ld2450_trace_record(ld2450_state_t *instance, ld2450_trace_event_t event, uint8_t arg8,
+                         uint16_t arg16, uint32_t arg32)
+{
+    uint32_t head = atomic_load_explicit(&instance->trace_head, memory_order_relaxed);
+    ld2450_trace_record_t *record = &instance->trace[head & (LD2450_TRACE_DEPTH - 1)];
+    
+    record->timestamp_us = (uint32_t)esp_timer_get_time();
+    record->event = (uint8_t)event;
+    record->arg8 = arg8;
+    record->arg16 = arg16;
+    record->arg32 = arg32;
+    instance->trace_counts[event]++;
+    
+    atomic_store_explicit(&instance->trace_head, head + 1, memory_order_release);
+}
+
+#endif
+
+/**
+ * @brief Read the binary event trace
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param records Array to store the records
+ * @param max Capacity of records
+ * @param count Pointer to store the number of records stored
+ * @param lost Pointer to store the number of records overwritten before they were read (may be NULL)
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_SUPPORTED if built with LD2450_ENABLE_TRACE=0
+ */
+esp_err_t ld2450_trace_read(ld2450_handle_t handle, ld2450_trace_record_t *records, size_t max,
+                            size_t *count, uint32_t *lost)
+{
+#if LD2450_ENABLE_TRACE
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized || !records || !count) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    uint32_t head = atomic_load_explicit(&instance->trace_head, memory_order_acquire);
+    uint32_t tail = instance->trace_tail;
+    uint32_t dropped = 0;
+    
+    if (head - tail > LD2450_TRACE_DEPTH) {
+        dropped = head - tail - LD2450_TRACE_DEPTH;
+        tail = head - LD2450_TRACE_DEPTH;
+    }
+    
+    size_t n = MIN(max, (size_t)(head - tail));
+    for (size_t i = 0; i < n; i++) {
+        records[i] = instance->trace[(tail + i) & (LD2450_TRACE_DEPTH - 1)];
+    }
+    
+    // The writer may have lapped the copy meanwhile, including the record it is
+    // writing right now; discard every record it could have overwritten
+    atomic_thread_fence(memory_order_acquire);
+    uint32_t now_head = atomic_load_explicit(&instance->trace_head, memory_order_relaxed);
+    if (now_head + 1 - tail > LD2450_TRACE_DEPTH) {
+        size_t stale = MIN(n, (size_t)(now_head + 1 - tail - LD2450_TRACE_DEPTH));
+        memmove(records, records + stale, (n - stale) * sizeof(*records));
+        n -= stale;
+        dropped += stale;
+        tail += stale;
+    }
+    
+    instance->trace_tail = tail + n;
+    *count = n;
+    if (lost) {
+        *lost = dropped;
+    }
+    
+    return ESP_OK;
+#else
+    (void)handle;
+    (void)records;
+    (void)max;
+    (void)count;
+    (void)lost;
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+/**
+ * @brief Log a one-line summary of the trace events since the last summary
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param min_interval_ms Shortest interval between two summaries
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_SUPPORTED if built with LD2450_ENABLE_TRACE=0
+ */
+esp_err_t ld2450_trace_log(ld2450_handle_t handle, uint32_t min_interval_ms)
+{
+#if LD2450_ENABLE_TRACE
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    uint32_t delta[LD2450_TRACE_EVENT_MAX];
+    bool any = false;
+    
+    if (!instance || !instance->initialized) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    int64_t now = esp_timer_get_time();
+    int64_t elapsed_us = now - instance->trace_logged_us;
+    if (elapsed_us < (int64_t)min_interval_ms * 1000) {
+        return ESP_OK;
+    }
+    
+    for (int i = 0; i < LD2450_TRACE_EVENT_MAX; i++) {
+        uint32_t total = instance->trace_counts[i];
+        delta[i] = total - instance->trace_logged[i];
+        instance->trace_logged[i] = total;
+        any |= delta[i] != 0;
+    }
+    instance->trace_logged_us = now;
+    
+    if (!any) {
+        return ESP_OK;
+    }
+    
+    bool trouble = delta[LD2450_TRACE_FOOTER_ERROR] || delta[LD2450_TRACE_UART_OVERFLOW] ||
+                   delta[LD2450_TRACE_CMD_TIMEOUT] || delta[LD2450_TRACE_ACK_INVALID];
+    ESP_LOG_LEVEL_LOCAL(trouble ? ESP_LOG_WARN : ESP_LOG_INFO, TAG,
+                        "UART%d in %" PRIu32 " ms: %" PRIu32 " frames, %" PRIu32 " footer errors, %" PRIu32
+                        " resyncs, %" PRIu32 " input drops, %" PRIu32 " commands (%" PRIu32 " timeouts, %" PRIu32
+                        " bad ACKs)",
+                        (int)instance->uart_port, (uint32_t)(elapsed_us / 1000), delta[LD2450_TRACE_FRAME],
+                        delta[LD2450_TRACE_FOOTER_ERROR], delta[LD2450_TRACE_RESYNC],
+                        delta[LD2450_TRACE_UART_OVERFLOW], delta[LD2450_TRACE_CMD_SENT],
+                        delta[LD2450_TRACE_CMD_TIMEOUT], delta[LD2450_TRACE_ACK_INVALID]);
+    
+    return ESP_OK;
+#else
+    (void)handle;
+    (void)min_interval_ms;
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
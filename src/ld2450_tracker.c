@@ -0,0 +1,356 @@
+/**
+ * @file ld2450_tracker.c
+ * @brief Multi-frame target tracker with stable IDs
+ * 
+ * Greedy nearest-neighbour association of the module's target slots to a fixed
+ * table of tracks, each smoothed by an integer alpha-beta filter. Runs in the
+ * processing task for every parsed frame, before the delivery policy, so the
+ * motion model sees the real frame interval.
+ * 
+ * @author NieRVoid
+ * @date 2025-03-12
+ * @license MIT
+ */
+
+#include <string.h>
+#include "ld2450.h"
+#include "ld2450_private.h"
+#include "esp_log.h"
+
+static const char *TAG = LD2450_LOG_TAG;
+
+/** @brief Track position units per millimetre */
+#define TRACK_POS_SCALE 16
+
+/**
+ * @brief Fill in defaults for zero configuration fields
+ * 
+ * @param config Configuration to resolve
+ */
+static void tracker_resolve(ld2450_tracker_config_t *config)
+{
+    if (!config->gate_mm) {
+        config->gate_mm = 600;
+    }
+    if (!config->alpha) {
+        config->alpha = 128;
+    }
+    if (!config->beta) {
+        config->beta = 32;
+    }
+    if (!config->confirm_hits) {
+        config->confirm_hits = 2;
+    }
+    if (!config->max_missed) {
+        config->max_missed = 5;
+    }
+}
+
+/**
+ * @brief Saturate a value to int16_t
+ */
+static inline int16_t clamp16(int64_t value)
+{
+    return value > INT16_MAX ? INT16_MAX : (value < INT16_MIN ? INT16_MIN : (int16_t)value);
+}
+
+/**
+ * @brief Convert a track position to millimetres, rounding to nearest
+ */
+static inline int16_t track_mm(int32_t pos)
+{
+    return clamp16(pos >= 0 ? (pos + TRACK_POS_SCALE / 2) / TRACK_POS_SCALE :
+                   (pos - TRACK_POS_SCALE / 2) / TRACK_POS_SCALE);
+}
+
+/**
+ * @brief Correct a track with a measurement
+ * 
+ * @param config Tracker configuration
+ * @param track Track to correct
+ * @param mx Measured x in 1/16 mm
+ * @param my Measured y in 1/16 mm
+ * @param dt_us Time since the previous frame (0 for the first frame)
+ */
+static void track_correct(const ld2450_tracker_config_t *config, ld2450_track_state_t *track,
+                          int32_t mx, int32_t my, int64_t dt_us)
+{
+    int32_t rx = mx - track->x;
+    int32_t ry = my - track->y;
+    
+    track->x += (int32_t)(((int64_t)rx * config->alpha) / 256);
+    track->y += (int32_t)(((int64_t)ry * config->alpha) / 256);
+    
+    if (dt_us > 0) {
+        int64_t scale = dt_us * TRACK_POS_SCALE;
+        if (track->hits == 1) {
+            // Second measurement: initialise velocity from the two points
+            track->vx = (int32_t)((int64_t)rx * 1000000 / scale);
+            track->vy = (int32_t)((int64_t)ry * 1000000 / scale);
+        } else {
+            track->vx += (int32_t)((int64_t)rx * config->beta * 1000000 / (scale * 256));
+            track->vy += (int32_t)((int64_t)ry * config->beta * 1000000 / (scale * 256));
+        }
+    }
+    
+    if (track->hits < UINT16_MAX) {
+        track->hits++;
+    }
+    track->missed = 0;
+}
+
+/**
+ * @brief Set up the tracker of an instance
+ * 
+ * @param instance Driver instance
+ * @param config Initial tracker configuration
+ */
+void ld2450_tracker_init(ld2450_state_t *instance, const ld2450_tracker_config_t *config)
+{
+    ld2450_tracker_t *tracker = &instance->tracker;
+    
+    portMUX_INITIALIZE(&tracker->lock);
+    tracker->config = *config;
+    tracker_resolve(&tracker->config);
+    tracker->next_id = 1;
+}
+
+/**
+ * @brief Run the tracker on a parsed frame
+ * 
+ * @param instance Driver instance
+ * @param frame Parsed and timestamped frame
+ */
+void ld2450_tracker_update(ld2450_state_t *instance, const ld2450_frame_t *frame)
+{
+    ld2450_tracker_t *tracker = &instance->tracker;
+    const ld2450_tracker_config_t *config = &tracker->config;
+    
+    if (tracker->dirty) {
+        portENTER_CRITICAL(&tracker->lock);
+        tracker->config = tracker->pending;
+        tracker->dirty = false;
+        tracker->published.count = 0;
+        portEXIT_CRITICAL(&tracker->lock);
+        
+        tracker_resolve(&tracker->config);
+        memset(tracker->tracks, 0, sizeof(tracker->tracks));
+        tracker->last_us = 0;
+    }
+    
+    if (!config->enabled) {
+        return;
+    }
+    
+    int64_t dt_us = 0;
+    if (tracker->last_us) {
+        dt_us = frame->timestamp_us - tracker->last_us;
+        dt_us = dt_us < LD2450_TRACKER_DT_MIN_US ? LD2450_TRACKER_DT_MIN_US :
+                (dt_us > LD2450_TRACKER_DT_MAX_US ? LD2450_TRACKER_DT_MAX_US : dt_us);
+    }
+    tracker->last_us = frame->timestamp_us;
+    
+    // Predict every track to this frame
+    for (int i = 0; i < LD2450_TRACK_MAX; i++) {
+        ld2450_track_state_t *track = &tracker->tracks[i];
+        if (track->active) {
+            track->x += (int32_t)((int64_t)track->vx * dt_us * TRACK_POS_SCALE / 1000000);
+            track->y += (int32_t)((int64_t)track->vy * dt_us * TRACK_POS_SCALE / 1000000);
+            track->slot = LD2450_TRACK_NO_SLOT;
+        }
+    }
+    
+    // Greedy association: repeatedly take the closest gated track/measurement pair
+    int64_t gate = (int64_t)config->gate_mm * TRACK_POS_SCALE;
+    int64_t gate2 = gate * gate;
+    uint8_t meas_free = 0;
+    for (int m = 0; m < 3; m++) {
+        if (frame->targets[m].valid) {
+            meas_free |= (uint8_t)(1U << m);
+        }
+    }
+    uint8_t track_free = 0;
+    for (int i = 0; i < LD2450_TRACK_MAX; i++) {
+        if (tracker->tracks[i].active) {
+            track_free |= (uint8_t)(1U << i);
+        }
+    }
+    
+    while (meas_free && track_free) {
+        int best_track = -1;
+        int best_meas = -1;
+        int64_t best_d2 = gate2 + 1;
+        
+        for (int i = 0; i < LD2450_TRACK_MAX; i++) {
+            if (!(track_free & (1U << i))) {
+                continue;
+            }
+            for (int m = 0; m < 3; m++) {
+                if (!(meas_free & (1U << m))) {
+                    continue;
+                }
+                int64_t dx = ((int32_t)frame->targets[m].x * TRACK_POS_SCALE) - tracker->tracks[i].x;
+                int64_t dy = ((int32_t)frame->targets[m].y * TRACK_POS_SCALE) - tracker->tracks[i].y;
+                int64_t d2 = dx * dx + dy * dy;
+                if (d2 < best_d2) {
+                    best_d2 = d2;
+                    best_track = i;
+                    best_meas = m;
+                }
+            }
+        }
+        
+        if (best_track < 0) {
+            break;
+        }
+        
+        ld2450_track_state_t *track = &tracker->tracks[best_track];
+        track_correct(config, track, (int32_t)frame->targets[best_meas].x * TRACK_POS_SCALE,
+                      (int32_t)frame->targets[best_meas].y * TRACK_POS_SCALE, dt_us);
+        track->slot = (uint8_t)best_meas;
+        track_free &= (uint8_t)~(1U << best_track);
+        meas_free &= (uint8_t)~(1U << best_meas);
+    }
+    
+    // Unmatched tracks coast; tentative ones are dropped at their first miss
+    for (int i = 0; i < LD2450_TRACK_MAX; i++) {
+        if (!(track_free & (1U << i))) {
+            continue;
+        }
+        ld2450_track_state_t *track = &tracker->tracks[i];
+        track->missed++;
+        if (track->hits < config->confirm_hits || track->missed > config->max_missed) {
+            ESP_LOGD(TAG, "Track %u dropped after %u hits", track->id, track->hits);
+            track->active = false;
+        }
+    }
+    
+    // Unmatched measurements start new tracks
+    for (int m = 0; m < 3 && meas_free; m++) {
+        if (!(meas_free & (1U << m))) {
+            continue;
+        }
+        for (int i = 0; i < LD2450_TRACK_MAX; i++) {
+            ld2450_track_state_t *track = &tracker->tracks[i];
+            if (track->active) {
+                continue;
+            }
+            *track = (ld2450_track_state_t) {
+                .active = true,
+                .slot = (uint8_t)m,
+                .id = tracker->next_id,
+                .hits = 1,
+                .x = (int32_t)frame->targets[m].x * TRACK_POS_SCALE,
+                .y = (int32_t)frame->targets[m].y * TRACK_POS_SCALE,
+                .first_seen_us = frame->timestamp_us,
+            };
+            tracker->next_id = tracker->next_id == UINT16_MAX ? 1 : tracker->next_id + 1;
+            break;
+        }
+    }
+    
+    // Publish confirmed tracks
+    ld2450_track_set_t set = {
+        .sequence = frame->sequence,
+        .timestamp_us = frame->timestamp_us,
+    };
+    for (int i = 0; i < LD2450_TRACK_MAX; i++) {
+        const ld2450_track_state_t *track = &tracker->tracks[i];
+        if (!track->active || track->hits < config->confirm_hits) {
+            continue;
+        }
+        set.tracks[set.count++] = (ld2450_track_t) {
+            .id = track->id,
+            .slot = track->slot,
+            .missed = track->missed,
+            .x = track_mm(track->x),
+            .y = track_mm(track->y),
+            .vx = clamp16(track->vx),
+            .vy = clamp16(track->vy),
+            .hits = track->hits,
+            .first_seen_us = track->first_seen_us,
+        };
+    }
+    
+    portENTER_CRITICAL(&tracker->lock);
+    tracker->published = set;
+    portEXIT_CRITICAL(&tracker->lock);
+}
+
+/**
+ * @brief Replace an instance's tracker configuration
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param config New configuration
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_set_tracker_config(ld2450_handle_t handle, const ld2450_tracker_config_t *config)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized || !config) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    portENTER_CRITICAL(&instance->tracker.lock);
+    instance->tracker.pending = *config;
+    instance->tracker.dirty = true;
+    portEXIT_CRITICAL(&instance->tracker.lock);
+    
+    ESP_LOGI(TAG, "Tracker %s", config->enabled ? "enabled" : "disabled");
+    return ESP_OK;
+}
+
+/**
+ * @brief Get the confirmed tracks after the most recent frame
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param tracks Pointer to store the tracks
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_STATE if the tracker is disabled
+ */
+esp_err_t ld2450_get_tracks(ld2450_handle_t handle, ld2450_track_set_t *tracks)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized || !tracks) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    // A configuration not applied yet already decides: it was the caller's last word
+    ld2450_tracker_t *tracker = &instance->tracker;
+    portENTER_CRITICAL(&tracker->lock);
+    bool enabled = tracker->dirty ? tracker->pending.enabled : tracker->config.enabled;
+    if (enabled) {
+        *tracks = tracker->published;
+    }
+    portEXIT_CRITICAL(&tracker->lock);
+    
+    return enabled ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+/**
+ * @brief Register a callback for tracker output
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param callback Function to call for every delivered frame (NULL to unregister)
+ * @param user_ctx User context pointer passed to the callback function
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_register_track_callback(ld2450_handle_t handle, ld2450_track_cb_t callback,
+                                         void *user_ctx)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    if (xSemaphoreTake(instance->mutex, portMAX_DELAY) == pdTRUE) {
+        instance->tracker.callback = callback;
+        instance->tracker.user_ctx = user_ctx;
+        xSemaphoreGive(instance->mutex);
+        return ESP_OK;
+    }
+    
+    return ESP_FAIL;
+}
@@ -0,0 +1,302 @@
+/**
+ * @file ld2450_uhci.c
+ * @brief UHCI/GDMA receive backend
+ * 
+ * With uart_rx_dma set, the UART driver keeps the TX side and the event queue but
+ * no longer drains the RX FIFO: UHCI moves the bytes by GDMA into one of two
+ * internal buffers, ending each transfer when the line goes idle after a frame.
+ * The ISR queues the received chunk and wakes the processing task, which hands
+ * the other buffer to the DMA and then scans the chunk in place. Apart from frames
+ * that straddle two chunks, no byte is copied by the CPU before it is decoded.
+ * 
+ * @author NieRVoid
+ * @date 2025-03-12
+ * @license MIT
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "ld2450.h"
+#include "ld2450_private.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+#if LD2450_ENABLE_UHCI
+#include "esp_attr.h"
+#include "esp_heap_caps.h"
+#include "driver/uhci.h"
+#endif
+
+static const char *TAG = LD2450_LOG_TAG;
+
+#if LD2450_ENABLE_UHCI
+
+/**
+ * @brief A chunk of received bytes inside one of the DMA buffers
+ */
+typedef struct {
+    const uint8_t *data;
+    size_t len;
+    /** @brief Time the DMA reported the chunk */
+    int64_t timestamp_us;
+} ld2450_uhci_chunk_t;
+
+/**
+ * @brief UHCI backend state
+ * 
+ * The chunk queue has a single producer (the ISR) and a single consumer (the
+ * processing task, or a command it issues).
+ */
+struct ld2450_uhci {
+    uhci_controller_handle_t controller;
+    uint8_t *buffers[2];
+    /** @brief Buffer handed to the DMA last */
+    uint8_t armed;
+    /** @brief The DMA finished its transfer and waits for a buffer */
+    atomic_bool idle;
+    /** @brief The ISR found the chunk queue full */
+    atomic_bool overrun;
+    /** @brief A chunk is being scanned in place, so its buffer is in use */
+    bool parsing;
+    ld2450_uhci_chunk_t chunks[LD2450_UHCI_CHUNK_QUEUE];
+    atomic_uint head;
+    atomic_uint tail;
+};
+
+/**
+ * @brief UHCI RX callback (ISR context)
+ */
+static bool IRAM_ATTR uhci_on_rx(uhci_controller_handle_t controller, const uhci_rx_event_data_t *edata,
+                                 void *user_ctx)
+{
+    ld2450_state_t *instance = user_ctx;
+    ld2450_uhci_t *uhci = instance->uhci;
+    BaseType_t woken = pdFALSE;
+    (void)controller;
+    
+    unsigned head = atomic_load_explicit(&uhci->head, memory_order_relaxed);
+    if (edata->recv_size > 0) {
+        if (head - atomic_load_explicit(&uhci->tail, memory_order_acquire) < LD2450_UHCI_CHUNK_QUEUE) {
+            ld2450_uhci_chunk_t *chunk = &uhci->chunks[head % LD2450_UHCI_CHUNK_QUEUE];
+            chunk->data = edata->data;
+            chunk->len = edata->recv_size;
+            chunk->timestamp_us = esp_timer_get_time();
+            atomic_store_explicit(&uhci->head, head + 1, memory_order_release);
+        } else {
+            atomic_store(&uhci->overrun, true);
+        }
+    }
+    if (edata->flags.totally_received) {
+        atomic_store(&uhci->idle, true);
+    }
+    
+    // Any pending event makes the task drain the whole chunk queue
+    uart_event_t event = { .type = LD2450_UART_EVENT_DMA, .size = edata->recv_size };
+    xQueueSendFromISR(instance->uart_queue, &event, &woken);
+    
+    return woken == pdTRUE;
+}
+
+/**
+ * @brief Give the DMA the other buffer once it has finished the current one
+ * 
+ * Only done while no chunk is being scanned in place: a nested command issued
+ * from a callback would otherwise let the DMA overwrite the chunk under the scanner.
+ */
+static void uhci_rearm(ld2450_state_t *instance)
+{
+    ld2450_uhci_t *uhci = instance->uhci;
+    
+    if (uhci->parsing || !atomic_exchange(&uhci->idle, false)) {
+        return;
+    }
+    
+    // Every chunk of the other buffer was consumed before this one was armed
+    uhci->armed ^= 1;
+    esp_err_t ret = uhci_receive(uhci->controller, uhci->buffers[uhci->armed], LD2450_UHCI_BUF_SIZE);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "UART%d DMA receive failed: %s", (int)instance->uart_port, esp_err_to_name(ret));
+        uhci->armed ^= 1;
+        atomic_store(&uhci->idle, true);
+    }
+}
+
+/**
+ * @brief Copy a chunk into the capture ring
+ */
+static void uhci_capture(ld2450_state_t *instance, const ld2450_uhci_chunk_t *chunk)
+{
+    atomic_store(&instance->capture_busy, true);
+    uint8_t *slot = ld2450_capture_reserve(instance, chunk->len);
+    if (slot) {
+        memcpy(slot, chunk->data, chunk->len);
+        ld2450_capture_commit(instance, chunk->timestamp_us, chunk->len);
+    }
+    atomic_store(&instance->capture_busy, false);
+}
+
+/**
+ * @brief Parse the chunks the UHCI backend has received so far
+ * 
+ * @param instance Driver instance
+ * @param ack_only Only scan for command ACKs (nested call from the processing task)
+ */
+void ld2450_uhci_service(ld2450_state_t *instance, bool ack_only)
+{
+    ld2450_uhci_t *uhci = instance->uhci;
+    
+    if (!uhci) {
+        return;
+    }
+    
+    if (atomic_exchange(&uhci->overrun, false)) {
+        LD2450_STATS_INC(instance, uart_buffer_full);
+        LD2450_TRACE(instance, LD2450_TRACE_UART_OVERFLOW, 2, 0, 0);
+        if (instance->event_loop) {
+            ld2450_event_sync_lost(instance, LD2450_SYNC_LOST_UART_OVERFLOW);
+        }
+    }
+    
+    // Hand the DMA a buffer before scanning, so reception continues meanwhile
+    uhci_rearm(instance);
+    
+    unsigned tail = atomic_load_explicit(&uhci->tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&uhci->head, memory_order_acquire);
+    while (tail != head) {
+        ld2450_uhci_chunk_t chunk = uhci->chunks[tail % LD2450_UHCI_CHUNK_QUEUE];
+        atomic_store_explicit(&uhci->tail, ++tail, memory_order_release);
+        
+        if (ack_only) {
+            // Nested command: the frames in the chunk are scanned once the outer block is done
+            ld2450_scan_ack(instance, chunk.data, chunk.len);
+            ld2450_rx_defer(instance, chunk.data, chunk.len);
+            continue;
+        }
+        
+        if (instance->capture && !instance->replay_running) {
+            uhci_capture(instance, &chunk);
+        }
+        
+        instance->chunk_timestamp_us = chunk.timestamp_us;
+        uhci->parsing = true;
+        ld2450_uart_event_handler(instance, chunk.data, chunk.len);
+        uhci->parsing = false;
+    }
+    
+    // A transfer may have ended while scanning, or under a nested command
+    uhci_rearm(instance);
+}
+
+/**
+ * @brief Switch an instance's reception to the UHCI/GDMA backend
+ * 
+ * @param instance Driver instance, with the UART driver installed and configured
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_SUPPORTED if built without
+ *         LD2450_ENABLE_UHCI, error code otherwise
+ */
+esp_err_t ld2450_uhci_init(ld2450_state_t *instance)
+{
+    ld2450_uhci_t *uhci = calloc(1, sizeof(ld2450_uhci_t));
+    
+    if (!uhci) {
+        return ESP_ERR_NO_MEM;
+    }
+    instance->uhci = uhci;
+    
+    for (int i = 0; i < 2; i++) {
+        uhci->buffers[i] = heap_caps_aligned_calloc(4, 1, LD2450_UHCI_BUF_SIZE,
+                                                    MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+        if (!uhci->buffers[i]) {
+            ESP_LOGE(TAG, "Failed to allocate DMA buffers");
+            ld2450_uhci_deinit(instance);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    
+    // The DMA, not the UART driver's ISR, empties the RX FIFO from now on
+    uart_disable_rx_intr(instance->uart_port);
+    
+    uhci_controller_config_t uhci_config = {
+        .uart_port = instance->uart_port,
+        .tx_trans_queue_depth = 1,
+        .max_transmit_size = LD2450_CMD_BUFFER_SIZE,
+        .max_receive_internal_mem = LD2450_UHCI_BUF_SIZE,
+        .dma_burst_size = 0,
+        .rx_eof_flags.idle_eof = 1,
+    };
+    esp_err_t ret = uhci_new_controller(&uhci_config, &uhci->controller);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create UHCI controller: %s", esp_err_to_name(ret));
+        ld2450_uhci_deinit(instance);
+        return ret;
+    }
+    
+    uhci_event_callbacks_t callbacks = {
+        .on_rx_trans_event = uhci_on_rx,
+    };
+    ret = uhci_register_event_callbacks(uhci->controller, &callbacks, instance);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to register UHCI callbacks: %s", esp_err_to_name(ret));
+        ld2450_uhci_deinit(instance);
+        return ret;
+    }
+    
+    // Start on buffer 0
+    uhci->armed = 1;
+    atomic_store(&uhci->idle, true);
+    uhci_rearm(instance);
+    if (atomic_load(&uhci->idle)) {
+        ld2450_uhci_deinit(instance);
+        return ESP_FAIL;
+    }
+    
+    ESP_LOGI(TAG, "UART%d receiving through UHCI DMA (2 x %d bytes)", (int)instance->uart_port,
+             LD2450_UHCI_BUF_SIZE);
+    return ESP_OK;
+}
+
+/**
+ * @brief Stop the UHCI backend and release its buffers
+ * 
+ * @param instance Driver instance, with its processing task stopped
+ */
+void ld2450_uhci_deinit(ld2450_state_t *instance)
+{
+    ld2450_uhci_t *uhci = instance->uhci;
+    
+    if (!uhci) {
+        return;
+    }
+    
+    if (uhci->controller) {
+        uhci_del_controller(uhci->controller);
+    }
+    instance->uhci = NULL;
+    heap_caps_free(uhci->buffers[0]);
+    heap_caps_free(uhci->buffers[1]);
+    free(uhci);
+}
+
+#else
+
+esp_err_t ld2450_uhci_init(ld2450_state_t *instance)
+{
+    ESP_LOGE(TAG, "uart_rx_dma needs a build with LD2450_ENABLE_UHCI=1");
+    (void)instance;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void ld2450_uhci_deinit(ld2450_state_t *instance)
+{
+    (void)instance;
+}
+
+void ld2450_uhci_service(ld2450_state_t *instance, bool ack_only)
+{
+    (void)instance;
+    (void)ack_only;
+}
+
+#endif
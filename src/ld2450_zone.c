@@ -0,0 +1,343 @@
+/**
+ * @file ld2450_zone.c
+ * @brief Software zones: polygon occupancy and enter/exit events
+ * 
+ * Zones are compiled once into a bounding box and a table of non-horizontal edges
+ * so that the per-frame test is a box check followed by an integer ray-crossing
+ * count. Changes are staged in a pending table and adopted by the processing task
+ * at the start of the next frame, so the hot path takes no lock in steady state.
+ * 
+ * @author NieRVoid
+ * @date 2025-03-12
+ * @license MIT
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "ld2450.h"
+#include "ld2450_private.h"
+#include "esp_log.h"
+
+static const char *TAG = LD2450_LOG_TAG;
+
+/**
+ * @brief Compile a zone into its bounding box and edge table
+ * 
+ * @param zone Zone to compile
+ * @param shape Compiled zone
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG for a bad shape
+ */
+static esp_err_t zone_compile(const ld2450_zone_t *zone, ld2450_zone_shape_t *shape)
+{
+    if (zone->vertex_count < 3 || zone->vertex_count > LD2450_ZONE_MAX_VERTICES) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    memset(shape, 0, sizeof(*shape));
+    shape->min_x = shape->min_y = INT16_MAX;
+    shape->max_x = shape->max_y = INT16_MIN;
+    
+    for (int i = 0; i < zone->vertex_count; i++) {
+        ld2450_point_t a = zone->vertices[i];
+        ld2450_point_t b = zone->vertices[(i + 1) % zone->vertex_count];
+        
+        if (abs(a.x) > LD2450_ZONE_COORD_MAX || abs(a.y) > LD2450_ZONE_COORD_MAX) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        
+        shape->min_x = a.x < shape->min_x ? a.x : shape->min_x;
+        shape->max_x = a.x > shape->max_x ? a.x : shape->max_x;
+        shape->min_y = a.y < shape->min_y ? a.y : shape->min_y;
+        shape->max_y = a.y > shape->max_y ? a.y : shape->max_y;
+        
+        // Horizontal edges never cross a horizontal ray
+        if (a.y == b.y) {
+            continue;
+        }
+        if (a.y > b.y) {
+            ld2450_point_t t = a;
+            a = b;
+            b = t;
+        }
+        
+        ld2450_zone_edge_t *edge = &shape->edges[shape->edge_count++];
+        edge->x0 = a.x;
+        edge->y0 = a.y;
+        edge->y1 = b.y;
+        edge->dx = (int16_t)(b.x - a.x);
+        edge->dy = (int16_t)(b.y - a.y);
+    }
+    
+    return shape->edge_count ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+/**
+ * @brief Test whether a point lies inside a compiled zone
+ * 
+ * Counts edges crossed by a ray from the point towards +x. Inside the bounding
+ * box all differences are below 2 * LD2450_ZONE_COORD_MAX, so the products fit
+ * in 32 bits.
+ * 
+ * @param shape Compiled zone
+ * @param x Point x (mm)
+ * @param y Point y (mm)
+ * @return true if the point is inside
+ */
+static inline bool zone_contains(const ld2450_zone_shape_t *shape, int16_t x, int16_t y)
+{
+    if (x < shape->min_x || x > shape->max_x || y < shape->min_y || y > shape->max_y) {
+        return false;
+    }
+    
+    bool inside = false;
+    for (int i = 0; i < shape->edge_count; i++) {
+        const ld2450_zone_edge_t *edge = &shape->edges[i];
+        
+        if (y >= edge->y0 && y < edge->y1 &&
+            (int32_t)(x - edge->x0) * edge->dy < (int32_t)(y - edge->y0) * edge->dx) {
+            inside = !inside;
+        }
+    }
+    
+    return inside;
+}
+
+/**
+ * @brief Get an instance's zone engine, allocating it on first use
+ * 
+ * @param instance Driver instance
+ * @return Zone engine, NULL if it cannot be allocated
+ */
+static ld2450_zone_engine_t *zone_engine(ld2450_state_t *instance)
+{
+    if (instance->zones) {
+        return instance->zones;
+    }
+    
+    ld2450_zone_engine_t *zones = NULL;
+    if (xSemaphoreTake(instance->mutex, portMAX_DELAY) == pdTRUE) {
+        zones = instance->zones;
+        if (!zones) {
+            zones = calloc(1, sizeof(ld2450_zone_engine_t));
+            if (zones) {
+                portMUX_INITIALIZE(&zones->lock);
+                instance->zones = zones;
+            } else {
+                ESP_LOGE(TAG, "Failed to allocate zone table");
+            }
+        }
+        xSemaphoreGive(instance->mutex);
+    }
+    
+    return zones;
+}
+
+/**
+ * @brief Raise one zone event
+ */
+static void zone_emit(ld2450_zone_cb_t callback, void *user_ctx, const ld2450_frame_t *frame,
+                      int zone, int target, bool entered, uint8_t occupancy)
+{
+    ld2450_zone_event_t event = {
+        .zone = (uint8_t)zone,
+        .target = (uint8_t)target,
+        .entered = entered,
+        .occupancy = occupancy,
+        .sequence = frame->sequence,
+        .timestamp_us = frame->timestamp_us,
+    };
+    
+    callback(&event, user_ctx);
+}
+
+/**
+ * @brief Evaluate the software zones for a parsed frame and raise enter/exit events
+ * 
+ * Removing or reshaping a zone raises exit events for targets no longer inside.
+ * 
+ * @param instance Driver instance
+ * @param frame Parsed frame
+ */
+void ld2450_zone_evaluate(ld2450_state_t *instance, const ld2450_frame_t *frame)
+{
+    ld2450_zone_engine_t *zones = instance->zones;
+    
+    if (!zones) {
+        return;
+    }
+    
+    if (zones->dirty) {
+        portENTER_CRITICAL(&zones->lock);
+        zones->table = zones->pending;
+        zones->dirty = false;
+        portEXIT_CRITICAL(&zones->lock);
+    }
+    
+    const ld2450_zone_table_t *table = &zones->table;
+    uint16_t now[3] = {0};
+    uint16_t changed = 0;
+    
+    for (int t = 0; t < 3; t++) {
+        const ld2450_target_t *target = &frame->targets[t];
+        
+        if (target->valid) {
+            for (uint16_t active = table->active; active; active &= active - 1) {
+                int z = __builtin_ctz(active);
+                if (zone_contains(&table->shapes[z], target->x, target->y)) {
+                    now[t] |= (uint16_t)(1U << z);
+                }
+            }
+        }
+        changed |= now[t] ^ zones->target_zones[t];
+    }
+    
+    if (!changed) {
+        return;
+    }
+    
+    // Exits first, then enters, so each event carries the running occupancy
+    ld2450_zone_cb_t callback = zones->callback;
+    void *user_ctx = zones->user_ctx;
+    for (int t = 0; t < 3; t++) {
+        for (uint16_t left = zones->target_zones[t] & ~now[t]; left; left &= left - 1) {
+            int z = __builtin_ctz(left);
+            zones->occupancy[z]--;
+            if (callback) {
+                zone_emit(callback, user_ctx, frame, z, t, false, zones->occupancy[z]);
+            }
+        }
+    }
+    for (int t = 0; t < 3; t++) {
+        for (uint16_t entered = now[t] & ~zones->target_zones[t]; entered; entered &= entered - 1) {
+            int z = __builtin_ctz(entered);
+            zones->occupancy[z]++;
+            if (callback) {
+                zone_emit(callback, user_ctx, frame, z, t, true, zones->occupancy[z]);
+            }
+        }
+        zones->target_zones[t] = now[t];
+    }
+}
+
+/**
+ * @brief Define or remove a software zone
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param index Zone index (0 to LD2450_ZONE_MAX - 1)
+ * @param zone Zone shape (NULL removes the zone)
+ * @return esp_err_t ESP_OK on success, ESP_ERR_INVALID_ARG for a bad index or shape,
+ *         ESP_ERR_NO_MEM if the zone table cannot be allocated
+ */
+esp_err_t ld2450_set_zone(ld2450_handle_t handle, uint8_t index, const ld2450_zone_t *zone)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    ld2450_zone_shape_t shape;
+    
+    if (!instance || !instance->initialized || index >= LD2450_ZONE_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    if (zone && zone_compile(zone, &shape) != ESP_OK) {
+        ESP_LOGE(TAG, "Invalid shape for zone %u", index);
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    ld2450_zone_engine_t *zones = zone ? zone_engine(instance) : instance->zones;
+    if (!zones) {
+        return zone ? ESP_ERR_NO_MEM : ESP_OK;
+    }
+    
+    portENTER_CRITICAL(&zones->lock);
+    if (zone) {
+        zones->pending.shapes[index] = shape;
+        zones->pending.active |= (uint16_t)(1U << index);
+    } else {
+        zones->pending.active &= (uint16_t)~(1U << index);
+    }
+    zones->dirty = true;
+    portEXIT_CRITICAL(&zones->lock);
+    
+    ESP_LOGI(TAG, "Zone %u %s", index, zone ? "set" : "removed");
+    return ESP_OK;
+}
+
+/**
+ * @brief Remove all software zones
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_clear_zones(ld2450_handle_t handle)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    ld2450_zone_engine_t *zones = instance->zones;
+    if (zones) {
+        portENTER_CRITICAL(&zones->lock);
+        zones->pending.active = 0;
+        zones->dirty = true;
+        portEXIT_CRITICAL(&zones->lock);
+    }
+    
+    return ESP_OK;
+}
+
+/**
+ * @brief Get the number of targets in each software zone
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param occupancy Array receiving the target count of each zone (0 for unused zones)
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_get_zone_occupancy(ld2450_handle_t handle, uint8_t occupancy[LD2450_ZONE_MAX])
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized || !occupancy) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    if (instance->zones) {
+        memcpy(occupancy, instance->zones->occupancy, LD2450_ZONE_MAX);
+    } else {
+        memset(occupancy, 0, LD2450_ZONE_MAX);
+    }
+    
+    return ESP_OK;
+}
+
+/**
+ * @brief Register a callback for zone enter/exit events
+ * 
+ * @param handle Driver handle (NULL for the default instance)
+ * @param callback Function to call for each event (NULL to unregister)
+ * @param user_ctx User context pointer passed to the callback function
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t ld2450_register_zone_callback(ld2450_handle_t handle, ld2450_zone_cb_t callback,
+                                        void *user_ctx)
+{
+    ld2450_state_t *instance = ld2450_resolve_handle(handle);
+    
+    if (!instance || !instance->initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    ld2450_zone_engine_t *zones = zone_engine(instance);
+    if (!zones) {
+        return ESP_ERR_NO_MEM;
+    }
+    
+    if (xSemaphoreTake(instance->mutex, portMAX_DELAY) == pdTRUE) {
+        zones->callback = callback;
+        zones->user_ctx = user_ctx;
+        xSemaphoreGive(instance->mutex);
+        return ESP_OK;
+    }
+    
+    return ESP_FAIL;
+}
@@ -0,0 +1,569 @@
+/**
+ * @file ld2450_host_bench.c
+ * @brief Host-native benchmark of the ld2450 frame parser and streaming scanner
+ * 
+ * Builds the driver sources against the stubs in stubs/ and pushes synthetic or
+ * recorded byte streams through ld2450_process_data() with different chunkings,
+ * reporting throughput, cost per byte and the share of intact frames that were
+ * not delivered. With --check it runs a short fixed workload and fails when a
+ * clean stream loses or invents a frame, or a corrupted one loses too many.
+ * 
+ * @author NieRVoid
+ * @date 2025-03-12
+ * @license MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include "ld2450.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#define BENCH_FRAME_SIZE 30
+
+/** @brief Largest loss of intact frames tolerated in a corrupted stream by --check */
+#define BENCH_CHECK_MAX_CORRUPT_LOSS 0.005
+
+/** @brief How far ahead a delivered frame is looked up among the expected ones */
+#define BENCH_MATCH_WINDOW 64
+
+/** @brief Ways of cutting a stream into ld2450_process_data() calls */
+typedef enum {
+    CHUNK_WHOLE,        /*!< Entire stream in one call */
+    CHUNK_UART,         /*!< Fixed 120-byte chunks, the UART RX FIFO threshold */
+    CHUNK_RANDOM,       /*!< Random 1-256 byte chunks */
+    CHUNK_BYTE,         /*!< One byte per call */
+    CHUNK_STRADDLE,     /*!< Every cut falls inside a frame header */
+} chunk_mode_t;
+
+static const char *const s_chunk_names[] = { "whole", "uart120", "random", "byte", "straddle" };
+
+/** @brief Byte stream plus the frames a perfect parser would deliver from it */
+typedef struct {
+    uint8_t *data;
+    size_t len;
+    size_t cap;
+    size_t *frame_starts;       /*!< Offset of every frame header, intact or not */
+    size_t frame_count;
+    ld2450_frame_t *expected;   /*!< Frames left intact, in stream order */
+    size_t expected_count;
+} bench_stream_t;
+
+/** @brief Corruption applied while generating a stream (probabilities per frame) */
+typedef struct {
+    double flip;                /*!< XOR one byte of the frame with a random value */
+    double truncate;            /*!< Drop the tail of the frame */
+    double garbage;             /*!< Insert noise, often with fake header bytes, before the frame */
+} bench_corruption_t;
+
+/** @brief Delivery bookkeeping of one verification pass */
+typedef struct {
+    const bench_stream_t *stream;
+    size_t cursor;
+    size_t delivered;
+    size_t matched;
+    size_t spurious;
+} bench_match_t;
+
+static uint32_t s_rng = 0x2450u;
+
+static uint32_t rng_next(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+static uint32_t rng_below(uint32_t n)
+{
+    return rng_next() % n;
+}
+
+static bool rng_chance(double p)
+{
+    return p > 0 && rng_next() < p * 4294967296.0;
+}
+
+static void stream_append(bench_stream_t *stream, const uint8_t *data, size_t len)
+{
+    if (stream->len + len > stream->cap) {
+        stream->cap = (stream->cap + len) * 2;
+        stream->data = realloc(stream->data, stream->cap);
+        if (!stream->data) {
+            fprintf(stderr, "out of memory\n");
+            exit(2);
+        }
+    }
+    memcpy(stream->data + stream->len, data, len);
+    stream->len += len;
+}
+
+static void stream_free(bench_stream_t *stream)
+{
+    free(stream->data);
+    free(stream->frame_starts);
+    free(stream->expected);
+    memset(stream, 0, sizeof(*stream));
+}
+
+/**
+ * @brief Encode a value in the protocol's sign-magnitude format
+ */
+static void encode_signed(uint8_t *out, int16_t value)
+{
+    uint16_t raw = (uint16_t)(value < 0 ? -value : value) & 0x7FFF;
+    if (value >= 0) {
+        raw |= 0x8000;
+    }
+    out[0] = (uint8_t)raw;
+    out[1] = (uint8_t)(raw >> 8);
+}
+
+/**
+ * @brief Build a random data frame and the targets it encodes
+ * 
+ * @param raw Frame bytes
+ * @param frame Decoded targets (x, y, speed, resolution, valid)
+ */
+static void frame_generate(uint8_t raw[BENCH_FRAME_SIZE], ld2450_frame_t *frame)
+{
+    static const uint8_t header[4] = {0xAA, 0xFF, 0x03, 0x00};
+    int count = (int)rng_below(4);
+    
+    memset(raw, 0, BENCH_FRAME_SIZE);
+    memset(frame, 0, sizeof(*frame));
+    memcpy(raw, header, sizeof(header));
+    raw[28] = 0x55;
+    raw[29] = 0xCC;
+    
+    for (int t = 0; t < count; t++) {
+        ld2450_target_t *target = &frame->targets[t];
+        uint8_t *segment = raw + 4 + t * 8;
+        
+        target->x = (int16_t)((int)rng_below(8001) - 4000);
+        target->y = (int16_t)(1 + rng_below(6000));
+        target->speed = (int16_t)((int)rng_below(201) - 100);
+        target->resolution = 360;
+        target->valid = true;
+        
+        encode_signed(segment, target->x);
+        encode_signed(segment + 2, target->y);
+        encode_signed(segment + 4, target->speed);
+        segment[6] = (uint8_t)target->resolution;
+        segment[7] = (uint8_t)(target->resolution >> 8);
+    }
+    frame->count = (uint8_t)count;
+}
+
+/**
+ * @brief Generate a synthetic stream
+ * 
+ * @param stream Stream to fill
+ * @param frames Number of frames
+ * @param corruption Corruption to inject (NULL for a clean stream)
+ */
+static void stream_synthesize(bench_stream_t *stream, size_t frames, const bench_corruption_t *corruption)
+{
+    memset(stream, 0, sizeof(*stream));
+    stream->frame_starts = calloc(frames, sizeof(size_t));
+    stream->expected = calloc(frames, sizeof(ld2450_frame_t));
+    if (!stream->frame_starts || !stream->expected) {
+        fprintf(stderr, "out of memory\n");
+        exit(2);
+    }
+    
+    for (size_t f = 0; f < frames; f++) {
+        uint8_t raw[BENCH_FRAME_SIZE];
+        ld2450_frame_t frame;
+        size_t len = BENCH_FRAME_SIZE;
+        bool intact = true;
+        
+        frame_generate(raw, &frame);
+        
+        if (corruption && rng_chance(corruption->garbage)) {
+            uint8_t noise[40];
+            size_t n = 1 + rng_below(sizeof(noise));
+            for (size_t k = 0; k < n; k++) {
+                noise[k] = (uint8_t)rng_next();
+            }
+            // Most noise carries a header prefix, the worst case for resynchronisation
+            static const uint8_t fake[4] = {0xAA, 0xFF, 0x03, 0x00};
+            size_t fake_len = rng_below(5);
+            memcpy(noise, fake, fake_len < n ? fake_len : n);
+            stream_append(stream, noise, n);
+        }
+        if (corruption && rng_chance(corruption->flip)) {
+            raw[rng_below(BENCH_FRAME_SIZE)] ^= (uint8_t)(1 + rng_below(255));
+            intact = false;
+        }
+        if (corruption && rng_chance(corruption->truncate)) {
+            len = 1 + rng_below(BENCH_FRAME_SIZE - 1);
+            intact = false;
+        }
+        
+        stream->frame_starts[stream->frame_count++] = stream->len;
+        stream_append(stream, raw, len);
+        if (intact) {
+            stream->expected[stream->expected_count++] = frame;
+        }
+    }
+}
+
+/**
+ * @brief Load a recorded raw UART capture
+ * 
+ * @param stream Stream to fill (no expected frames)
+ * @param path File of raw bytes
+ * @return true on success
+ */
+static bool stream_load(bench_stream_t *stream, const char *path)
+{
+    uint8_t buffer[4096];
+    size_t n;
+    FILE *file = fopen(path, "rb");
+    
+    memset(stream, 0, sizeof(*stream));
+    if (!file) {
+        perror(path);
+        return false;
+    }
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        stream_append(stream, buffer, n);
+    }
+    fclose(file);
+    return stream->len > 0;
+}
+
+/**
+ * @brief Strip the record headers of a ld2450_capture_read() dump, leaving the raw bytes
+ * 
+ * @param stream Stream loaded from the dump
+ * @return true if the dump consists of whole records
+ */
+static bool stream_unwrap_capture(bench_stream_t *stream)
+{
+    size_t in = 0;
+    size_t out = 0;
+    
+    while (stream->len - in >= sizeof(ld2450_capture_record_t)) {
+        ld2450_capture_record_t record;
+        memcpy(&record, stream->data + in, sizeof(record));
+        in += sizeof(record);
+        if (record.length > stream->len - in) {
+            break;
+        }
+        memmove(stream->data + out, stream->data + in, record.length);
+        in += record.length;
+        out += record.length;
+    }
+    
+    bool whole = in == stream->len;
+    stream->len = out;
+    return whole && out > 0;
+}
+
+/**
+ * @brief Count well-formed frames in a stream, the delivery target for a recording
+ */
+static size_t stream_count_frames(const bench_stream_t *stream)
+{
+    static const uint8_t header[4] = {0xAA, 0xFF, 0x03, 0x00};
+    size_t count = 0;
+    
+    for (size_t i = 0; i + BENCH_FRAME_SIZE <= stream->len; i++) {
+        if (memcmp(stream->data + i, header, sizeof(header)) == 0 &&
+            stream->data[i + 28] == 0x55 && stream->data[i + 29] == 0xCC) {
+            count++;
+            i += BENCH_FRAME_SIZE - 1;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Compute the chunk boundaries of a stream
+ * 
+ * @param stream Stream
+ * @param mode Chunking
+ * @param cuts_out Receives an array of chunk end offsets (caller frees)
+ * @return Number of chunks
+ */
+static size_t stream_chunk(const bench_stream_t *stream, chunk_mode_t mode, size_t **cuts_out)
+{
+    size_t cap = stream->len + 1;
+    size_t *cuts = malloc(cap * sizeof(size_t));
+    size_t count = 0;
+    size_t at = 0;
+    
+    if (!cuts) {
+        fprintf(stderr, "out of memory\n");
+        exit(2);
+    }
+    
+    if (mode == CHUNK_STRADDLE && stream->frame_count) {
+        for (size_t f = 0; f < stream->frame_count; f++) {
+            size_t cut = stream->frame_starts[f] + 1 + rng_below(3);
+            if (cut > at && cut < stream->len) {
+                cuts[count++] = at = cut;
+            }
+        }
+    } else {
+        while (at < stream->len && mode != CHUNK_WHOLE && mode != CHUNK_STRADDLE) {
+            size_t n = mode == CHUNK_UART ? 120 : (mode == CHUNK_BYTE ? 1 : 1 + rng_below(256));
+            at = at + n < stream->len ? at + n : stream->len;
+            cuts[count++] = at;
+        }
+    }
+    if (count == 0 || cuts[count - 1] != stream->len) {
+        cuts[count++] = stream->len;
+    }
+    
+    *cuts_out = cuts;
+    return count;
+}
+
+static void count_frame(const ld2450_frame_t *frame, void *user_ctx)
+{
+    (void)frame;
+    (*(size_t *)user_ctx)++;
+}
+
+static bool frame_matches(const ld2450_frame_t *a, const ld2450_frame_t *b)
+{
+    if (a->count != b->count) {
+        return false;
+    }
+    for (int t = 0; t < 3; t++) {
+        const ld2450_target_t *x = &a->targets[t];
+        const ld2450_target_t *y = &b->targets[t];
+        if (x->valid != y->valid || x->x != y->x || x->y != y->y ||
+            x->speed != y->speed || x->resolution != y->resolution) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void match_frame(const ld2450_frame_t *frame, void *user_ctx)
+{
+    bench_match_t *match = user_ctx;
+    const bench_stream_t *stream = match->stream;
+    
+    match->delivered++;
+    if (stream->expected_count == 0) {
+        return;
+    }
+    for (size_t j = match->cursor; j < stream->expected_count && j < match->cursor + BENCH_MATCH_WINDOW; j++) {
+        if (frame_matches(frame, &stream->expected[j])) {
+            match->matched++;
+            match->cursor = j + 1;
+            return;
+        }
+    }
+    match->spurious++;
+}
+
+static void feed(const bench_stream_t *stream, const size_t *cuts, size_t chunks)
+{
+    size_t at = 0;
+    
+    for (size_t c = 0; c < chunks; c++) {
+        ld2450_process_data(stream->data + at, cuts[c] - at);
+        at = cuts[c];
+    }
+}
+
+/** @brief Outcome of one scenario, for --check */
+typedef struct {
+    bool clean;
+    double loss;
+    size_t spurious;
+} bench_result_t;
+
+/**
+ * @brief Run one stream with one chunking: timed passes, then a verification pass
+ */
+static bench_result_t run_scenario(const char *name, const bench_stream_t *stream, chunk_mode_t mode,
+                                   int passes, bool clean)
+{
+    size_t *cuts;
+    size_t chunks = stream_chunk(stream, mode, &cuts);
+    size_t delivered = 0;
+    ld2450_sync_stats_t before;
+    ld2450_sync_stats_t after;
+    
+    ld2450_get_sync_stats(NULL, &before);
+    
+    ld2450_register_target_callback(count_frame, &delivered);
+    int64_t start_us = esp_timer_get_time();
+    for (int p = 0; p < passes; p++) {
+        feed(stream, cuts, chunks);
+    }
+    int64_t elapsed_us = esp_timer_get_time() - start_us;
+    
+    bench_match_t match = { .stream = stream };
+    ld2450_register_target_callback(match_frame, &match);
+    feed(stream, cuts, chunks);
+    ld2450_register_target_callback(NULL, NULL);
+    ld2450_get_sync_stats(NULL, &after);
+    
+    size_t target = stream->expected_count ? stream->expected_count : stream_count_frames(stream);
+    size_t got = stream->expected_count ? match.matched : match.delivered;
+    double loss = target ? 1.0 - (double)got / (double)target : 0.0;
+    double seconds = elapsed_us > 0 ? elapsed_us / 1e6 : 1e-6;
+    double bytes = (double)stream->len * passes;
+    
+    printf("%-10s %-9s %9.0f %8.2f %8zu %8zu %7.3f%% %6zu %7" PRIu32 "\n",
+           name, s_chunk_names[mode], delivered / seconds, seconds * 1e9 / bytes,
+           target, got, loss * 100.0, match.spurious,
+           (after.footer_errors - before.footer_errors) / (uint32_t)(passes + 1));
+    
+    free(cuts);
+    return (bench_result_t) { .clean = clean, .loss = loss, .spurious = match.spurious };
+}
+
+/**
+ * @brief Cost of ld2450_process_frame_with_mode() per derived-field mode
+ */
+static void run_parse_bench(int iterations)
+{
+    static const struct {
+        ld2450_derived_mode_t mode;
+        const char *name;
+    } modes[] = {
+        { LD2450_DERIVED_FLOAT, "float" },
+        { LD2450_DERIVED_NONE,  "none" },
+        { LD2450_DERIVED_LAZY,  "lazy" },
+        { LD2450_DERIVED_FIXED, "fixed" },
+    };
+    uint8_t raw[64][BENCH_FRAME_SIZE];
+    ld2450_frame_t frame;
+    volatile int32_t sink = 0;
+    
+    for (int i = 0; i < 64; i++) {
+        do {
+            frame_generate(raw[i], &frame);
+        } while (frame.count == 0);
+    }
+    
+    printf("\nld2450_process_frame_with_mode\n");
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        int64_t start_us = esp_timer_get_time();
+        for (int i = 0; i < iterations; i++) {
+            ld2450_process_frame_with_mode(raw[i & 63], BENCH_FRAME_SIZE, modes[m].mode, &frame);
+            sink += frame.targets[0].x;
+        }
+        int64_t elapsed_us = esp_timer_get_time() - start_us;
+        printf("  %-5s %7.1f ns/frame\n", modes[m].name, elapsed_us * 1000.0 / iterations);
+    }
+    (void)sink;
+}
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr,
+            "usage: %s [--frames N] [--passes N] [--seed N] [--replay FILE]... [--capture FILE]... [--check] [--verbose]\n",
+            argv0);
+}
+
+int main(int argc, char **argv)
+{
+    size_t frames = 20000;
+    int passes = 20;
+    bool check = false;
+    const char *replays[16];
+    bool replay_is_capture[16];
+    int replay_count = 0;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--passes") == 0 && i + 1 < argc) {
+            passes = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            s_rng = (uint32_t)strtoul(argv[++i], NULL, 0) | 1;
+        } else if ((strcmp(argv[i], "--replay") == 0 || strcmp(argv[i], "--capture") == 0) &&
+                   i + 1 < argc && replay_count < 16) {
+            replay_is_capture[replay_count] = strcmp(argv[i], "--capture") == 0;
+            replays[replay_count++] = argv[++i];
+        } else if (strcmp(argv[i], "--check") == 0) {
+            check = true;
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            esp_log_host_level = ESP_LOG_VERBOSE;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (check) {
+        frames = 4000;
+        passes = 1;
+    }
+    if (frames == 0 || passes < 1) {
+        usage(argv[0]);
+        return 2;
+    }
+    
+    ld2450_config_t config = LD2450_DEFAULT_CONFIG();
+    config.auto_processing = false;
+    if (ld2450_init(&config) != ESP_OK) {
+        fprintf(stderr, "ld2450_init failed\n");
+        return 2;
+    }
+    
+    static const bench_corruption_t corrupt = { .flip = 0.02, .truncate = 0.01, .garbage = 0.02 };
+    bench_result_t results[32];
+    int result_count = 0;
+    bench_stream_t stream;
+    
+    printf("%-10s %-9s %9s %8s %8s %8s %8s %6s %7s\n",
+           "stream", "chunking", "frames/s", "ns/byte", "expected", "matched", "loss", "extra", "footer");
+    
+    stream_synthesize(&stream, frames, NULL);
+    for (chunk_mode_t mode = CHUNK_WHOLE; mode <= CHUNK_STRADDLE; mode++) {
+        results[result_count++] = run_scenario("clean", &stream, mode, passes, true);
+    }
+    stream_free(&stream);
+    
+    stream_synthesize(&stream, frames, &corrupt);
+    for (chunk_mode_t mode = CHUNK_WHOLE; mode <= CHUNK_STRADDLE; mode++) {
+        results[result_count++] = run_scenario("corrupt", &stream, mode, passes, false);
+    }
+    stream_free(&stream);
+    
+    for (int r = 0; r < replay_count; r++) {
+        if (!stream_load(&stream, replays[r]) ||
+            (replay_is_capture[r] && !stream_unwrap_capture(&stream))) {
+            fprintf(stderr, "%s: not a usable capture\n", replays[r]);
+            stream_free(&stream);
+            ld2450_deinit();
+            return 2;
+        }
+        run_scenario("recorded", &stream, CHUNK_UART, passes, false);
+        run_scenario("recorded", &stream, CHUNK_RANDOM, passes, false);
+        stream_free(&stream);
+    }
+    
+    if (!check) {
+        run_parse_bench(1000000);
+    }
+    
+    ld2450_deinit();
+    
+    if (check) {
+        for (int r = 0; r < result_count; r++) {
+            if (results[r].clean ? (results[r].loss > 0 || results[r].spurious > 0) :
+                results[r].loss > BENCH_CHECK_MAX_CORRUPT_LOSS) {
+                fprintf(stderr, "check failed: scenario %d lost %.3f%% of intact frames\n",
+                        r, results[r].loss * 100.0);
+                return 1;
+            }
+        }
+        printf("check passed\n");
+    }
+    
+    return 0;
+}
@@ -0,0 +1,47 @@
+/**
+ * @file esp_log.h
+ * @brief Host stand-in for ESP-IDF logging
+ * 
+ * Messages above LOG_LOCAL_LEVEL are compiled out, as on the target; the rest
+ * are filtered at run time by esp_log_host_level (warnings by default, so that
+ * benchmarks are not dominated by printf).
+ */
+
+#pragma once
+
+#include <stdio.h>
+
+typedef enum {
+    ESP_LOG_NONE,
+    ESP_LOG_ERROR,
+    ESP_LOG_WARN,
+    ESP_LOG_INFO,
+    ESP_LOG_DEBUG,
+    ESP_LOG_VERBOSE,
+} esp_log_level_t;
+
+#ifndef LOG_LOCAL_LEVEL
+#define LOG_LOCAL_LEVEL ESP_LOG_INFO
+#endif
+
+/** @brief Most verbose level printed at run time */
+extern esp_log_level_t esp_log_host_level;
+
+#define ESP_LOG_HOST(level, letter, tag, format, ...) do { \
+        if ((level) <= LOG_LOCAL_LEVEL && (level) <= esp_log_host_level) { \
+            printf(letter " (%s) " format "\n", tag, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+#define ESP_LOGE(tag, format, ...) ESP_LOG_HOST(ESP_LOG_ERROR, "E", tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) ESP_LOG_HOST(ESP_LOG_WARN, "W", tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) ESP_LOG_HOST(ESP_LOG_INFO, "I", tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) ESP_LOG_HOST(ESP_LOG_DEBUG, "D", tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...) ESP_LOG_HOST(ESP_LOG_VERBOSE, "V", tag, format, ##__VA_ARGS__)
+
+#define ESP_LOG_LEVEL_LOCAL(level, tag, format, ...) \
+    ESP_LOG_HOST(level, (level) == ESP_LOG_ERROR ? "E" : (level) == ESP_LOG_WARN ? "W" : "I", tag, format, ##__VA_ARGS__)
+
+#define ESP_LOG_BUFFER_HEX_LEVEL(tag, buffer, len, level) do { \
+        (void)(tag); (void)(buffer); (void)(len); (void)(level); \
+    } while (0)
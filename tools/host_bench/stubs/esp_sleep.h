@@ -0,0 +1,18 @@
+/**
+ * @file esp_sleep.h
+ * @brief Host stand-in for sleep wakeup sources (no-ops)
+ */
+
+#pragma once
+
+#include "esp_err.h"
+
+typedef enum {
+    ESP_SLEEP_WAKEUP_UNDEFINED,
+    ESP_SLEEP_WAKEUP_GPIO,
+    ESP_SLEEP_WAKEUP_UART,
+} esp_sleep_source_t;
+
+esp_err_t esp_sleep_enable_uart_wakeup(int uart_num);
+esp_err_t esp_sleep_enable_gpio_wakeup(void);
+esp_err_t esp_sleep_disable_wakeup_source(esp_sleep_source_t source);
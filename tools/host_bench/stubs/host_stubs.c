@@ -0,0 +1,563 @@
+/**
+ * @file host_stubs.c
+ * @brief Host implementations of the ESP-IDF and FreeRTOS calls made by the driver
+ * 
+ * Just enough for a single-threaded process: queues and semaphores really hold
+ * items (so the command queue and subscriber queues behave), nothing blocks, no
+ * task can be created and every peripheral call succeeds without doing anything.
+ * 
+ * @author NieRVoid
+ * @date 2025-03-12
+ * @license MIT
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_event.h"
+#include "esp_pm.h"
+#include "esp_sleep.h"
+#include "nvs.h"
+#include "driver/gpio.h"
+#include "driver/uart.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+
+esp_log_level_t esp_log_host_level = ESP_LOG_WARN;
+
+/** @brief Ring of fixed-size items; item_size 0 makes a counting semaphore */
+struct host_queue {
+    uint8_t *storage;
+    UBaseType_t length;
+    UBaseType_t item_size;
+    UBaseType_t head;
+    UBaseType_t count;
+    int heap;
+};
+
+_Static_assert(sizeof(struct host_queue) <= sizeof(StaticQueue_t), "StaticQueue_t too small");
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+        case ESP_OK: return "ESP_OK";
+        case ESP_FAIL: return "ESP_FAIL";
+        case ESP_ERR_NO_MEM: return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG: return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_INVALID_SIZE: return "ESP_ERR_INVALID_SIZE";
+        case ESP_ERR_NOT_FOUND: return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+        case ESP_ERR_TIMEOUT: return "ESP_ERR_TIMEOUT";
+        case ESP_ERR_INVALID_RESPONSE: return "ESP_ERR_INVALID_RESPONSE";
+        case ESP_ERR_NOT_FINISHED: return "ESP_ERR_NOT_FINISHED";
+        default: return "ESP_ERR_UNKNOWN";
+    }
+}
+
+int64_t esp_timer_get_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* Queues */
+
+static void queue_setup(struct host_queue *queue, UBaseType_t length, UBaseType_t item_size,
+                        uint8_t *storage, int heap)
+{
+    memset(queue, 0, sizeof(*queue));
+    queue->storage = storage;
+    queue->length = length;
+    queue->item_size = item_size;
+    queue->heap = heap;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    struct host_queue *queue = malloc(sizeof(*queue));
+    uint8_t *storage = item_size ? malloc((size_t)length * item_size) : NULL;
+    
+    if (!queue || (item_size && !storage)) {
+        free(queue);
+        free(storage);
+        return NULL;
+    }
+    
+    queue_setup(queue, length, item_size, storage, 1);
+    return queue;
+}
+
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t item_size, uint8_t *storage,
+                                 StaticQueue_t *buffer)
+{
+    struct host_queue *queue = (struct host_queue *)buffer;
+    
+    queue_setup(queue, length, item_size, storage, 0);
+    return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    if (queue && queue->heap) {
+        free(queue->storage);
+        free(queue);
+    }
+}
+
+static BaseType_t queue_put(QueueHandle_t queue, const void *item, int front)
+{
+    if (!queue || queue->count >= queue->length) {
+        return pdFALSE;
+    }
+    
+    UBaseType_t index;
+    if (front) {
+        queue->head = (queue->head + queue->length - 1) % queue->length;
+        index = queue->head;
+    } else {
+        index = (queue->head + queue->count) % queue->length;
+    }
+    if (queue->item_size && item) {
+        memcpy(queue->storage + (size_t)index * queue->item_size, item, queue->item_size);
+    }
+    queue->count++;
+    return pdTRUE;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait)
+{
+    (void)ticks_to_wait;
+    return queue_put(queue, item, 0);
+}
+
+BaseType_t xQueueSendToFront(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait)
+{
+    (void)ticks_to_wait;
+    return queue_put(queue, item, 1);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks_to_wait)
+{
+    (void)ticks_to_wait;
+    
+    if (!queue || queue->count == 0) {
+        return pdFALSE;
+    }
+    
+    if (queue->item_size && item) {
+        memcpy(item, queue->storage + (size_t)queue->head * queue->item_size, queue->item_size);
+    }
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    return pdTRUE;
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue)
+{
+    if (queue) {
+        queue->head = 0;
+        queue->count = 0;
+    }
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    return queue ? queue->count : 0;
+}
+
+QueueSetHandle_t xQueueCreateSet(UBaseType_t length)
+{
+    (void)length;
+    return NULL;
+}
+
+BaseType_t xQueueAddToSet(QueueSetMemberHandle_t member, QueueSetHandle_t set)
+{
+    (void)member;
+    (void)set;
+    return pdFAIL;
+}
+
+BaseType_t xQueueRemoveFromSet(QueueSetMemberHandle_t member, QueueSetHandle_t set)
+{
+    (void)member;
+    (void)set;
+    return pdFAIL;
+}
+
+QueueSetMemberHandle_t xQueueSelectFromSet(QueueSetHandle_t set, TickType_t ticks_to_wait)
+{
+    (void)set;
+    (void)ticks_to_wait;
+    return NULL;
+}
+
+/* Semaphores */
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return xQueueCreate(1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinaryStatic(StaticSemaphore_t *buffer)
+{
+    return xQueueCreateStatic(1, 0, NULL, buffer);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    SemaphoreHandle_t mutex = xQueueCreate(1, 0);
+    xSemaphoreGive(mutex);
+    return mutex;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t *buffer)
+{
+    SemaphoreHandle_t mutex = xQueueCreateStatic(1, 0, NULL, buffer);
+    xSemaphoreGive(mutex);
+    return mutex;
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max_count, UBaseType_t initial_count)
+{
+    SemaphoreHandle_t semaphore = xQueueCreate(max_count, 0);
+    if (semaphore) {
+        semaphore->count = initial_count;
+    }
+    return semaphore;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks_to_wait)
+{
+    return xQueueReceive(semaphore, NULL, ticks_to_wait);
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    return queue_put(semaphore, NULL, 0);
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore)
+{
+    vQueueDelete(semaphore);
+}
+
+/* Tasks */
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char *name, uint32_t stack_depth,
+                                   void *arg, UBaseType_t priority, TaskHandle_t *created_task,
+                                   BaseType_t core_id)
+{
+    (void)code;
+    (void)name;
+    (void)stack_depth;
+    (void)arg;
+    (void)priority;
+    (void)core_id;
+    *created_task = NULL;
+    return pdFAIL;
+}
+
+TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t code, const char *name, uint32_t stack_depth,
+                                           void *arg, UBaseType_t priority, StackType_t *stack,
+                                           StaticTask_t *task_buffer, BaseType_t core_id)
+{
+    (void)code;
+    (void)name;
+    (void)stack_depth;
+    (void)arg;
+    (void)priority;
+    (void)stack;
+    (void)task_buffer;
+    (void)core_id;
+    return NULL;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    (void)task;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    (void)ticks;
+}
+
+eTaskState eTaskGetState(TaskHandle_t task)
+{
+    (void)task;
+    return eDeleted;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    static int main_task;
+    return (TaskHandle_t)&main_task;
+}
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action)
+{
+    (void)task;
+    (void)value;
+    (void)action;
+    return pdPASS;
+}
+
+/* Event loops */
+
+esp_err_t esp_event_loop_create(const esp_event_loop_args_t *event_loop_args,
+                                esp_event_loop_handle_t *event_loop)
+{
+    (void)event_loop_args;
+    (void)event_loop;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t esp_event_loop_delete(esp_event_loop_handle_t event_loop)
+{
+    (void)event_loop;
+    return ESP_OK;
+}
+
+esp_err_t esp_event_post_to(esp_event_loop_handle_t event_loop, esp_event_base_t event_base,
+                            int32_t event_id, const void *event_data, size_t event_data_size,
+                            TickType_t ticks_to_wait)
+{
+    (void)event_loop;
+    (void)event_base;
+    (void)event_id;
+    (void)event_data;
+    (void)event_data_size;
+    (void)ticks_to_wait;
+    return ESP_OK;
+}
+
+esp_err_t esp_event_handler_register_with(esp_event_loop_handle_t event_loop,
+                                          esp_event_base_t event_base, int32_t event_id,
+                                          esp_event_handler_t event_handler, void *event_handler_arg)
+{
+    (void)event_loop;
+    (void)event_base;
+    (void)event_id;
+    (void)event_handler;
+    (void)event_handler_arg;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+/* NVS */
+
+esp_err_t nvs_open(const char *name, nvs_open_mode_t open_mode, nvs_handle_t *out_handle)
+{
+    (void)name;
+    (void)open_mode;
+    *out_handle = 1;
+    return ESP_OK;
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out_value, size_t *length)
+{
+    (void)handle;
+    (void)key;
+    (void)out_value;
+    (void)length;
+    return ESP_ERR_NVS_NOT_FOUND;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t length)
+{
+    (void)handle;
+    (void)key;
+    (void)value;
+    (void)length;
+    return ESP_OK;
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    (void)handle;
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t handle)
+{
+    (void)handle;
+}
+
+/* Peripherals */
+
+esp_err_t gpio_set_pull_mode(gpio_num_t gpio_num, gpio_pull_mode_t pull)
+{
+    (void)gpio_num;
+    (void)pull;
+    return ESP_OK;
+}
+
+esp_err_t gpio_wakeup_enable(gpio_num_t gpio_num, gpio_int_type_t intr_type)
+{
+    (void)gpio_num;
+    (void)intr_type;
+    return ESP_OK;
+}
+
+esp_err_t gpio_wakeup_disable(gpio_num_t gpio_num)
+{
+    (void)gpio_num;
+    return ESP_OK;
+}
+
+esp_err_t uart_set_wakeup_threshold(uart_port_t uart_num, int wakeup_threshold)
+{
+    (void)uart_num;
+    (void)wakeup_threshold;
+    return ESP_OK;
+}
+
+/* Power management: no PM on the host, as with CONFIG_PM_ENABLE unset */
+
+esp_err_t esp_pm_lock_create(esp_pm_lock_type_t lock_type, int arg, const char *name,
+                             esp_pm_lock_handle_t *out_handle)
+{
+    (void)lock_type;
+    (void)arg;
+    (void)name;
+    (void)out_handle;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t esp_pm_lock_delete(esp_pm_lock_handle_t handle)
+{
+    (void)handle;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t esp_pm_lock_acquire(esp_pm_lock_handle_t handle)
+{
+    (void)handle;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t esp_pm_lock_release(esp_pm_lock_handle_t handle)
+{
+    (void)handle;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t esp_sleep_enable_uart_wakeup(int uart_num)
+{
+    (void)uart_num;
+    return ESP_OK;
+}
+
+esp_err_t esp_sleep_enable_gpio_wakeup(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_sleep_disable_wakeup_source(esp_sleep_source_t source)
+{
+    (void)source;
+    return ESP_OK;
+}
+
+static QueueHandle_t s_uart_queues[UART_NUM_MAX];
+
+esp_err_t uart_driver_install(uart_port_t uart_num, int rx_buffer_size, int tx_buffer_size,
+                              int queue_size, QueueHandle_t *uart_queue, int intr_alloc_flags)
+{
+    (void)rx_buffer_size;
+    (void)tx_buffer_size;
+    (void)intr_alloc_flags;
+    
+    if (uart_num < 0 || uart_num >= UART_NUM_MAX || s_uart_queues[uart_num]) {
+        return ESP_FAIL;
+    }
+    
+    s_uart_queues[uart_num] = xQueueCreate((UBaseType_t)queue_size, sizeof(uart_event_t));
+    if (!s_uart_queues[uart_num]) {
+        return ESP_ERR_NO_MEM;
+    }
+    
+    if (uart_queue) {
+        *uart_queue = s_uart_queues[uart_num];
+    }
+    return ESP_OK;
+}
+
+esp_err_t uart_driver_delete(uart_port_t uart_num)
+{
+    if (uart_num < 0 || uart_num >= UART_NUM_MAX || !s_uart_queues[uart_num]) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    vQueueDelete(s_uart_queues[uart_num]);
+    s_uart_queues[uart_num] = NULL;
+    return ESP_OK;
+}
+
+esp_err_t uart_param_config(uart_port_t uart_num, const uart_config_t *uart_config)
+{
+    (void)uart_num;
+    (void)uart_config;
+    return ESP_OK;
+}
+
+esp_err_t uart_set_pin(uart_port_t uart_num, int tx_io_num, int rx_io_num, int rts_io_num, int cts_io_num)
+{
+    (void)uart_num;
+    (void)tx_io_num;
+    (void)rx_io_num;
+    (void)rts_io_num;
+    (void)cts_io_num;
+    return ESP_OK;
+}
+
+esp_err_t uart_set_rx_timeout(uart_port_t uart_num, uint8_t tout_thresh)
+{
+    (void)uart_num;
+    (void)tout_thresh;
+    return ESP_OK;
+}
+
+esp_err_t uart_set_rx_full_threshold(uart_port_t uart_num, int threshold)
+{
+    (void)uart_num;
+    (void)threshold;
+    return ESP_OK;
+}
+
+esp_err_t uart_set_baudrate(uart_port_t uart_num, uint32_t baudrate)
+{
+    (void)uart_num;
+    (void)baudrate;
+    return ESP_OK;
+}
+
+esp_err_t uart_flush_input(uart_port_t uart_num)
+{
+    (void)uart_num;
+    return ESP_OK;
+}
+
+int uart_read_bytes(uart_port_t uart_num, void *buf, uint32_t length, TickType_t ticks_to_wait)
+{
+    (void)uart_num;
+    (void)buf;
+    (void)length;
+    (void)ticks_to_wait;
+    return 0;
+}
+
+int uart_write_bytes(uart_port_t uart_num, const void *src, size_t size)
+{
+    (void)uart_num;
+    (void)src;
+    return (int)size;
+}